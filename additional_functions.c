@@ -2,6 +2,7 @@
 #include "additional_functions.h"
 #include "poly.h"
 #include <ctype.h>
+#include "poly_stats.h"
 
 void lengthenIfNecessary(char **text, size_t *length, size_t i) {
     if (i == *length) {
@@ -11,7 +12,7 @@ void lengthenIfNecessary(char **text, size_t *length, size_t i) {
     }
 }
 
-void CheckReallocOutcome(const void *a) {
+void CheckReallocOutcome(void *a) {
     if (a == NULL) {
         exit(1);
     }
@@ -25,7 +25,7 @@ void lengthenIfNecessary(char **text, size_t *length, size_t i);
 void LengthenArrayIfNecessary(Mono **arr, size_t *length, size_t i);
 
 /** Sprawdza wynik realokacji pamięci. */
-void CheckReallocOutcome(const void *a);
+void CheckReallocOutcome(void *a);
 
 /** Powiększa liczbę.
  * @param[in] length : początkowa liczba
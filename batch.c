@@ -0,0 +1,232 @@
+/** @file
+  Implementacja równoległego wczytywania wielomianów.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "batch.h"
+#include "additional_functions.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define BATCH_LINES (1 << 14)
+#define BATCH_BYTES (1 << 22)
+#define CHUNK_LINES 256
+#define INITIAL_LENGTH 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+void initParseBatch(ParseBatch *batch) {
+    batch->textCapacity = BATCH_BYTES;
+    batch->text = malloc(batch->textCapacity);
+    CheckReallocOutcome(batch->text);
+    batch->textSize = 0;
+    batch->capacity = INITIAL_LENGTH;
+    batch->lines = malloc(batch->capacity * sizeof *batch->lines);
+    CheckReallocOutcome(batch->lines);
+    batch->count = 0;
+    batch->firstLine = 1;
+    batch->claimed = 0;
+    batch->finished = 0;
+    batch->next = NULL;
+}
+
+void freeParseBatch(ParseBatch *batch) {
+    free(batch->text);
+    free(batch->lines);
+}
+
+/**
+ * Kopiuje linię wejścia na koniec paczki.
+ * @param[in,out] batch : paczka
+ * @param[in] line : kursor obejmujący całą linię
+ */
+static void appendLine(ParseBatch *batch, const Cursor *line) {
+    size_t length = (size_t) (line->end - line->pos);
+    while (batch->textCapacity - batch->textSize < length) {
+        batch->textCapacity = more(batch->textCapacity);
+        batch->text = realloc(batch->text, batch->textCapacity);
+        CheckReallocOutcome(batch->text);
+    }
+    if (batch->count == batch->capacity) {
+        batch->capacity = more(batch->capacity);
+        batch->lines = realloc(batch->lines, batch->capacity * sizeof *batch->lines);
+        CheckReallocOutcome(batch->lines);
+    }
+    memcpy(batch->text + batch->textSize, line->pos, length);
+    batch->lines[batch->count].begin = batch->textSize;
+    batch->lines[batch->count].end = batch->textSize + length;
+    batch->textSize += length;
+    ++batch->count;
+}
+
+bool fillParseBatch(ParseBatch *batch, LineReader *reader, int firstLine, bool wait) {
+    batch->count = 0;
+    batch->textSize = 0;
+    batch->firstLine = firstLine;
+    batch->claimed = 0;
+    batch->finished = 0;
+    batch->next = NULL;
+    Cursor line;
+    while ((batch->count < BATCH_LINES) && (batch->textSize < BATCH_BYTES)) {
+        bool got = ((batch->count == 0) && wait) ? nextLine(reader, &line)
+                                                  : nextBufferedLine(reader, &line);
+        if (!got) {
+            break;
+        }
+        appendLine(batch, &line);
+    }
+    return batch->count > 0;
+}
+
+Cursor batchLineCursor(const ParseBatch *batch, size_t i) {
+    return (Cursor) {.pos = batch->text + batch->lines[i].begin,
+                     .end = batch->text + batch->lines[i].end};
+}
+
+/**
+ * Przydziela wywołującemu wątkowi kolejny fragment linii paczki.
+ * Paczka, której wszystkie linie są już przydzielone, opuszcza kolejkę.
+ * Wymaga trzymania zamka puli.
+ * @param[in,out] pool : pula
+ * @param[in,out] batch : paczka
+ * @param[out] first : numer pierwszej linii fragmentu
+ * @param[out] last : numer linii za fragmentem
+ * @return Czy przydzielono jakieś linie?
+ */
+static bool claimLines(ParsePool *pool, ParseBatch *batch, size_t *first, size_t *last) {
+    if (batch->claimed == batch->count) {
+        return false;
+    }
+    *first = batch->claimed;
+    *last = (batch->count - batch->claimed > CHUNK_LINES) ? batch->claimed + CHUNK_LINES
+                                                          : batch->count;
+    batch->claimed = *last;
+    if (batch->claimed == batch->count) {
+        ParseBatch **link = &pool->head;
+        ParseBatch *prev = NULL;
+        while (*link != batch) {
+            prev = *link;
+            link = &(*link)->next;
+        }
+        *link = batch->next;
+        if (pool->tail == batch) {
+            pool->tail = prev;
+        }
+        batch->next = NULL;
+    }
+    return true;
+}
+
+/**
+ * Analizuje fragment linii paczki bez trzymania zamka puli,
+ * a potem zalicza go do przeanalizowanych.
+ * @param[in,out] pool : pula, której zamek trzyma wywołujący
+ * @param[in,out] parser : parser wywołującego wątku
+ * @param[in,out] batch : paczka
+ * @param[in] first : numer pierwszej linii fragmentu
+ * @param[in] last : numer linii za fragmentem
+ */
+static void parseLines(ParsePool *pool, PolyParser *parser, ParseBatch *batch,
+                       size_t first, size_t last) {
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = first; i < last; ++i) {
+        Cursor in = batchLineCursor(batch, i);
+        parseLine(parser, &in, &batch->lines[i].parsed);
+    }
+    pthread_mutex_lock(&pool->lock);
+    batch->finished += last - first;
+    if (batch->finished == batch->count) {
+        pthread_cond_broadcast(&pool->done);
+    }
+}
+
+/**
+ * Główna funkcja wątku roboczego: analizuje fragmenty paczek z kolejki,
+ * dopóki pula nie zostanie zamknięta.
+ * @param[in,out] arg : pula
+ * @return NULL
+ */
+static void *parseWorker(void *arg) {
+    ParsePool *pool = arg;
+    PolyParser parser = newPolyParser();
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while ((pool->head == NULL) && !pool->stop) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->head == NULL) {
+            break;
+        }
+        ParseBatch *batch = pool->head;
+        size_t first, last;
+        if (claimLines(pool, batch, &first, &last)) {
+            parseLines(pool, &parser, batch, first, last);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    freePolyParser(&parser);
+    return NULL;
+}
+
+void initParsePool(ParsePool *pool, size_t threads) {
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->head = NULL;
+    pool->tail = NULL;
+    pool->stop = false;
+    pool->parser = newPolyParser();
+    pool->threads = malloc((threads > 0 ? threads : 1) * sizeof *pool->threads);
+    CheckReallocOutcome(pool->threads);
+    pool->threadsCount = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, parseWorker, pool) != 0) {
+            break;
+        }
+        ++pool->threadsCount;
+    }
+}
+
+void closeParsePool(ParsePool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->threadsCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    freePolyParser(&pool->parser);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+void submitParseBatch(ParsePool *pool, ParseBatch *batch) {
+    pthread_mutex_lock(&pool->lock);
+    batch->next = NULL;
+    if (pool->tail == NULL) {
+        pool->head = batch;
+    } else {
+        pool->tail->next = batch;
+    }
+    pool->tail = batch;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void waitParseBatch(ParsePool *pool, ParseBatch *batch) {
+    pthread_mutex_lock(&pool->lock);
+    while (batch->finished < batch->count) {
+        size_t first, last;
+        if (claimLines(pool, batch, &first, &last)) {
+            parseLines(pool, &pool->parser, batch, first, last);
+        } else {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,124 @@
+/** @file
+  Interfejs równoległego wczytywania wielomianów.
+  Wejście jest dzielone na paczki kolejnych linii. Wątki robocze wczytują
+  wielomiany z linii paczki, a wątek główny wykonuje potem polecenia
+  w kolejności linii, więc wyjście i komunikaty o błędach nie zmieniają się.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_BATCH_H
+#define POLYNOMIALS_BATCH_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "input.h"
+#include "parser.h"
+
+/**
+ * To jest struktura reprezentująca jedną linię paczki.
+ */
+typedef struct {
+    size_t begin; ///< początek linii w tekście paczki
+    size_t end; ///< koniec linii w tekście paczki
+    ParsedLine parsed; ///< wynik analizy linii
+} BatchLine;
+
+/**
+ * To jest struktura reprezentująca paczkę kolejnych linii wejścia.
+ * Tekst linii jest kopiowany do paczki, więc pozostaje ważny
+ * także wtedy, gdy czytnik wczytuje już dalszą część wejścia.
+ */
+typedef struct ParseBatch {
+    char *text; ///< skopiowany tekst linii
+    size_t textSize; ///< liczba bajtów w @p text
+    size_t textCapacity; ///< rozmiar tablicy @p text
+    BatchLine *lines; ///< linie paczki
+    size_t count; ///< liczba linii
+    size_t capacity; ///< rozmiar tablicy @p lines
+    int firstLine; ///< numer pierwszej linii paczki
+    size_t claimed; ///< liczba linii przydzielonych już wątkom
+    size_t finished; ///< liczba przeanalizowanych linii
+    struct ParseBatch *next; ///< następna paczka w kolejce
+} ParseBatch;
+
+/**
+ * To jest struktura reprezentująca pulę wątków analizujących paczki.
+ * Paczki czekają w kolejce, a wątki pobierają z niej
+ * fragmenty po kilkaset linii.
+ */
+typedef struct {
+    pthread_mutex_t lock; ///< zamek chroniący kolejkę i liczniki paczek
+    pthread_cond_t work; ///< sygnalizuje pojawienie się paczki w kolejce
+    pthread_cond_t done; ///< sygnalizuje przeanalizowanie fragmentu paczki
+    ParseBatch *head; ///< pierwsza paczka z nieprzydzielonymi liniami
+    ParseBatch *tail; ///< ostatnia paczka w kolejce
+    bool stop; ///< czy wątki mają zakończyć pracę
+    pthread_t *threads; ///< wątki robocze
+    size_t threadsCount; ///< liczba wątków roboczych
+    PolyParser parser; ///< parser wątku, który czeka na paczkę
+} ParsePool;
+
+/**
+ * Tworzy pustą paczkę.
+ * @param[out] batch : paczka
+ */
+void initParseBatch(ParseBatch *batch);
+
+/**
+ * Usuwa z pamięci paczkę. Wielomiany z paczki muszą być wcześniej
+ * przekazane dalej.
+ * @param[in,out] batch : paczka
+ */
+void freeParseBatch(ParseBatch *batch);
+
+/**
+ * Wypełnia paczkę kolejnymi liniami wejścia.
+ * Jeśli @p wait jest równe false, bierze tylko linie, które są już
+ * w buforze czytnika, w przeciwnym przypadku może czekać na pierwszą linię.
+ * @param[in,out] batch : paczka, wcześniej opróżniona
+ * @param[in,out] reader : czytnik linii
+ * @param[in] firstLine : numer pierwszej linii paczki
+ * @param[in] wait : czy można czekać na dane
+ * @return Czy paczka zawiera jakąś linię?
+ */
+bool fillParseBatch(ParseBatch *batch, LineReader *reader, int firstLine, bool wait);
+
+/**
+ * Daje kursor na początku linii paczki.
+ * @param[in] batch : paczka
+ * @param[in] i : numer linii w paczce
+ * @return kursor
+ */
+Cursor batchLineCursor(const ParseBatch *batch, size_t i);
+
+/**
+ * Uruchamia pulę wątków analizujących paczki.
+ * @param[out] pool : pula
+ * @param[in] threads : liczba wątków roboczych, może być równa zeru
+ */
+void initParsePool(ParsePool *pool, size_t threads);
+
+/**
+ * Kończy pracę wątków puli i zwalnia jej zasoby.
+ * @param[in,out] pool : pula
+ */
+void closeParsePool(ParsePool *pool);
+
+/**
+ * Dodaje paczkę do kolejki puli.
+ * @param[in,out] pool : pula
+ * @param[in,out] batch : niepusta paczka
+ */
+void submitParseBatch(ParsePool *pool, ParseBatch *batch);
+
+/**
+ * Czeka, aż wszystkie linie paczki zostaną przeanalizowane.
+ * W tym czasie sam analizuje nieprzydzielone jeszcze linie paczki.
+ * @param[in,out] pool : pula
+ * @param[in,out] batch : paczka dodana wcześniej do kolejki
+ */
+void waitParseBatch(ParsePool *pool, ParseBatch *batch);
+
+#endif //POLYNOMIALS_BATCH_H
@@ -0,0 +1,97 @@
+/** @file
+  Implementacja pomocniczych funkcji programów mierzących wydajność.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench_util.h"
+#include <stdlib.h>
+#include <time.h>
+
+double BenchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+void BenchRandomInit(BenchRandom *rng, uint64_t seed) {
+    rng->state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    if (rng->state == 0) {
+        rng->state = 1;
+    }
+}
+
+uint64_t BenchRandomBelow(BenchRandom *rng, uint64_t bound) {
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return (x * 0x2545F4914F6CDD1DULL) % bound;
+}
+
+/**
+ * Porównuje dwie próbki.
+ * @param[in] a : wskaźnik na pierwszą próbkę
+ * @param[in] b : wskaźnik na drugą próbkę
+ * @return liczba ujemna, zero lub dodatnia, gdy pierwsza próbka jest
+ * odpowiednio mniejsza, równa lub większa od drugiej
+ */
+static int CompareSamples(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Daje percentyl posortowanych próbek metodą najbliższej rangi.
+ * @param[in] samples : posortowane próbki
+ * @param[in] count : liczba próbek
+ * @param[in] percent : percentyl od 0 do 100
+ * @return wartość percentyla
+ */
+static double Percentile(const double *samples, size_t count, unsigned percent) {
+    size_t rank = (count * percent + 99) / 100;
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+BenchStats BenchSummarize(double *samples, size_t count) {
+    qsort(samples, count, sizeof *samples, CompareSamples);
+    double sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += samples[i];
+    }
+    return (BenchStats) {
+        .count = count,
+        .min = samples[0],
+        .p50 = Percentile(samples, count, 50),
+        .p90 = Percentile(samples, count, 90),
+        .p99 = Percentile(samples, count, 99),
+        .max = samples[count - 1],
+        .mean = sum / (double) count
+    };
+}
+
+void BenchPrintStats(FILE *out, const BenchStats *stats) {
+    fprintf(out, "{\"count\": %zu, \"min\": %.6g, \"p50\": %.6g, \"p90\": %.6g, "
+                 "\"p99\": %.6g, \"max\": %.6g, \"mean\": %.6g}",
+            stats->count, stats->min, stats->p50, stats->p90, stats->p99, stats->max,
+            stats->mean);
+}
+
+void BenchPrintString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const char *c = text; *c != '\0'; ++c) {
+        if ((*c == '"') || (*c == '\\')) {
+            fputc('\\', out);
+            fputc(*c, out);
+        } else if ((unsigned char) *c < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned) (unsigned char) *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
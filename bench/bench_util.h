@@ -0,0 +1,82 @@
+/** @file
+  Interfejs pomocniczych funkcji programów mierzących wydajność:
+  zegar, powtarzalny generator liczb pseudolosowych i statystyki próbek.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_BENCH_UTIL_H
+#define POLYNOMIALS_BENCH_UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * To jest struktura reprezentująca generator liczb pseudolosowych
+ * (xorshift64*). Dla tego samego ziarna daje ten sam ciąg liczb
+ * niezależnie od biblioteki standardowej, więc wyniki pomiarów
+ * z różnych wersji programu dotyczą tych samych danych.
+ */
+typedef struct {
+    uint64_t state; ///< stan generatora, nigdy równy zeru
+} BenchRandom;
+
+/**
+ * To jest struktura przechowująca podsumowanie próbek pomiaru.
+ */
+typedef struct {
+    size_t count; ///< liczba próbek
+    double min; ///< najmniejsza próbka
+    double p50; ///< mediana
+    double p90; ///< 90. percentyl
+    double p99; ///< 99. percentyl
+    double max; ///< największa próbka
+    double mean; ///< średnia
+} BenchStats;
+
+/**
+ * Zwraca bieżący czas monotoniczny w sekundach.
+ * @return czas w sekundach
+ */
+double BenchNow(void);
+
+/**
+ * Inicjuje generator liczb pseudolosowych.
+ * @param[out] rng : generator
+ * @param[in] seed : ziarno
+ */
+void BenchRandomInit(BenchRandom *rng, uint64_t seed);
+
+/**
+ * Losuje liczbę z przedziału @f$[0, bound)@f$.
+ * @param[in,out] rng : generator
+ * @param[in] bound : górna granica, większa od zera
+ * @return wylosowana liczba
+ */
+uint64_t BenchRandomBelow(BenchRandom *rng, uint64_t bound);
+
+/**
+ * Podsumowuje próbki pomiaru. Sortuje przy tym tablicę próbek.
+ * Percentyle wyznaczane są metodą najbliższej rangi.
+ * @param[in,out] samples : próbki
+ * @param[in] count : liczba próbek, większa od zera
+ * @return podsumowanie
+ */
+BenchStats BenchSummarize(double *samples, size_t count);
+
+/**
+ * Wypisuje podsumowanie próbek jako obiekt JSON.
+ * @param[in,out] out : strumień
+ * @param[in] stats : podsumowanie
+ */
+void BenchPrintStats(FILE *out, const BenchStats *stats);
+
+/**
+ * Wypisuje napis jako napis JSON, razem z cudzysłowami.
+ * @param[in,out] out : strumień
+ * @param[in] text : napis
+ */
+void BenchPrintString(FILE *out, const char *text);
+
+#endif //POLYNOMIALS_BENCH_UTIL_H
@@ -0,0 +1,528 @@
+/** @file
+  Pomiar wydajności całego kalkulatora na zadanym skrypcie.
+
+  Uruchamia program kalkulatora kilkukrotnie ze skryptem na standardowym
+  wejściu i mierzy czas, z którego wyznacza liczbę wierszy i bajtów
+  przetwarzanych na sekundę, a także czas procesora i największe zużycie
+  pamięci rezydentnej procesów kalkulatora.
+
+  Z opcją `-l` mierzy dodatkowo czas wykonania poszczególnych poleceń.
+  Wysyła wtedy kalkulatorowi skrypt po jednym wierszu, a po każdym z nich
+  wiersz `SYNC`, na który kalkulator odpowiada błędem WRONG COMMAND.
+  Kalkulator wypisuje zbuforowane wyniki przed oczekiwaniem na wejście,
+  więc nadejście tego błędu oznacza, że wiersz został wykonany. Zmierzony
+  czas obejmuje przesłanie danych przez potoki; koszt samej synchronizacji
+  podawany jest jako osobne polecenie SYNC. Tryb ten zakłada sekwencyjne
+  wykonywanie poleceń, więc nie należy go łączyć z opcjami `-j` i `-p`
+  kalkulatora.
+
+  Wyniki wypisywane są na standardowe wyjście w formacie JSON. Skrypty można
+  tworzyć programem script_gen.
+
+  Kompilacja z katalogu głównego repozytorium:
+  @code
+  gcc -std=c11 -O2 -I. bench/calc_bench.c bench/bench_util.c -o calc_bench
+  @endcode
+
+  Użycie: `calc_bench [-r liczba_uruchomień] [-l] skrypt program [argumenty]`.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define DEFAULT_RUNS 5
+#define SYNC_ROUNDS 1000
+#define MAX_COMMANDS 32
+#define MAX_NAME 16
+#define DRAIN_BLOCK 65536
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura przechowująca wczytany skrypt.
+ */
+typedef struct {
+    char *data; ///< zawartość skryptu
+    size_t bytes; ///< rozmiar skryptu w bajtach
+    size_t lines; ///< liczba wierszy
+} Script;
+
+/**
+ * To jest struktura przechowująca czasy wykonania jednego rodzaju polecenia.
+ */
+typedef struct {
+    char name[MAX_NAME]; ///< nazwa polecenia
+    double *samples; ///< czasy wykonania w mikrosekundach
+    size_t count; ///< liczba czasów
+    size_t capacity; ///< rozmiar tablicy czasów
+} Latencies;
+
+/**
+ * To jest struktura przechowująca uruchomiony proces kalkulatora
+ * wraz z końcami potoków do komunikacji z nim.
+ */
+typedef struct {
+    pid_t pid; ///< identyfikator procesu
+    int in; ///< koniec potoku do zapisu na standardowe wejście
+    int out; ///< koniec potoku do odczytu standardowego wyjścia
+    int err; ///< koniec potoku do odczytu standardowego wyjścia błędów
+    char *errors; ///< nieprzetworzona część wyjścia błędów
+    size_t errorsSize; ///< długość nieprzetworzonej części wyjścia błędów
+    size_t errorsCapacity; ///< rozmiar bufora wyjścia błędów
+    size_t line; ///< numer ostatniego wysłanego wiersza
+} Session;
+
+/**
+ * Kończy program z komunikatem o błędzie.
+ * @param[in] what : opis nieudanej operacji
+ */
+static void Fail(const char *what) {
+    perror(what);
+    exit(1);
+}
+
+/**
+ * Wczytuje skrypt do pamięci.
+ * @param[in] path : ścieżka do pliku
+ * @return wczytany skrypt
+ */
+static Script ReadScript(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        Fail(path);
+    }
+    Script script = {.data = NULL, .bytes = 0, .lines = 0};
+    size_t capacity = 0;
+    size_t n;
+    do {
+        if (script.bytes == capacity) {
+            capacity = capacity > 0 ? 2 * capacity : DRAIN_BLOCK;
+            script.data = realloc(script.data, capacity + 1);
+            if (script.data == NULL) {
+                Fail("realloc");
+            }
+        }
+        n = fread(script.data + script.bytes, 1, capacity - script.bytes, file);
+        script.bytes += n;
+    } while (n > 0);
+    fclose(file);
+    script.data[script.bytes] = '\0';
+    for (size_t i = 0; i < script.bytes; ++i) {
+        if (script.data[i] == '\n') {
+            ++script.lines;
+        }
+    }
+    if ((script.bytes > 0) && (script.data[script.bytes - 1] != '\n')) {
+        ++script.lines;
+    }
+    return script;
+}
+
+/**
+ * Uruchamia kalkulator raz ze skryptem na standardowym wejściu,
+ * odrzucając jego wyjście.
+ * @param[in] path : ścieżka do skryptu
+ * @param[in] argv : program i jego argumenty
+ * @param[out] user : czas procesora w trybie użytkownika w sekundach
+ * @param[out] sys : czas procesora w trybie jądra w sekundach
+ * @return czas działania w sekundach
+ */
+static double RunOnce(const char *path, char *const argv[], double *user, double *sys) {
+    struct rusage before;
+    getrusage(RUSAGE_CHILDREN, &before);
+    double start = BenchNow();
+    pid_t pid = fork();
+    if (pid < 0) {
+        Fail("fork");
+    }
+    if (pid == 0) {
+        int in = open(path, O_RDONLY);
+        int null = open("/dev/null", O_WRONLY);
+        if ((in < 0) || (null < 0)) {
+            _exit(127);
+        }
+        dup2(in, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            Fail("waitpid");
+        }
+    }
+    double elapsed = BenchNow() - start;
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) == 127)) {
+        fprintf(stderr, "%s did not run correctly\n", argv[0]);
+        exit(1);
+    }
+    struct rusage after;
+    getrusage(RUSAGE_CHILDREN, &after);
+    *user = (double) (after.ru_utime.tv_sec - before.ru_utime.tv_sec)
+            + (double) (after.ru_utime.tv_usec - before.ru_utime.tv_usec) * 1e-6;
+    *sys = (double) (after.ru_stime.tv_sec - before.ru_stime.tv_sec)
+           + (double) (after.ru_stime.tv_usec - before.ru_stime.tv_usec) * 1e-6;
+    return elapsed;
+}
+
+/**
+ * Uruchamia kalkulator z potokami na standardowym wejściu i wyjściach.
+ * @param[in] argv : program i jego argumenty
+ * @return sesja z uruchomionym kalkulatorem
+ */
+static Session StartSession(char *const argv[]) {
+    int in[2], out[2], err[2];
+    if ((pipe(in) != 0) || (pipe(out) != 0) || (pipe(err) != 0)) {
+        Fail("pipe");
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        Fail("fork");
+    }
+    if (pid == 0) {
+        dup2(in[0], STDIN_FILENO);
+        dup2(out[1], STDOUT_FILENO);
+        dup2(err[1], STDERR_FILENO);
+        close(in[0]);
+        close(in[1]);
+        close(out[0]);
+        close(out[1]);
+        close(err[0]);
+        close(err[1]);
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    close(in[0]);
+    close(out[1]);
+    close(err[1]);
+    return (Session) {
+        .pid = pid, .in = in[1], .out = out[0], .err = err[0],
+        .errors = NULL, .errorsSize = 0, .errorsCapacity = 0, .line = 0
+    };
+}
+
+/**
+ * Zapisuje całe dane do potoku.
+ * @param[in] fd : deskryptor
+ * @param[in] data : dane
+ * @param[in] size : rozmiar danych
+ */
+static void WriteAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Fail("write");
+        }
+        data += n;
+        size -= (size_t) n;
+    }
+}
+
+/**
+ * Szuka w wyjściu błędów kalkulatora komunikatu o błędnym poleceniu
+ * w zadanym wierszu i odrzuca przetworzone pełne wiersze.
+ * @param[in,out] session : sesja
+ * @param[in] line : numer wiersza
+ * @return czy komunikat został znaleziony
+ */
+static bool FindSync(Session *session, size_t line) {
+    char expected[64];
+    int length = snprintf(expected, sizeof expected, "ERROR %zu WRONG COMMAND\n", line);
+    bool found = false;
+    size_t begin = 0;
+    char *newline;
+    while ((newline = memchr(session->errors + begin, '\n', session->errorsSize - begin)) != NULL) {
+        size_t end = (size_t) (newline - session->errors) + 1;
+        if ((end - begin == (size_t) length)
+            && (memcmp(session->errors + begin, expected, (size_t) length) == 0)) {
+            found = true;
+        }
+        begin = end;
+    }
+    memmove(session->errors, session->errors + begin, session->errorsSize - begin);
+    session->errorsSize -= begin;
+    return found;
+}
+
+/**
+ * Czeka, aż kalkulator potwierdzi wykonanie wiersza o zadanym numerze,
+ * odrzucając przy tym jego standardowe wyjście.
+ * @param[in,out] session : sesja
+ * @param[in] line : numer wiersza SYNC
+ */
+static void AwaitSync(Session *session, size_t line) {
+    static char drain[DRAIN_BLOCK];
+    for (;;) {
+        struct pollfd fds[2] = {{.fd = session->out, .events = POLLIN},
+                                {.fd = session->err, .events = POLLIN}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Fail("poll");
+        }
+        if (fds[0].revents != 0) {
+            if (read(session->out, drain, sizeof drain) == 0) {
+                fprintf(stderr, "calculator exited early\n");
+                exit(1);
+            }
+        }
+        if (fds[1].revents != 0) {
+            if (session->errorsCapacity - session->errorsSize < DRAIN_BLOCK) {
+                session->errorsCapacity += DRAIN_BLOCK;
+                session->errors = realloc(session->errors, session->errorsCapacity);
+                if (session->errors == NULL) {
+                    Fail("realloc");
+                }
+            }
+            ssize_t n = read(session->err, session->errors + session->errorsSize, DRAIN_BLOCK);
+            if (n == 0) {
+                fprintf(stderr, "calculator exited early\n");
+                exit(1);
+            }
+            if (n > 0) {
+                session->errorsSize += (size_t) n;
+                if (FindSync(session, line)) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Wysyła kalkulatorowi wiersz, a po nim wiersz SYNC, i czeka na jego wykonanie.
+ * @param[in,out] session : sesja
+ * @param[in] line : wiersz razem ze znakiem nowej linii, NULL oznacza sam SYNC
+ * @param[in] length : długość wiersza
+ * @return czas wykonania w mikrosekundach
+ */
+static double Roundtrip(Session *session, const char *line, size_t length) {
+    static const char sync[] = "SYNC\n";
+    double start = BenchNow();
+    if (line != NULL) {
+        WriteAll(session->in, line, length);
+        ++session->line;
+    }
+    WriteAll(session->in, sync, sizeof sync - 1);
+    ++session->line;
+    AwaitSync(session, session->line);
+    return (BenchNow() - start) * 1e6;
+}
+
+/**
+ * Kończy sesję, czekając na zakończenie kalkulatora.
+ * @param[in,out] session : sesja
+ */
+static void EndSession(Session *session) {
+    static char drain[DRAIN_BLOCK];
+    close(session->in);
+    while (read(session->out, drain, sizeof drain) > 0) {
+    }
+    while (read(session->err, drain, sizeof drain) > 0) {
+    }
+    close(session->out);
+    close(session->err);
+    waitpid(session->pid, NULL, 0);
+    free(session->errors);
+}
+
+/**
+ * Dodaje czas wykonania polecenia do zbioru czasów polecenia o tej nazwie.
+ * @param[in,out] table : zbiory czasów
+ * @param[in,out] count : liczba zbiorów
+ * @param[in] name : nazwa polecenia
+ * @param[in] micros : czas w mikrosekundach
+ */
+static void Record(Latencies *table, size_t *count, const char *name, double micros) {
+    size_t i = 0;
+    while ((i < *count) && (strcmp(table[i].name, name) != 0)) {
+        ++i;
+    }
+    if (i == *count) {
+        if (*count == MAX_COMMANDS) {
+            return;
+        }
+        snprintf(table[i].name, MAX_NAME, "%s", name);
+        table[i].samples = NULL;
+        table[i].count = 0;
+        table[i].capacity = 0;
+        ++*count;
+    }
+    if (table[i].count == table[i].capacity) {
+        table[i].capacity = table[i].capacity > 0 ? 2 * table[i].capacity : 64;
+        table[i].samples = realloc(table[i].samples, table[i].capacity * sizeof(double));
+        if (table[i].samples == NULL) {
+            Fail("realloc");
+        }
+    }
+    table[i].samples[table[i].count++] = micros;
+}
+
+/**
+ * Wyznacza nazwę polecenia w wierszu skryptu: pierwsze słowo, LITERAL dla
+ * wielomianu, COMMENT dla komentarza i EMPTY dla pustego wiersza.
+ * @param[in] line : wiersz
+ * @param[in] length : długość wiersza bez znaku nowej linii
+ * @param[out] name : nazwa, bufor o rozmiarze MAX_NAME
+ */
+static void CommandName(const char *line, size_t length, char *name) {
+    if (length == 0) {
+        strcpy(name, "EMPTY");
+    } else if (line[0] == '#') {
+        strcpy(name, "COMMENT");
+    } else if ((line[0] == '(') || (line[0] == '-') || ((line[0] >= '0') && (line[0] <= '9'))) {
+        strcpy(name, "LITERAL");
+    } else {
+        size_t n = 0;
+        while ((n < length) && (n < MAX_NAME - 1) && (line[n] != ' ')) {
+            name[n] = line[n];
+            ++n;
+        }
+        name[n] = '\0';
+    }
+}
+
+/**
+ * Mierzy czasy wykonania poszczególnych wierszy skryptu.
+ * @param[in] script : skrypt
+ * @param[in] argv : program i jego argumenty
+ * @param[out] table : zbiory czasów, tablica o rozmiarze MAX_COMMANDS
+ * @return liczba zbiorów czasów
+ */
+static size_t MeasureLatencies(const Script *script, char *const argv[], Latencies *table) {
+    size_t count = 0;
+    Session session = StartSession(argv);
+    for (int i = 0; i < SYNC_ROUNDS; ++i) {
+        Record(table, &count, "SYNC", Roundtrip(&session, NULL, 0));
+    }
+    const char *pos = script->data;
+    const char *end = script->data + script->bytes;
+    while (pos < end) {
+        const char *newline = memchr(pos, '\n', (size_t) (end - pos));
+        size_t length = newline != NULL ? (size_t) (newline - pos) : (size_t) (end - pos);
+        char name[MAX_NAME];
+        CommandName(pos, length, name);
+        double micros;
+        if (newline != NULL) {
+            micros = Roundtrip(&session, pos, length + 1);
+        } else {
+            WriteAll(session.in, pos, length);
+            micros = Roundtrip(&session, "\n", 1);
+        }
+        Record(table, &count, name, micros);
+        pos += length + 1;
+    }
+    EndSession(&session);
+    return count;
+}
+
+/**
+ * Wypisuje sposób użycia programu.
+ * @param[in] name : nazwa programu
+ * @return kod wyjścia programu
+ */
+static int Usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-r runs] [-l] script program [args...]\n", name);
+    return 1;
+}
+
+/**
+ * Wykonuje pomiary i wypisuje wyniki.
+ * @param[in] argc : liczba argumentów programu
+ * @param[in] argv : argumenty programu
+ * @return kod wyjścia programu
+ */
+int main(int argc, char *argv[]) {
+    size_t runs = DEFAULT_RUNS;
+    bool latency = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "+r:l")) != -1) {
+        switch (opt) {
+            case 'r':
+                runs = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                latency = true;
+                break;
+            default:
+                return Usage(argv[0]);
+        }
+    }
+    if ((argc - optind < 2) || (runs == 0)) {
+        return Usage(argv[0]);
+    }
+    const char *path = argv[optind];
+    char *const *program = argv + optind + 1;
+    signal(SIGPIPE, SIG_IGN);
+    Script script = ReadScript(path);
+
+    double *seconds = malloc(runs * sizeof *seconds);
+    double bestUser = -1, bestSys = -1;
+    for (size_t i = 0; i < runs; ++i) {
+        double user, sys;
+        seconds[i] = RunOnce(path, program, &user, &sys);
+        if ((bestUser < 0) || (user + sys < bestUser + bestSys)) {
+            bestUser = user;
+            bestSys = sys;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_CHILDREN, &usage);
+    BenchStats wall = BenchSummarize(seconds, runs);
+
+    printf("{\"benchmark\": \"calc_bench\", \"script\": ");
+    BenchPrintString(stdout, path);
+    printf(", \"program\": ");
+    BenchPrintString(stdout, program[0]);
+    printf(", \"lines\": %zu, \"bytes\": %zu, \"runs\": %zu,\n", script.lines, script.bytes, runs);
+    printf(" \"throughput\": {\"seconds\": ");
+    BenchPrintStats(stdout, &wall);
+    printf(", \"lines_per_second\": %.6g, \"bytes_per_second\": %.6g, "
+           "\"user_seconds\": %.6g, \"sys_seconds\": %.6g, \"peak_rss_kb\": %ld}",
+           (double) script.lines / wall.p50, (double) script.bytes / wall.p50,
+           bestUser, bestSys, usage.ru_maxrss);
+
+    if (latency) {
+        Latencies table[MAX_COMMANDS];
+        size_t count = MeasureLatencies(&script, program, table);
+        printf(",\n \"latency_us\": {");
+        for (size_t i = 0; i < count; ++i) {
+            BenchStats stats = BenchSummarize(table[i].samples, table[i].count);
+            printf("%s\n  ", i > 0 ? "," : "");
+            BenchPrintString(stdout, table[i].name);
+            printf(": ");
+            BenchPrintStats(stdout, &stats);
+            free(table[i].samples);
+        }
+        printf("\n }");
+    }
+    printf("}\n");
+
+    free(seconds);
+    free(script.data);
+    return 0;
+}
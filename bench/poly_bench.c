@@ -0,0 +1,437 @@
+/** @file
+  Mikropomiary czasu operacji na wielomianach.
+  Mierzy PolyAdd, PolyMul, PolySub, PolyAt, PolyCompose, PolyDegBy, PolyIsEq,
+  PolyClone i PolyDestroy na wielomianach rzadkich, gęstych, głęboko
+  zagnieżdżonych i szerokich o rosnących rozmiarach. Dane są losowane
+  z ustalonego ziarna, więc kolejne uruchomienia mierzą te same wielomiany.
+
+  Każdy pomiar to seria próbek. Próbka to czas wykonania operacji tyle razy,
+  żeby trwało to co najmniej MIN_SAMPLE_SECONDS, podzielony przez liczbę
+  wykonań. Przed próbkami wykonywane są próbki rozgrzewające, których wynik
+  jest pomijany. Czas zwolnienia wyników nie jest wliczany do pomiaru
+  (z wyjątkiem samego PolyDestroy), a czas tworzenia kopii do zwolnienia nie
+  jest wliczany do pomiaru PolyDestroy.
+
+  Wyniki wypisywane są na standardowe wyjście w formacie JSON, w nanosekundach
+  na jedno wykonanie operacji.
+
+  Kompilacja z katalogu głównego repozytorium:
+  @code
+  gcc -std=c11 -O2 -I. bench/poly_bench.c bench/bench_util.c poly.c poly_trace.c additional_functions.c -o poly_bench
+  @endcode
+
+  Opcje: `-s ziarno`, `-r liczba_próbek`, `-w liczba_próbek_rozgrzewających`,
+  `-n największy_rozmiar`, `-o operacja` (mierzy tylko operację o tej nazwie,
+  np. `-o PolyMul`).
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench_util.h"
+#include "poly.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define DEFAULT_SEED 2021
+#define DEFAULT_REPETITIONS 30
+#define DEFAULT_WARMUP 3
+#define DEFAULT_MAX_SIZE 4096
+#define MIN_SIZE 16
+#define SIZE_STEP 4
+#define MIN_SAMPLE_SECONDS 1e-3
+#define MAX_BATCH 4096
+#define COEFF_RANGE 19
+#define SPARSE_GAP 64
+#define AT_POINT 3
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest typ wyliczeniowy mierzonych operacji.
+ */
+typedef enum {
+    OP_ADD, OP_MUL, OP_SUB, OP_AT, OP_COMPOSE, OP_DEG_BY, OP_IS_EQ, OP_CLONE, OP_DESTROY,
+    OP_COUNT
+} Operation;
+
+/**
+ * To jest typ wyliczeniowy rodzajów wielomianów.
+ */
+typedef enum {
+    SHAPE_SPARSE, SHAPE_DENSE, SHAPE_DEEP, SHAPE_WIDE, SHAPE_COUNT
+} Shape;
+
+/**
+ * To jest struktura opisująca mierzoną operację.
+ */
+typedef struct {
+    const char *name; ///< nazwa funkcji z poly.h
+    size_t maxSize; ///< największy rozmiar danych, na którym operacja jest mierzona
+} OperationInfo;
+
+/**
+ * To jest struktura przechowująca argumenty mierzonej operacji.
+ */
+typedef struct {
+    Poly p; ///< pierwszy argument
+    Poly q; ///< drugi argument
+    Poly copy; ///< kopia pierwszego argumentu, do porównań
+    Poly args[1]; ///< wielomiany podstawiane w PolyCompose
+} Operands;
+
+/** Mierzone operacje; rozmiary mnożenia i złożenia ograniczone ze względu na ich złożoność. */
+static const OperationInfo operations[OP_COUNT] = {
+    [OP_ADD] = {"PolyAdd", SIZE_MAX},
+    [OP_MUL] = {"PolyMul", 1024},
+    [OP_SUB] = {"PolySub", SIZE_MAX},
+    [OP_AT] = {"PolyAt", SIZE_MAX},
+    [OP_COMPOSE] = {"PolyCompose", 256},
+    [OP_DEG_BY] = {"PolyDegBy", SIZE_MAX},
+    [OP_IS_EQ] = {"PolyIsEq", SIZE_MAX},
+    [OP_CLONE] = {"PolyClone", SIZE_MAX},
+    [OP_DESTROY] = {"PolyDestroy", SIZE_MAX}
+};
+
+/** Nazwy rodzajów wielomianów. */
+static const char *const shapes[SHAPE_COUNT] = {
+    [SHAPE_SPARSE] = "sparse",
+    [SHAPE_DENSE] = "dense",
+    [SHAPE_DEEP] = "deep",
+    [SHAPE_WIDE] = "wide"
+};
+
+/** Zapobiega usunięciu przez kompilator wywołań, których wynik nie jest używany. */
+static volatile long sink;
+
+/**
+ * Losuje niezerowy współczynnik.
+ * @param[in,out] rng : generator
+ * @return współczynnik z przedziału @f$[-9, 9]@f$ różny od zera
+ */
+static poly_coeff_t RandomCoeff(BenchRandom *rng) {
+    poly_coeff_t c = (poly_coeff_t) BenchRandomBelow(rng, COEFF_RANGE) - COEFF_RANGE / 2;
+    return c != 0 ? c : 1;
+}
+
+/**
+ * Tworzy wielomian jednej zmiennej o losowych współczynnikach.
+ * @param[in,out] rng : generator
+ * @param[in] count : liczba jednomianów
+ * @param[in] maxGap : największy odstęp między kolejnymi wykładnikami
+ * @return wielomian
+ */
+static Poly Univariate(BenchRandom *rng, size_t count, poly_exp_t maxGap) {
+    Mono *monos = malloc(count * sizeof *monos);
+    poly_exp_t exp = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Poly c = PolyFromCoeff(RandomCoeff(rng));
+        monos[i] = MonoFromPoly(&c, exp);
+        exp += 1 + (poly_exp_t) BenchRandomBelow(rng, (uint64_t) maxGap);
+    }
+    return PolyOwnMonos(count, monos);
+}
+
+/**
+ * Tworzy wielomian o zagnieżdżeniu równym połowie rozmiaru,
+ * @f$c_0 + x_0^{e_0}(c_1 + x_1^{e_1}(c_2 + \ldots))@f$.
+ * @param[in,out] rng : generator
+ * @param[in] size : liczba jednomianów
+ * @return wielomian
+ */
+static Poly Deep(BenchRandom *rng, size_t size) {
+    Poly p = PolyFromCoeff(RandomCoeff(rng));
+    for (size_t i = size / 2; i > 0; --i) {
+        Poly c = PolyFromCoeff(RandomCoeff(rng));
+        poly_exp_t exp = 1 + (poly_exp_t) BenchRandomBelow(rng, 4);
+        Mono monos[2] = {MonoFromPoly(&c, 0), MonoFromPoly(&p, exp)};
+        p = PolyAddMonos(2, monos);
+    }
+    return p;
+}
+
+/**
+ * Tworzy wielomian dwóch zmiennych, w którym około @f$\sqrt{size}@f$
+ * jednomianów zmiennej @f$x_0@f$ ma za współczynniki wielomiany zmiennej
+ * @f$x_1@f$ o około @f$\sqrt{size}@f$ jednomianach.
+ * @param[in,out] rng : generator
+ * @param[in] size : liczba jednomianów
+ * @return wielomian
+ */
+static Poly Wide(BenchRandom *rng, size_t size) {
+    size_t width = 1;
+    while ((width + 1) * (width + 1) <= size) {
+        ++width;
+    }
+    Mono *monos = malloc(width * sizeof *monos);
+    for (size_t i = 0; i < width; ++i) {
+        Poly c = Univariate(rng, width, 2);
+        monos[i] = MonoFromPoly(&c, (poly_exp_t) i);
+    }
+    return PolyOwnMonos(width, monos);
+}
+
+/**
+ * Tworzy losowy wielomian zadanego rodzaju.
+ * @param[in,out] rng : generator
+ * @param[in] shape : rodzaj wielomianu
+ * @param[in] size : przybliżona liczba jednomianów
+ * @return wielomian
+ */
+static Poly Generate(BenchRandom *rng, Shape shape, size_t size) {
+    switch (shape) {
+        case SHAPE_SPARSE:
+            return Univariate(rng, size, SPARSE_GAP);
+        case SHAPE_DENSE:
+            return Univariate(rng, size, 1);
+        case SHAPE_DEEP:
+            return Deep(rng, size);
+        default:
+            return Wide(rng, size);
+    }
+}
+
+/**
+ * Liczy jednomiany wielomianu na wszystkich poziomach zagnieżdżenia.
+ * @param[in] p : wielomian
+ * @return liczba jednomianów
+ */
+static size_t CountMonos(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return 0;
+    }
+    size_t count = p->size;
+    for (size_t i = 0; i < p->size; ++i) {
+        count += CountMonos(&p->arr[i].p);
+    }
+    return count;
+}
+
+/**
+ * Wykonuje operację zadaną liczbę razy.
+ * @param[in] op : operacja
+ * @param[in] in : argumenty
+ * @param[in,out] results : tablica na wyniki; dla PolyDestroy zawiera
+ * wielomiany do zwolnienia
+ * @param[in] count : liczba wykonań
+ * @return czas wykonania w sekundach
+ */
+static double Run(Operation op, const Operands *in, Poly *results, size_t count) {
+    long acc = 0;
+    double start = BenchNow();
+    switch (op) {
+        case OP_ADD:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolyAdd(&in->p, &in->q);
+            }
+            break;
+        case OP_MUL:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolyMul(&in->p, &in->q);
+            }
+            break;
+        case OP_SUB:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolySub(&in->p, &in->q);
+            }
+            break;
+        case OP_AT:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolyAt(&in->p, AT_POINT);
+            }
+            break;
+        case OP_COMPOSE:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolyCompose(&in->p, 1, in->args);
+            }
+            break;
+        case OP_DEG_BY:
+            for (size_t i = 0; i < count; ++i) {
+                acc += PolyDegBy(&in->p, 1);
+            }
+            break;
+        case OP_IS_EQ:
+            for (size_t i = 0; i < count; ++i) {
+                acc += PolyIsEq(&in->p, &in->copy);
+            }
+            break;
+        case OP_CLONE:
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = PolyClone(&in->p);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < count; ++i) {
+                PolyDestroy(&results[i]);
+            }
+            break;
+    }
+    double elapsed = BenchNow() - start;
+    sink += acc;
+    return elapsed;
+}
+
+/**
+ * Sprawdza, czy operacja tworzy wielomiany, które trzeba potem zwolnić.
+ * @param[in] op : operacja
+ * @return czy operacja tworzy wielomiany
+ */
+static bool ProducesPolys(Operation op) {
+    return (op != OP_DEG_BY) && (op != OP_IS_EQ) && (op != OP_DESTROY);
+}
+
+/**
+ * Wykonuje jedną próbkę pomiaru, przygotowując wcześniej wielomiany
+ * do zwolnienia i zwalniając potem wyniki.
+ * @param[in] op : operacja
+ * @param[in] in : argumenty
+ * @param[in,out] results : tablica na wyniki
+ * @param[in] count : liczba wykonań
+ * @return czas wykonania w sekundach
+ */
+static double Sample(Operation op, const Operands *in, Poly *results, size_t count) {
+    if (op == OP_DESTROY) {
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = PolyClone(&in->p);
+        }
+    }
+    double elapsed = Run(op, in, results, count);
+    if (ProducesPolys(op)) {
+        for (size_t i = 0; i < count; ++i) {
+            PolyDestroy(&results[i]);
+        }
+    }
+    return elapsed;
+}
+
+/**
+ * Mierzy operację na jednym zestawie argumentów i wypisuje wynik jako obiekt JSON.
+ * @param[in] op : operacja
+ * @param[in] shape : rodzaj wielomianów
+ * @param[in] size : rozmiar wielomianów
+ * @param[in] in : argumenty
+ * @param[in] repetitions : liczba próbek
+ * @param[in] warmup : liczba próbek rozgrzewających
+ * @param[in] first : czy jest to pierwszy wypisywany wynik
+ */
+static void Measure(Operation op, Shape shape, size_t size, const Operands *in,
+                    size_t repetitions, size_t warmup, bool first) {
+    Poly *results = malloc(MAX_BATCH * sizeof *results);
+    size_t batch = 1;
+    while ((batch < MAX_BATCH) && (Sample(op, in, results, batch) < MIN_SAMPLE_SECONDS)) {
+        batch *= 2;
+    }
+    for (size_t i = 0; i < warmup; ++i) {
+        Sample(op, in, results, batch);
+    }
+    double *samples = malloc(repetitions * sizeof *samples);
+    for (size_t i = 0; i < repetitions; ++i) {
+        samples[i] = Sample(op, in, results, batch) * 1e9 / (double) batch;
+    }
+    BenchStats stats = BenchSummarize(samples, repetitions);
+
+    printf("%s\n    {\"op\": ", first ? "" : ",");
+    BenchPrintString(stdout, operations[op].name);
+    printf(", \"shape\": ");
+    BenchPrintString(stdout, shapes[shape]);
+    printf(", \"size\": %zu, \"monos\": %zu, \"batch\": %zu, \"ns_per_op\": ",
+           size, CountMonos(&in->p), batch);
+    BenchPrintStats(stdout, &stats);
+    printf("}");
+    fflush(stdout);
+
+    free(samples);
+    free(results);
+}
+
+/**
+ * Wypisuje sposób użycia programu.
+ * @param[in] name : nazwa programu
+ * @return kod wyjścia programu
+ */
+static int Usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-s seed] [-r repetitions] [-w warmup] [-n max_size] [-o op]\n",
+            name);
+    return 1;
+}
+
+/**
+ * Losuje argumenty dla każdego rodzaju i rozmiaru wielomianów
+ * i mierzy na nich wybrane operacje.
+ * @param[in] argc : liczba argumentów programu
+ * @param[in] argv : argumenty programu
+ * @return kod wyjścia programu
+ */
+int main(int argc, char *argv[]) {
+    unsigned long long seed = DEFAULT_SEED;
+    size_t repetitions = DEFAULT_REPETITIONS;
+    size_t warmup = DEFAULT_WARMUP;
+    size_t maxSize = DEFAULT_MAX_SIZE;
+    const char *only = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:r:w:n:o:")) != -1) {
+        switch (opt) {
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'r':
+                repetitions = strtoul(optarg, NULL, 10);
+                break;
+            case 'w':
+                warmup = strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                maxSize = strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                only = optarg;
+                break;
+            default:
+                return Usage(argv[0]);
+        }
+    }
+    if ((optind != argc) || (repetitions == 0)) {
+        return Usage(argv[0]);
+    }
+
+    printf("{\"benchmark\": \"poly_bench\", \"seed\": %llu, \"repetitions\": %zu, "
+           "\"warmup\": %zu, \"unit\": \"ns\", \"results\": [", seed, repetitions, warmup);
+    bool first = true;
+    for (Shape shape = 0; shape < SHAPE_COUNT; ++shape) {
+        for (size_t size = MIN_SIZE; size <= maxSize; size *= SIZE_STEP) {
+            BenchRandom rng;
+            BenchRandomInit(&rng, seed ^ ((uint64_t) shape << 32) ^ size);
+            Operands in;
+            in.p = Generate(&rng, shape, size);
+            in.q = Generate(&rng, shape, size);
+            in.copy = PolyClone(&in.p);
+            Poly one = PolyFromCoeff(1);
+            Poly x = PolyFromCoeff(1);
+            Mono monos[2] = {MonoFromPoly(&one, 0), MonoFromPoly(&x, 1)};
+            in.args[0] = PolyAddMonos(2, monos);
+
+            for (Operation op = 0; op < OP_COUNT; ++op) {
+                if ((size <= operations[op].maxSize)
+                    && ((only == NULL) || (strcmp(only, operations[op].name) == 0))) {
+                    Measure(op, shape, size, &in, repetitions, warmup, first);
+                    first = false;
+                }
+            }
+
+            PolyDestroy(&in.p);
+            PolyDestroy(&in.q);
+            PolyDestroy(&in.copy);
+            PolyDestroy(&in.args[0]);
+        }
+    }
+    printf("\n]}\n");
+    return 0;
+}
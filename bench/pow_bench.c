@@ -0,0 +1,196 @@
+/** @file
+  Pomiar czasu algorytmów potęgowania wielomianów.
+  Porównuje wszystkie warianty PolyPowMethod na kilku rodzajach wielomianów;
+  na jego podstawie dobrano progi wyboru algorytmu w poly.c. Przed pomiarami
+  sprawdza, że potęgowanie wielomianu o jednym jednomianie nie zależy
+  od wielkości wykładnika.
+
+  Kompilacja z katalogu głównego repozytorium:
+  @code
+  gcc -std=c11 -O2 -I. bench/pow_bench.c poly.c poly_trace.c additional_functions.c -o pow_bench
+  @endcode
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "poly.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define REPEATS 5
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * Zwraca bieżący czas monotoniczny w sekundach.
+ * @return czas w sekundach
+ */
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Tworzy wielomian jednej zmiennej o podanych wykładnikach
+ * i pseudolosowych niezerowych współczynnikach.
+ * @param[in] count : liczba jednomianów
+ * @param[in] step : odstęp między kolejnymi wykładnikami
+ * @return wielomian @f$\sum_{i} c_i x_0^{i \cdot step}@f$
+ */
+static Poly Univariate(size_t count, poly_exp_t step) {
+    Mono *monos = malloc(count * sizeof *monos);
+    for (size_t i = 0; i < count; ++i) {
+        Poly c = PolyFromCoeff((poly_coeff_t) (rand() % 9 + 1));
+        monos[i] = MonoFromPoly(&c, (poly_exp_t) i * step);
+    }
+    return PolyOwnMonos(count, monos);
+}
+
+/**
+ * Tworzy wielomian wielu zmiennych @f$\sum_{i} x_i@f$ z dodanym wyrazem wolnym.
+ * @param[in] vars : liczba zmiennych
+ * @return wielomian @f$1 + x_0 + x_1 + \ldots + x_{vars-1}@f$
+ */
+static Poly Nested(size_t vars) {
+    Poly p = PolyFromCoeff(1);
+    for (size_t i = vars; i > 0; --i) {
+        Poly one = PolyFromCoeff(1);
+        Mono monos[2] = {MonoFromPoly(&p, 0), MonoFromPoly(&one, 1)};
+        p = PolyAddMonos(2, monos);
+    }
+    return p;
+}
+
+/**
+ * Mierzy najkrótszy z REPEATS czasów obliczenia @f$p^{exp}@f$ zadaną metodą.
+ * @param[in] p : podstawa
+ * @param[in] exp : wykładnik
+ * @param[in] method : algorytm potęgowania
+ * @return czas w sekundach
+ */
+static double Measure(const Poly *p, poly_exp_t exp, PolyPowMethod method) {
+    double best = -1;
+    for (int i = 0; i < REPEATS; ++i) {
+        double start = Now();
+        Poly r = PolyPowWith(p, exp, method);
+        double elapsed = Now() - start;
+        PolyDestroy(&r);
+        if ((best < 0) || (elapsed < best)) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/**
+ * Wypisuje wiersz tabeli z czasami wszystkich algorytmów dla jednego przypadku.
+ * @param[in] name : nazwa przypadku
+ * @param[in] p : podstawa
+ * @param[in] exp : wykładnik
+ */
+static void Row(const char *name, const Poly *p, poly_exp_t exp) {
+    static const PolyPowMethod methods[] = {
+        POLY_POW_AUTO, POLY_POW_BINARY, POLY_POW_REPEATED,
+        POLY_POW_MULTINOMIAL, POLY_POW_DENSE
+    };
+    printf("%-24s %5d", name, exp);
+    for (size_t i = 0; i < sizeof methods / sizeof methods[0]; ++i) {
+        printf(" %11.6f", Measure(p, exp, methods[i]));
+    }
+    printf("\n");
+}
+
+/**
+ * Sprawdza, czy każdy algorytm potęguje wielomian o jednym jednomianie
+ * z ogromnym wykładnikiem wprost, bez kosztu zależnego od wykładnika:
+ * @f$(2 x_0)^{10^9}@f$ to @f$2^{10^9} x_0^{10^9}@f$, czyli zero modulo
+ * @f$2^{64}@f$, a @f$x_0^{10^9}@f$ to jeden jednomian.
+ * @return Czy wszystkie wyniki są poprawne?
+ */
+static bool CheckSingleTerm(void) {
+    static const PolyPowMethod methods[] = {
+        POLY_POW_AUTO, POLY_POW_BINARY, POLY_POW_REPEATED,
+        POLY_POW_MULTINOMIAL, POLY_POW_DENSE
+    };
+    const poly_exp_t exp = 1000000000;
+    bool correct = true;
+    Poly one = PolyFromCoeff(1);
+    Poly two = PolyFromCoeff(2);
+    Mono x = MonoFromPoly(&one, 1);
+    Mono two_x = MonoFromPoly(&two, 1);
+    Poly p = PolyAddMonos(1, &x);
+    Poly q = PolyAddMonos(1, &two_x);
+    for (size_t i = 0; i < sizeof methods / sizeof methods[0]; ++i) {
+        Poly r = PolyPowWith(&p, exp, methods[i]);
+        Poly s = PolyPowWith(&q, exp, methods[i]);
+        if ((r.arr == NULL) || (r.size != 1) || (r.arr[0].exp != exp) || !PolyIsZero(&s)) {
+            fprintf(stderr, "method %zu: wrong power of a single-term polynomial\n", i);
+            correct = false;
+        }
+        PolyDestroy(&r);
+        PolyDestroy(&s);
+    }
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    return correct;
+}
+
+/**
+ * Uruchamia pomiary dla wielomianów rzadkich, gęstych,
+ * dwu- i trójmianów oraz wielomianów wielu zmiennych.
+ * @return kod wyjścia programu
+ */
+int main(void) {
+    if (!CheckSingleTerm()) {
+        return 1;
+    }
+    srand(2021);
+    printf("%-24s %5s %11s %11s %11s %11s %11s\n", "case", "exp",
+           "auto", "binary", "repeated", "multinom", "dense");
+
+    Poly binomial = Univariate(2, 1);
+    Row("binomial", &binomial, 64);
+    Row("binomial", &binomial, 512);
+    PolyDestroy(&binomial);
+
+    Poly trinomial = Univariate(3, 1);
+    Row("trinomial", &trinomial, 64);
+    Row("trinomial", &trinomial, 256);
+    PolyDestroy(&trinomial);
+
+    Poly quad = Univariate(4, 1);
+    Row("dense 4 terms", &quad, 128);
+    PolyDestroy(&quad);
+
+    Poly dense = Univariate(32, 1);
+    Row("dense 32 terms", &dense, 16);
+    Row("dense 32 terms", &dense, 64);
+    PolyDestroy(&dense);
+
+    Poly half = Univariate(16, 2);
+    Row("density 1/2", &half, 32);
+    PolyDestroy(&half);
+
+    Poly quarter = Univariate(16, 4);
+    Row("density 1/4", &quarter, 16);
+    PolyDestroy(&quarter);
+
+    Poly sparse = Univariate(8, 97);
+    Row("sparse 8 terms", &sparse, 6);
+    PolyDestroy(&sparse);
+
+    Poly nested = Nested(4);
+    Row("nested 4 vars", &nested, 8);
+    Row("nested 4 vars", &nested, 16);
+    PolyDestroy(&nested);
+
+    return 0;
+}
@@ -0,0 +1,347 @@
+/** @file
+  Generator skryptów kalkulatora do pomiarów wydajności całego programu.
+
+  Wypisuje na standardowe wyjście zadaną liczbę wierszy: wielomianów
+  i poleceń wylosowanych zgodnie z zadanymi wagami. Generator śledzi stan
+  stosu kalkulatora, więc polecenia mają zawsze wystarczająco dużo
+  argumentów, a szacowana liczba jednomianów i stopień każdego wielomianu
+  na stosie nie przekraczają zadanych granic. Dzięki temu skrypt dowolnej
+  długości ćwiczy parser, stos i wypisywanie, a nie tylko jedno
+  coraz większe mnożenie.
+
+  Kompilacja z katalogu głównego repozytorium:
+  @code
+  gcc -std=c11 -O2 -I. bench/script_gen.c bench/bench_util.c -o script_gen
+  @endcode
+
+  Opcje: `-n liczba_wierszy`, `-s ziarno`, `-d głębokość_zagnieżdżenia`,
+  `-t jednomiany_na_poziomie`, `-e największy_wykładnik`,
+  `-c największy_współczynnik`, `-z największy_rozmiar`,
+  `-k największa_głębokość_stosu` oraz `-w POLECENIE=waga,...`
+  (np. `-w MUL=0,PRINT=20`; wielomiany mają nazwę LITERAL).
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench_util.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define DEFAULT_LINES 100000
+#define DEFAULT_SEED 2021
+#define DEFAULT_DEPTH 2
+#define DEFAULT_TERMS 4
+#define DEFAULT_MAX_EXP 8
+#define DEFAULT_MAX_COEFF 1000
+#define DEFAULT_MAX_SIZE 256
+#define DEFAULT_MAX_STACK 64
+#define MAX_COMPOSE_DEG 64
+#define MAX_ATTEMPTS 16
+#define AT_RANGE 5
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest typ wyliczeniowy generowanych wierszy.
+ */
+typedef enum {
+    GEN_LITERAL, GEN_ADD, GEN_MUL, GEN_SUB, GEN_COMPOSE, GEN_AT, GEN_PRINT, GEN_CLONE,
+    GEN_POP, GEN_DEG, GEN_IS_EQ, GEN_COUNT
+} Kind;
+
+/**
+ * To jest struktura opisująca rodzaj generowanego wiersza.
+ */
+typedef struct {
+    const char *name; ///< nazwa polecenia
+    unsigned weight; ///< domyślna waga losowania
+    size_t arity; ///< liczba wymaganych wielomianów na stosie
+} KindInfo;
+
+/**
+ * To jest struktura przechowująca szacunek wielkości wielomianu na stosie.
+ */
+typedef struct {
+    size_t size; ///< górne oszacowanie liczby jednomianów
+    size_t deg; ///< górne oszacowanie stopnia
+} Estimate;
+
+/**
+ * To jest struktura przechowująca parametry i stan generatora.
+ */
+typedef struct {
+    BenchRandom rng; ///< generator liczb pseudolosowych
+    unsigned weights[GEN_COUNT]; ///< wagi losowania rodzajów wierszy
+    unsigned totalWeight; ///< suma wag
+    unsigned depth; ///< największa głębokość zagnieżdżenia wielomianów
+    unsigned terms; ///< największa liczba jednomianów na jednym poziomie
+    unsigned maxExp; ///< największy wykładnik
+    unsigned long maxCoeff; ///< największa wartość bezwzględna współczynnika
+    size_t maxSize; ///< największa szacowana liczba jednomianów wielomianu
+    size_t maxStack; ///< największa liczba wielomianów na stosie
+    Estimate *stack; ///< szacunki wielomianów na stosie
+    size_t top; ///< liczba wielomianów na stosie
+} Generator;
+
+/** Rodzaje wierszy z domyślnymi wagami. */
+static const KindInfo kinds[GEN_COUNT] = {
+    [GEN_LITERAL] = {"LITERAL", 30, 0},
+    [GEN_ADD] = {"ADD", 15, 2},
+    [GEN_MUL] = {"MUL", 8, 2},
+    [GEN_SUB] = {"SUB", 5, 2},
+    [GEN_COMPOSE] = {"COMPOSE", 2, 2},
+    [GEN_AT] = {"AT", 5, 1},
+    [GEN_PRINT] = {"PRINT", 10, 1},
+    [GEN_CLONE] = {"CLONE", 10, 1},
+    [GEN_POP] = {"POP", 10, 1},
+    [GEN_DEG] = {"DEG", 2, 1},
+    [GEN_IS_EQ] = {"IS_EQ", 3, 2}
+};
+
+/**
+ * Wypisuje losowy wielomian i szacuje jego wielkość.
+ * @param[in,out] gen : generator
+ * @param[in] depth : pozostała głębokość zagnieżdżenia
+ * @return szacunek wielkości wypisanego wielomianu
+ */
+static Estimate Literal(Generator *gen, unsigned depth) {
+    if ((depth == 0) || (BenchRandomBelow(&gen->rng, 4) == 0)) {
+        long coeff = (long) BenchRandomBelow(&gen->rng, 2 * gen->maxCoeff + 1)
+                     - (long) gen->maxCoeff;
+        printf("%ld", coeff);
+        return (Estimate) {.size = 1, .deg = 0};
+    }
+    Estimate result = {.size = 0, .deg = 0};
+    unsigned count = 1 + (unsigned) BenchRandomBelow(&gen->rng, gen->terms);
+    for (unsigned i = 0; i < count; ++i) {
+        if (i > 0) {
+            putchar('+');
+        }
+        putchar('(');
+        Estimate e = Literal(gen, depth - 1);
+        unsigned exp = (unsigned) BenchRandomBelow(&gen->rng, gen->maxExp + 1);
+        printf(",%u)", exp);
+        result.size += e.size;
+        if (e.deg + exp > result.deg) {
+            result.deg = e.deg + exp;
+        }
+    }
+    return result;
+}
+
+/**
+ * Sprawdza, czy wiersz danego rodzaju może zostać wygenerowany
+ * w bieżącym stanie stosu.
+ * @param[in] gen : generator
+ * @param[in] kind : rodzaj wiersza
+ * @return czy wiersz jest dopuszczalny
+ */
+static bool Allowed(const Generator *gen, Kind kind) {
+    if (gen->top < kinds[kind].arity) {
+        return false;
+    }
+    const Estimate *p = &gen->stack[gen->top - 1];
+    const Estimate *q = gen->top >= 2 ? &gen->stack[gen->top - 2] : NULL;
+    switch (kind) {
+        case GEN_LITERAL:
+        case GEN_CLONE:
+            return gen->top < gen->maxStack;
+        case GEN_ADD:
+        case GEN_SUB:
+            return p->size + q->size <= gen->maxSize;
+        case GEN_MUL:
+            return p->size * q->size <= gen->maxSize;
+        case GEN_COMPOSE:
+            return (q->size * p->size <= gen->maxSize) && (q->deg * p->deg <= MAX_COMPOSE_DEG);
+        default:
+            return true;
+    }
+}
+
+/**
+ * Losuje rodzaj wiersza zgodnie z wagami spośród dopuszczalnych.
+ * Gdy kolejne losowania nie trafiają na dopuszczalny rodzaj, dokłada
+ * wielomian albo, przy pełnym stosie, zdejmuje go.
+ * @param[in,out] gen : generator
+ * @return rodzaj wiersza
+ */
+static Kind Choose(Generator *gen) {
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        unsigned r = (unsigned) BenchRandomBelow(&gen->rng, gen->totalWeight);
+        Kind kind = 0;
+        while (r >= gen->weights[kind]) {
+            r -= gen->weights[kind];
+            ++kind;
+        }
+        if (Allowed(gen, kind)) {
+            return kind;
+        }
+    }
+    return gen->top < gen->maxStack ? GEN_LITERAL : GEN_POP;
+}
+
+/**
+ * Wypisuje jeden wiersz skryptu i uaktualnia stan stosu.
+ * @param[in,out] gen : generator
+ */
+static void Line(Generator *gen) {
+    Kind kind = Choose(gen);
+    Estimate *p = gen->top >= 1 ? &gen->stack[gen->top - 1] : NULL;
+    Estimate *q = gen->top >= 2 ? &gen->stack[gen->top - 2] : NULL;
+    switch (kind) {
+        case GEN_LITERAL:
+            gen->stack[gen->top++] = Literal(gen, gen->depth);
+            putchar('\n');
+            return;
+        case GEN_ADD:
+        case GEN_SUB:
+            q->size += p->size;
+            q->deg = q->deg > p->deg ? q->deg : p->deg;
+            --gen->top;
+            break;
+        case GEN_MUL:
+            q->size *= p->size;
+            q->deg += p->deg;
+            --gen->top;
+            break;
+        case GEN_COMPOSE:
+            q->size *= p->size;
+            q->deg *= p->deg > 0 ? p->deg : 1;
+            --gen->top;
+            printf("COMPOSE 1\n");
+            return;
+        case GEN_AT:
+            printf("AT %ld\n", (long) BenchRandomBelow(&gen->rng, 2 * AT_RANGE + 1) - AT_RANGE);
+            return;
+        case GEN_CLONE:
+            gen->stack[gen->top] = *p;
+            ++gen->top;
+            break;
+        case GEN_POP:
+            --gen->top;
+            break;
+        default:
+            break;
+    }
+    printf("%s\n", kinds[kind].name);
+}
+
+/**
+ * Ustawia wagi rodzajów wierszy na podstawie napisu `POLECENIE=waga,...`.
+ * @param[in,out] gen : generator
+ * @param[in] spec : napis z wagami
+ * @return czy napis był poprawny
+ */
+static bool SetWeights(Generator *gen, const char *spec) {
+    while (*spec != '\0') {
+        const char *eq = strchr(spec, '=');
+        if (eq == NULL) {
+            return false;
+        }
+        Kind kind = 0;
+        while ((kind < GEN_COUNT) && ((strlen(kinds[kind].name) != (size_t) (eq - spec))
+                                      || (strncmp(kinds[kind].name, spec, (size_t) (eq - spec)) != 0))) {
+            ++kind;
+        }
+        if (kind == GEN_COUNT) {
+            return false;
+        }
+        char *end;
+        gen->weights[kind] = (unsigned) strtoul(eq + 1, &end, 10);
+        if ((*end != ',') && (*end != '\0')) {
+            return false;
+        }
+        spec = *end == ',' ? end + 1 : end;
+    }
+    return true;
+}
+
+/**
+ * Wypisuje sposób użycia programu.
+ * @param[in] name : nazwa programu
+ * @return kod wyjścia programu
+ */
+static int Usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-n lines] [-s seed] [-d depth] [-t terms] [-e max_exp] "
+                    "[-c max_coeff] [-z max_size] [-k max_stack] [-w KIND=weight,...]\n", name);
+    return 1;
+}
+
+/**
+ * Wczytuje parametry i wypisuje skrypt.
+ * @param[in] argc : liczba argumentów programu
+ * @param[in] argv : argumenty programu
+ * @return kod wyjścia programu
+ */
+int main(int argc, char *argv[]) {
+    Generator gen = {
+        .depth = DEFAULT_DEPTH, .terms = DEFAULT_TERMS, .maxExp = DEFAULT_MAX_EXP,
+        .maxCoeff = DEFAULT_MAX_COEFF, .maxSize = DEFAULT_MAX_SIZE, .maxStack = DEFAULT_MAX_STACK
+    };
+    for (Kind kind = 0; kind < GEN_COUNT; ++kind) {
+        gen.weights[kind] = kinds[kind].weight;
+    }
+    unsigned long long seed = DEFAULT_SEED;
+    unsigned long lines = DEFAULT_LINES;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:d:t:e:c:z:k:w:")) != -1) {
+        switch (opt) {
+            case 'n':
+                lines = strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'd':
+                gen.depth = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                gen.terms = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'e':
+                gen.maxExp = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'c':
+                gen.maxCoeff = strtoul(optarg, NULL, 10);
+                break;
+            case 'z':
+                gen.maxSize = strtoul(optarg, NULL, 10);
+                break;
+            case 'k':
+                gen.maxStack = strtoul(optarg, NULL, 10);
+                break;
+            case 'w':
+                if (!SetWeights(&gen, optarg)) {
+                    return Usage(argv[0]);
+                }
+                break;
+            default:
+                return Usage(argv[0]);
+        }
+    }
+    gen.totalWeight = 0;
+    for (Kind kind = 0; kind < GEN_COUNT; ++kind) {
+        gen.totalWeight += gen.weights[kind];
+    }
+    if ((optind != argc) || (gen.terms == 0) || (gen.maxStack == 0) || (gen.totalWeight == 0)) {
+        return Usage(argv[0]);
+    }
+
+    BenchRandomInit(&gen.rng, seed);
+    gen.stack = malloc(gen.maxStack * sizeof *gen.stack);
+    gen.top = 0;
+    for (unsigned long i = 0; i < lines; ++i) {
+        Line(&gen);
+    }
+    free(gen.stack);
+    return 0;
+}
@@ -0,0 +1,351 @@
+/** @file
+  Implementacja kodu bajtowego poleceń kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "bytecode.h"
+#include "additional_functions.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+#define FIRST_COMMAND OP_ZERO
+#define LAST_COMMAND OP_STATS
+#define WINDOW 2
+#define NAME(name) {name, sizeof(name) - 1}
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura przechowująca nazwę instrukcji.
+ */
+typedef struct {
+    const char *name; ///< nazwa
+    size_t length; ///< długość nazwy
+} OpcodeName;
+
+/** Nazwy instrukcji w kolejności kodów operacji. */
+static const OpcodeName opcodeNames[] = {
+        NAME("POLY"), NAME("WRONG POLY"), NAME("WRONG COMMAND"), NAME("ERROR"), NAME("ZERO"),
+        NAME("IS_COEFF"), NAME("IS_ZERO"), NAME("IS_EQ"), NAME("CLONE"), NAME("ADD"), NAME("MUL"),
+        NAME("NEG"), NAME("SUB"), NAME("DEG"), NAME("DEG_BY"), NAME("AT"), NAME("PRINT"),
+        NAME("POP"), NAME("COMPOSE"), NAME("COMPOSE_TRUNC"), NAME("MUL_TRUNC"), NAME("POW"),
+        NAME("SAVE"), NAME("LOAD"), NAME("MAP"), NAME("EXPORT"), NAME("MEM"), NAME("STATS"),
+        NAME("RSUB"), NAME("CLONE_POP")
+};
+
+/**
+ * Znajduje polecenie o podanej nazwie.
+ * @param[in] word : słowo z wejścia
+ * @param[in] length : długość słowa
+ * @return kod operacji polecenia lub OP_WRONG_COMMAND
+ */
+static Opcode findCommand(const char *word, size_t length) {
+    for (Opcode op = FIRST_COMMAND; op <= LAST_COMMAND; ++op) {
+#ifndef POLY_STATS
+        if (op == OP_STATS) {
+            continue;
+        }
+#endif
+        if ((opcodeNames[op].length == length) && (memcmp(opcodeNames[op].name, word, length) == 0)) {
+            return op;
+        }
+    }
+    return OP_WRONG_COMMAND;
+}
+
+/**
+ * Sprawdza, czy kursor stoi na końcu linii, nie przesuwając go.
+ * @param[in,out] in : kursor
+ * @return Czy kursor stoi na końcu linii?
+ */
+static bool atLineEnd(Cursor *in) {
+    int c = cursorGet(in);
+    cursorUnget(in, c);
+    return (c == EOF) || (c == '\n');
+}
+
+/**
+ * Wczytuje z kursora stopień zakończony końcem linii.
+ * Jeśli wczyta niedozwolony znak lub stopień nie mieści się w typie poly_exp_t,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return stopień
+ */
+static poly_exp_t readDegree(Cursor *in, bool *correct) {
+    unsigned long d = readUnsignedLong(in, correct);
+    if (d > INT_MAX) {
+        *correct = false;
+    }
+    if (!*correct) {
+        return 0;
+    }
+    if (!atLineEnd(in)) {
+        *correct = false;
+    }
+    return (poly_exp_t) d;
+}
+
+/**
+ * Wczytuje z kursora nazwę pliku: resztę linii bez znaku nowej linii.
+ * @param[in,out] in : kursor
+ * @return nazwa pliku zakończona znakiem '\0' lub NULL, jeśli nazwa jest pusta
+ * albo zawiera znak '\0'
+ */
+static char *readFileName(Cursor *in) {
+    const char *begin = in->pos;
+    const char *end = in->end;
+    if ((end > begin) && (end[-1] == '\n')) {
+        --end;
+    }
+    size_t length = (size_t) (end - begin);
+    if ((length == 0) || (memchr(begin, '\0', length) != NULL)) {
+        return NULL;
+    }
+    char *name = malloc(length + 1);
+    CheckReallocOutcome(name);
+    memcpy(name, begin, length);
+    name[length] = '\0';
+    in->pos = end;
+    return name;
+}
+
+/**
+ * Wczytuje parametry polecenia do instrukcji. Jeśli parametry są
+ * niepoprawne, zamienia instrukcję na OP_ERROR z komunikatem polecenia.
+ * @param[in,out] in : kursor za nazwą polecenia i znakiem, który po niej wystąpił
+ * @param[in] c : znak po nazwie polecenia
+ * @param[in,out] ins : instrukcja z kodem operacji polecenia
+ * @param[in] message : komunikat o błędnym parametrze
+ */
+static void decodeParameters(Cursor *in, int c, Instruction *ins, const char *message) {
+    bool correct = (c == ' ');
+    if (correct) {
+        switch (ins->op) {
+            case OP_DEG_BY:
+            case OP_COMPOSE:
+                ins->number = readUnsignedLong(in, &correct);
+                correct = correct && atLineEnd(in);
+                break;
+            case OP_COMPOSE_TRUNC:
+                ins->number = readUnsignedLong(in, &correct);
+                correct = correct && (cursorGet(in) == ' ');
+                if (correct) {
+                    ins->degree = readDegree(in, &correct);
+                }
+                break;
+            case OP_MUL_TRUNC:
+                ins->degree = readDegree(in, &correct);
+                break;
+            case OP_AT:
+                ins->value = readCoeff(in, &correct);
+                correct = correct && atLineEnd(in);
+                break;
+            case OP_POW: {
+                unsigned long exponent = readUnsignedLong(in, &correct);
+                correct = correct && (exponent <= INT_MAX) && atLineEnd(in);
+                ins->degree = (poly_exp_t) exponent;
+                break;
+            }
+            default:
+                ins->path = readFileName(in);
+                correct = ins->path != NULL;
+                break;
+        }
+    }
+    if (!correct) {
+        ins->command = ins->op;
+        ins->op = OP_ERROR;
+        ins->message = message;
+    }
+}
+
+bool decodeCommand(Cursor *in, int line, Instruction *ins) {
+    *ins = (Instruction) {.op = OP_WRONG_COMMAND, .command = OP_WRONG_COMMAND, .line = line,
+                          .other = line, .poly = PolyZero(), .number = 0, .degree = 0,
+                          .value = 0, .path = NULL, .message = NULL};
+    const char *word = in->pos;
+    size_t length = 0;
+    int c = cursorGet(in);
+    while ((c != EOF) && (c != '\n') && (!isspace(c))) {
+        if (!isLetter(c) && (c != '_')) {
+            return false;
+        }
+        ++length;
+        c = cursorGet(in);
+    }
+    bool endLine = (c == EOF) || (c == '\n');
+    if (endLine) {
+        cursorUnget(in, c);
+    }
+    ins->op = findCommand(word, length);
+    switch (ins->op) {
+        case OP_WRONG_COMMAND:
+            return false;
+        case OP_DEG_BY:
+            decodeParameters(in, c, ins, "DEG BY WRONG VARIABLE");
+            return true;
+        case OP_COMPOSE:
+            decodeParameters(in, c, ins, "COMPOSE WRONG PARAMETER");
+            return true;
+        case OP_COMPOSE_TRUNC:
+            decodeParameters(in, c, ins, "COMPOSE_TRUNC WRONG PARAMETER");
+            return true;
+        case OP_MUL_TRUNC:
+            decodeParameters(in, c, ins, "MUL_TRUNC WRONG DEGREE");
+            return true;
+        case OP_AT:
+            decodeParameters(in, c, ins, "AT WRONG VALUE");
+            return true;
+        case OP_POW:
+            decodeParameters(in, c, ins, "POW WRONG EXPONENT");
+            return true;
+        case OP_SAVE:
+            decodeParameters(in, c, ins, "SAVE WRONG FILE");
+            return true;
+        case OP_LOAD:
+            decodeParameters(in, c, ins, "LOAD WRONG FILE");
+            return true;
+        case OP_MAP:
+            decodeParameters(in, c, ins, "MAP WRONG FILE");
+            return true;
+        case OP_EXPORT:
+            decodeParameters(in, c, ins, "EXPORT WRONG FILE");
+            return true;
+        default:
+            if (!endLine) {
+                ins->op = OP_WRONG_COMMAND;
+            }
+            return endLine;
+    }
+}
+
+void freeInstruction(Instruction *ins) {
+    PolyDestroy(&ins->poly);
+    free(ins->path);
+    ins->path = NULL;
+}
+
+LineKind instructionKind(const Instruction *ins) {
+    return ((ins->op == OP_POLY) || (ins->op == OP_WRONG_POLY)) ? LINE_POLY : LINE_COMMAND;
+}
+
+const char *instructionName(const Instruction *ins) {
+    return opcodeNames[ins->op == OP_ERROR ? ins->command : ins->op].name;
+}
+
+Program newProgram(void) {
+    Program program;
+    program.count = 0;
+    program.length = INITIAL_LENGTH;
+    program.code = malloc(program.length * sizeof *program.code);
+    CheckReallocOutcome(program.code);
+    return program;
+}
+
+void freeProgram(Program *program) {
+    for (size_t i = 0; i < program->count; ++i) {
+        freeInstruction(&program->code[i]);
+    }
+    free(program->code);
+    program->code = NULL;
+    program->count = 0;
+    program->length = 0;
+}
+
+/**
+ * Sprawdza, czy instrukcja wstawia wielomian na stos niezależnie
+ * od jego stanu.
+ * @param[in] ins : instrukcja
+ * @return Czy instrukcja zawsze wstawia wielomian?
+ */
+static bool alwaysPushes(const Instruction *ins) {
+    return (ins->op == OP_POLY) || (ins->op == OP_ZERO);
+}
+
+/**
+ * Stosuje jedną regułę lokalną do końca programu. Reguły oglądają
+ * ostatnią instrukcję i co najwyżej WINDOW instrukcji przed nią.
+ * @param[in,out] code : instrukcje
+ * @param[in,out] count : liczba instrukcji
+ * @return Czy zastosowano regułę?
+ */
+static bool reduceTail(Instruction *code, size_t *count) {
+    size_t n = *count;
+    Instruction *last = &code[n - 1];
+    Instruction *prev = (n >= 2) ? &code[n - 2] : NULL;
+    if (prev == NULL) {
+        return false;
+    }
+    if ((last->op == OP_ADD) && (prev->op == OP_POLY) && (n >= 3) && (code[n - 3].op == OP_POLY)) {
+        code[n - 3].poly = PolyAddOwn(&code[n - 3].poly, &prev->poly);
+        *count = n - 2;
+        return true;
+    }
+    if ((last->op == OP_AT) && (prev->op == OP_POLY)) {
+        prev->poly = PolyAtOwn(&prev->poly, last->value);
+        *count = n - 1;
+        return true;
+    }
+    if ((last->op == OP_ADD) && (prev->op == OP_NEG)) {
+        prev->op = OP_RSUB;
+        prev->other = last->line;
+        *count = n - 1;
+        return true;
+    }
+    if ((last->op == OP_POP) && (prev->op == OP_CLONE)) {
+        prev->op = OP_CLONE_POP;
+        prev->other = last->line;
+        *count = n - 1;
+        return true;
+    }
+    if ((last->op == OP_CLONE_POP) && alwaysPushes(prev)) {
+        *count = n - 1;
+        return true;
+    }
+    return false;
+}
+
+void compileLine(Program *program, int line, const ParsedLine *parsed, Cursor *in) {
+    if (parsed->kind == LINE_EMPTY) {
+        return;
+    }
+    if (program->count == program->length) {
+        program->length = more(program->length);
+        program->code = realloc(program->code, program->length * sizeof *program->code);
+        CheckReallocOutcome(program->code);
+    }
+    Instruction *ins = &program->code[program->count++];
+    if (parsed->kind == LINE_COMMAND) {
+        decodeCommand(in, line, ins);
+    } else {
+        *ins = (Instruction) {.op = OP_WRONG_POLY, .command = OP_WRONG_POLY, .line = line,
+                              .other = line, .poly = PolyZero(), .number = 0, .degree = 0,
+                              .value = 0, .path = NULL, .message = NULL};
+        if (parsed->correct) {
+            ins->op = OP_POLY;
+            ins->poly = parsed->poly;
+        }
+    }
+    while (reduceTail(program->code, &program->count)) {
+    }
+}
+
+size_t settledInstructions(const Program *program) {
+    return (program->count > WINDOW) ? program->count - WINDOW : 0;
+}
+
+void removeInstructions(Program *program, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        freeInstruction(&program->code[i]);
+    }
+    program->count -= count;
+    memmove(program->code, program->code + count, program->count * sizeof *program->code);
+}
+
@@ -0,0 +1,169 @@
+/** @file
+  Interfejs kodu bajtowego poleceń kalkulatora.
+
+  Linia z poleceniem jest dekodowana do instrukcji: kodu operacji
+  z wczytanymi już parametrami (liczbą, stopniem, nazwą pliku).
+  Błędy parametrów nie zależą od stanu stosu, więc linia z błędnym
+  parametrem staje się instrukcją wypisującą komunikat o błędzie.
+  Tak samo wykonywane są pojedyncze linie w zwykłym trybie pracy.
+
+  W trybie @c -b kalkulator tłumaczy wejście na program, czyli ciąg
+  instrukcji, i poprawia jego koniec regułami lokalnymi po dopisaniu
+  każdej linii:
+  - dwa wielomiany z wejścia i @c ADD zastępuje ich sumą,
+  - wielomian z wejścia i @c AT zastępuje jego wartością,
+  - @c NEG i @c ADD zastępuje odejmowaniem odwrotnym (@c RSUB),
+  - @c CLONE i @c POP zastępuje sprawdzeniem, czy stos nie jest pusty,
+    a jeśli poprzednia instrukcja zawsze wstawia wielomian, usuwa je.
+
+  Reguły nie zmieniają wyników ani komunikatów o błędach: instrukcja
+  złożona pamięta numery obu linii i w razie braku wielomianów na stosie
+  zgłasza te same błędy co linie wykonane osobno. Reguły sięgają najwyżej
+  dwie instrukcje wstecz, więc starsze instrukcje są już ostateczne i mogą
+  zostać wykonane; wyniki pojawiają się z opóźnieniem dwóch instrukcji.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_BYTECODE_H
+#define POLYNOMIALS_BYTECODE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "input.h"
+#include "parser.h"
+#include "poly.h"
+
+/**
+ * To jest typ wyliczeniowy opisujący kod operacji instrukcji.
+ */
+typedef enum {
+    OP_POLY, ///< wstawienie wielomianu z wejścia
+    OP_WRONG_POLY, ///< błędny wielomian
+    OP_WRONG_COMMAND, ///< błędne polecenie
+    OP_ERROR, ///< polecenie z błędnym parametrem
+    OP_ZERO, ///< polecenie ZERO
+    OP_IS_COEFF, ///< polecenie IS_COEFF
+    OP_IS_ZERO, ///< polecenie IS_ZERO
+    OP_IS_EQ, ///< polecenie IS_EQ
+    OP_CLONE, ///< polecenie CLONE
+    OP_ADD, ///< polecenie ADD
+    OP_MUL, ///< polecenie MUL
+    OP_NEG, ///< polecenie NEG
+    OP_SUB, ///< polecenie SUB
+    OP_DEG, ///< polecenie DEG
+    OP_DEG_BY, ///< polecenie DEG_BY
+    OP_AT, ///< polecenie AT
+    OP_PRINT, ///< polecenie PRINT
+    OP_POP, ///< polecenie POP
+    OP_COMPOSE, ///< polecenie COMPOSE
+    OP_COMPOSE_TRUNC, ///< polecenie COMPOSE_TRUNC
+    OP_MUL_TRUNC, ///< polecenie MUL_TRUNC
+    OP_POW, ///< polecenie POW
+    OP_SAVE, ///< polecenie SAVE
+    OP_LOAD, ///< polecenie LOAD
+    OP_MAP, ///< polecenie MAP
+    OP_EXPORT, ///< polecenie EXPORT
+    OP_MEM, ///< polecenie MEM
+    OP_STATS, ///< polecenie STATS
+    OP_RSUB, ///< NEG i ADD: odejmuje wierzchołek od wielomianu pod nim
+    OP_CLONE_POP ///< CLONE i POP: sprawdza tylko, czy stos nie jest pusty
+} Opcode;
+
+/**
+ * To jest struktura reprezentująca instrukcję.
+ */
+typedef struct {
+    Opcode op; ///< kod operacji
+    Opcode command; ///< polecenie, którego dotyczy instrukcja OP_ERROR
+    int line; ///< numer linii
+    int other; ///< numer drugiej linii instrukcji złożonej
+    Poly poly; ///< wielomian instrukcji OP_POLY, własność instrukcji
+    unsigned long number; ///< liczba wielomianów lub indeks zmiennej
+    poly_exp_t degree; ///< stopień lub wykładnik
+    poly_coeff_t value; ///< punkt instrukcji OP_AT
+    char *path; ///< nazwa pliku lub NULL, własność instrukcji
+    const char *message; ///< komunikat instrukcji OP_ERROR
+} Instruction;
+
+/**
+ * Dekoduje polecenie z linii wejścia.
+ * @param[in,out] in : kursor na początku linii z poleceniem
+ * @param[in] line : numer linii
+ * @param[out] ins : instrukcja
+ * @return Czy nazwa polecenia jest poprawna? Jeśli nie, instrukcja
+ * ma kod OP_WRONG_COMMAND.
+ */
+bool decodeCommand(Cursor *in, int line, Instruction *ins);
+
+/**
+ * Usuwa z pamięci wielomian i nazwę pliku instrukcji.
+ * @param[in,out] ins : instrukcja
+ */
+void freeInstruction(Instruction *ins);
+
+/**
+ * Wyznacza rodzaj linii, którą opisuje instrukcja w statystykach
+ * i śladzie wykonania.
+ * @param[in] ins : instrukcja
+ * @return rodzaj linii
+ */
+LineKind instructionKind(const Instruction *ins);
+
+/**
+ * Wyznacza nazwę instrukcji w statystykach i śladzie wykonania.
+ * @param[in] ins : instrukcja
+ * @return nazwa polecenia, napis o statycznym czasie życia
+ */
+const char *instructionName(const Instruction *ins);
+
+/**
+ * To jest struktura reprezentująca program.
+ */
+typedef struct {
+    Instruction *code; ///< instrukcje
+    size_t count; ///< liczba instrukcji
+    size_t length; ///< rozmiar tablicy @p code
+} Program;
+
+/**
+ * Tworzy pusty program.
+ * @return program
+ */
+Program newProgram(void);
+
+/**
+ * Usuwa z pamięci program wraz z instrukcjami.
+ * @param[in,out] program : program
+ */
+void freeProgram(Program *program);
+
+/**
+ * Dopisuje do programu instrukcję przeanalizowanej linii wejścia
+ * i poprawia koniec programu regułami lokalnymi (zob. opis pliku).
+ * Linie puste są pomijane. Wielomian z linii przechodzi na własność
+ * programu.
+ * @param[in,out] program : program
+ * @param[in] line : numer linii
+ * @param[in] parsed : wynik analizy linii
+ * @param[in,out] in : kursor na początku linii
+ */
+void compileLine(Program *program, int line, const ParsedLine *parsed, Cursor *in);
+
+/**
+ * Wyznacza liczbę początkowych instrukcji programu, których żadna
+ * reguła lokalna już nie zmieni.
+ * @param[in] program : program
+ * @return liczba instrukcji gotowych do wykonania
+ */
+size_t settledInstructions(const Program *program);
+
+/**
+ * Usuwa z programu początkowe, już wykonane instrukcje.
+ * @param[in,out] program : program
+ * @param[in] count : liczba instrukcji, nie większa niż liczba instrukcji programu
+ */
+void removeInstructions(Program *program, size_t count);
+
+#endif //POLYNOMIALS_BYTECODE_H
@@ -4,472 +4,45 @@
   @date 2021
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "poly.h"
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <errno.h>
-#include <limits.h>
 #include <string.h>
-#include <ctype.h>
 #include "additional_functions.h"
+#include "input.h"
+#include "output.h"
+#include "parser.h"
+#include "batch.h"
+#include "bytecode.h"
+#include "dataflow.h"
+#include "report.h"
+#include "pipeline.h"
+#include "stack.h"
+#include "stats.h"
+#include "trace.h"
+#include "perf.h"
+#include "reclaim.h"
+#include "poly_trace.h"
+#include <unistd.h>
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
-#define ADD "ADD"
-#define ZERO "ZERO"
-#define IS_COEFF "IS_COEFF"
-#define IS_ZERO "IS_ZERO"
-#define CLONE "CLONE"
-#define MUL "MUL"
-#define NEG "NEG"
-#define SUB "SUB"
-#define IS_EQ "IS_EQ"
-#define DEG "DEG"
-#define DEG_BY "DEG_BY"
-#define AT "AT"
-#define PRINT "PRINT"
-#define POP "POP"
-#define COMPOSE "COMPOSE"
-
 #define INITIAL_LENGTH 8
-#define FIRST_NUMBER 48
-#define LAST_NUMBER 57
-#define FIRST_SMALL_LETTER 97
-#define LAST_SMALL_LETTER 122
-#define FIRST_BIG_LETTER 65
-#define LAST_BIG_LETTER 90
-
-#endif /* DOXYGEN_SHOULD_SKIP_THIS */
-
-/**
- * To jest struktura reprezentująca stos tablicowy.
- */
-typedef struct {
-    Poly *array; ///< tablica przechowywująca wartości ze stosu
-    size_t top; ///< indeks pierwszego wolnego miejsca na stosie
-    size_t length; ///< rozmiar stosu
-} Stack;
-
-/**
- * Tworzy nowy, pusty stos.
- * @return pusty stos
- */
-Stack newPolyStack(void) {
-    Stack stack;
-    stack.top = 0;
-    stack.length = INITIAL_LENGTH;
-    stack.array = malloc(stack.length * sizeof *stack.array);
-    return stack;
-}
-
-/**
- * Sprawdza, czy stos @f$stack@f$ jest pusty.
- * @param[in] stack : stos
- * @return Czy stos jest pusty?
- */
-bool emptyPoly(Stack *stack) {
-    return stack->top == 0;
-}
-
-/**
- * Daje wielomian z wierzchu stosu @f$stack@f$, nie zdejumując go.
- * @param[in] stack: stos
- * @return wielomian z góry stosu
- */
-Poly topPoly(Stack *stack) {
-    return stack->array[stack->top - 1];
-}
+#define MAX_THREADS 256
+#define MEGABYTE_SHIFT 20
 
-/**
- * Zdejmuje wielomian z wierzchu stosu @f$stack@f$ i zwraca go.
- * @param[in] stack: stos
- * @return wielomian z góry stosu
- */
-Poly popPoly(Stack *stack) {
-    --stack->top;
-    return stack->array[stack->top];
-}
-
-/**
- * Usuwa stos @f$stack@f$ z pamięci.
- * @param[in] stack : stos
- */
-void freeStack(Stack *stack) {
-    while (!emptyPoly(stack)) {
-        Poly p = popPoly(stack);
-        PolyDestroy(&p);
-    }
-    stack->length = 0;
-    free(stack->array);
-}
-
-/**
- * Wkłada wielomain @f$poly@f$ na stos @f$stack@f$.
- * @param[in,out] stack : stos
- * @param[in] poly : wielomian @f$q@f$
- */
-void pushPoly(Stack *stack, Poly poly) {
-    if (stack->top == stack->length) {
-        stack->length = more(stack->length);
-        stack->array = realloc(stack->array, stack->length * sizeof *stack->array);
-        CheckReallocOutcome(stack->array);
-    }
-    stack->array[stack->top] = poly;
-    ++stack->top;
-}
-
-/**
- * Wczytuje znaki z wejścia, dopóki nie wczyta znaku końca linii.
- */
-static void readRestOfLine(void) {
-    int c = getchar();
-    while ((c != EOF) && (c != '\n')) {
-        c = getchar();
-    }
-}
-
-/**
- * Zwraca wartość true, jeśli na zmiennej @f$c@f$ zapisana jest mała lub wielka litera alfabetu angielskiego.
- * Zwraca wartość false w przeciwnym przypadku.
- * @param[in] c : znak
- * @return Czy @c to litera?
- */
-static bool isLetter(int c) {
-    if (((c <= LAST_BIG_LETTER) && (c >= FIRST_BIG_LETTER)) ||
-        ((c >= FIRST_SMALL_LETTER) && (c <= LAST_SMALL_LETTER))) {
-        return true;
-    } else {
-        return false;
-    }
-}
-
-/**
- * Wczytuje z wejścia znaki i konwertuje je do postaci liczby typu poly_coeff_t.
- * Jeśli wczyta niedozwolony znak
- * lub nastąpi przekroczenie zakresu typu poly_coeff_t,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] number : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
- * @return wczytana wartość
- */
-static poly_coeff_t readCoeff(bool *correct, char **number, size_t *length) {
-    int c = getchar();
-    size_t i = 0;
-    if (c == '-') {
-        lengthenIfNecessary(number, length, i);
-        (*number)[i] = c;
-        c = getchar();
-        ++i;
-    }
-    while ((c != EOF) && (c != ',') && (c != '\n') && *correct) {
-        if ((c >= FIRST_NUMBER) && (c <= LAST_NUMBER)) {
-            lengthenIfNecessary(number, length, i);
-            (*number)[i] = c;
-            ++i;
-            c = getchar();
-        } else {
-            *correct = false;
-        }
-    }
-    if (i == 0) {
-        *correct = false;
-    }
-    lengthenIfNecessary(number, length, i);
-    ungetc(c, stdin);
-    (*number)[i] = '\0';
-    lengthenIfNecessary(number, length, i);
-    (*number)[i] = '#';
-    char *pointer = NULL;
-    errno = 0;
-    poly_coeff_t res = strtol(*number, &pointer, 10);
-    if (errno != 0) {
-        *correct = false;
-    }
-    return res;
-}
-
-/**
- * Wczytuje ze standardowego wejścia znaki i konwertuje je do postaci liczby typu unsigned long.
- * Jeśli wczyta niedozwolony znak
- * lub nastąpi przekroczenie zakresu typu unsigned long,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] number : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
- * @return wczytana wartość
- */
-static unsigned long readUnsignedLong(bool *correct, char **number, size_t *length) {
-    int c = getchar();
-    size_t i = 0;
-    if (c == '-') {
-        *correct = false;
-    }
-    while ((c != EOF) && (c != ',') && (c != '\n') && *correct) {
-        if ((c >= FIRST_NUMBER) && (c <= LAST_NUMBER)) {
-            lengthenIfNecessary(number, length, i);
-            (*number)[i] = c;
-            ++i;
-            c = getchar();
-        } else {
-            *correct = false;
-        }
-    }
-    if (i == 0) {
-        *correct = false;
-    }
-    lengthenIfNecessary(number, length, i);
-    ungetc(c, stdin);
-    (*number)[i] = '\0';
-    lengthenIfNecessary(number, length, i);
-    (*number)[i] = '#';
-    char *pointer = NULL;
-    errno = 0;
-    unsigned long res = strtoul(*number, &pointer, 10);
-    if (errno != 0) {
-        *correct = false;
-    }
-    return res;
-}
-
-/**
- * Wczytuje ze standardowego wejścia znaki i konwertuje je do postaci liczby typu poly_exp_t.
- * Jeśli wczyta niedozwolony znak
- * lub nastąpi przekroczenie zakresu typu unsigned long,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] number : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
- * @return wczytana wartość
- */
-static poly_exp_t readExp(bool *correct, char **number, size_t *length) {
-    int c = getchar();
-    size_t i = 0;
-    while ((c != EOF) && (c != ')') && (c != '\n') && *correct) {
-        if ((c >= FIRST_NUMBER) && (c <= LAST_NUMBER)) {
-            lengthenIfNecessary(number, length, i);
-            (*number)[i] = c;
-            ++i;
-            c = getchar();
-        } else {
-            ungetc(c, stdin);
-            *correct = false;
-            return 0;
-        }
-    }
-    ungetc(c, stdin);
-    if (i == 0) {
-        *correct = false;
-        return 0;
-    }
-    lengthenIfNecessary(number, length, i);
-    (*number)[i] = '\0';
-    lengthenIfNecessary(number, length, i);
-    (*number)[i] = '#';
-    char *pointer = NULL;
-    long long help = strtol(*number, &pointer, 10);
-    if ((help > INT_MAX) || (help < 0)) {
-        *correct = false;
-        return 0;
-    }
-    poly_exp_t res = (poly_exp_t) help;
-    return res;
-}
-
-static Poly readPoly(bool *correct, char **buffer, size_t *bufferLength);
-
-/**
- * Tworzy jednomian na podstawie znaków, wczytanych ze standardowego wejścia.
- * Jeśli wczyta niedozwolony znak,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] buffer : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
- * @return wczytany jednomian
- */
-static Mono readMono(bool *correct, char **buffer, size_t *length) {
-    int a = getchar();
-    if (a == '-') {
-        a = getchar();
-        if (a == '\n') {
-            *correct = false;
-            ungetc(a, stdin);
-        }
-        if ((a >= FIRST_NUMBER) && (a <= LAST_NUMBER)) {
-            ungetc(a, stdin);
-            poly_coeff_t coeff = readCoeff(correct, buffer, length);
-            a = getchar();
-            if (a != '\n') {
-                *correct = false;
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            ungetc(a, stdin);
-            Poly res = PolyFromCoeff(-1 * coeff);
-            return MonoFromPoly(&res, 0);
-        } else {
-            *correct = false;
-            Poly res = PolyZero();
-            return MonoFromPoly(&res, 0);
-        }
-    } else if ((a >= FIRST_NUMBER) && (a <= LAST_NUMBER)) {
-        ungetc(a, stdin);
-        poly_coeff_t coeff = readCoeff(correct, buffer, length);
-        a = getchar();
-        if (a != '\n') {
-            *correct = false;
-            Poly res = PolyZero();
-            return MonoFromPoly(&res, 0);
-        }
-        ungetc(a, stdin);
-        Poly res = PolyFromCoeff(coeff);
-        return MonoFromPoly(&res, 0);
-    } else if (a == '(') {
-        a = getchar();
-        if (a == '\n') {
-            ungetc(a, stdin);
-        }
-        if (((a >= FIRST_NUMBER) && (a <= LAST_NUMBER)) || (a == '-')) {
-            ungetc(a, stdin);
-            poly_coeff_t coeff = readCoeff(correct, buffer, length);
-            a = getchar();
-            if (a == '\n') {
-                ungetc(a, stdin);
-            }
-            if (a != ',') {
-                *correct = false;
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            poly_exp_t exp = readExp(correct, buffer, length);
-            a = getchar();
-            if (a == '\n') {
-                ungetc(a, stdin);
-            }
-            if (a != ')') {
-                *correct = false;
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            if (coeff == 0) {
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            if (exp == 0) {
-                Poly res = PolyFromCoeff(coeff);
-                return MonoFromPoly(&res, 0);
-            }
-            Poly p = PolyFromCoeff(coeff);
-            return MonoFromPoly(&p, exp);
-        } else {
-            if (a != '(') {
-                *correct = false;
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            ungetc(a, stdin);
-            Poly coeff = readPoly(correct, buffer, length);
-            if (!*correct) {
-                PolyDestroy(&coeff);
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            a = getchar();
-            if (a == '\n') {
-                ungetc(a, stdin);
-            }
-            if (a != ',') {
-                PolyDestroy(&coeff);
-                *correct = false;
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            poly_exp_t exp = readExp(correct, buffer, length);
-            a = getchar();
-            if (a == '\n') {
-                ungetc(a, stdin);
-            }
-            if (a != ')') {
-                *correct = false;
-                PolyDestroy(&coeff);
-                Poly res = PolyZero();
-                return MonoFromPoly(&res, 0);
-            }
-            if (PolyIsZero(&coeff)) {
-                return MonoFromPoly(&coeff, 0);
-            }
-            return MonoFromPoly(&coeff, exp);
-        }
-    } else {
-        if (a == '\n') {
-            ungetc(a, stdin);
-        }
-        *correct = false;
-        Poly res = PolyZero();
-        return MonoFromPoly(&res, 0);
-    }
-}
+#ifdef POLY_STATS
+#define OPTIONS "j:pbw:m:t:cds"
+#define USAGE "Usage: %s [-j threads | -p | -b | -w threads] [-m megabytes] [-t trace] [-c] [-d] [-s]\n"
+#else
+#define OPTIONS "j:pbw:m:t:cd"
+#define USAGE "Usage: %s [-j threads | -p | -b | -w threads] [-m megabytes] [-t trace] [-c] [-d]\n"
+#endif
 
-/**
- * Tworzy wielomian na podstawie znaków wczytanych ze standarowego wejścia.
- * Jeśli wczyta niedozwolony znak,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] buffer : bufor do wczytywania znaków z wejścia
- * @param[in] bufferLength : długość buffera
- * @return wczytany wielomian
- */
-static Poly readPoly(bool *correct, char **buffer, size_t *bufferLength) {
-    if (!*correct) {
-        return PolyZero();
-    }
-    Mono m1 = readMono(correct, buffer, bufferLength);
-    int c = getchar();
-    if (c == '\n') {
-        ungetc(c, stdin);
-    }
-    if (*correct == false) {
-        MonoDestroy(&m1);
-        return PolyZero();
-    }
-    size_t length = 1024;
-    Mono *arr = malloc(length * sizeof *arr);
-    size_t i = 0;
-    arr[i] = m1;
-    ++i;
-    while ((c != EOF) && (c == '+')) {
-        Mono m2 = readMono(correct, buffer, bufferLength);
-        if (!*correct) {
-            for (size_t k = 0; k < i; ++k) {
-                MonoDestroy(&arr[k]);
-            }
-            free(arr);
-            return PolyZero();
-        }
-        LengthenArrayIfNecessary(&arr, &length, i);
-        arr[i] = m2;
-        ++i;
-        c = getchar();
-        if (c == '\n') {
-            ungetc(c, stdin);
-        }
-    }
-    if (c == ',') {
-        ungetc(c, stdin);
-    }
-    if ((c != '\n') && (c != ',')) {
-        *correct = false;
-    }
-    Poly res;
-    if ((i == 1) && (arr[0].exp == 0) && (arr[0].p.arr == NULL)) {
-        res = arr[0].p;
-    } else {
-        res = PolyAddMonos(i, arr);
-    }
-    free(arr);
-    return res;
-}
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
 
 /**
  * Dodaje dwa wielomiany z wierzchu stosu, usuwa je
@@ -483,12 +56,20 @@ static bool add(Stack *s) {
     if (s->top < 2) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly q = popPoly(s);
-    Poly res = PolyAdd(&p, &q);
-    PolyDestroy(&p);
-    PolyDestroy(&q);
-    pushPoly(s, res);
+    StackEntry p = popEntry(s);
+    StackEntry q = popEntry(s);
+    ownEntry(&p);
+    ownEntry(&q);
+    if (p.mult == q.mult) {
+        p.poly = PolyAddOwn(&p.poly, &q.poly);
+    } else if (p.mult == -q.mult) {
+        p.poly = PolyAddScaledOwn(&p.poly, &q.poly, -1);
+    } else {
+        materialize(&p);
+        materialize(&q);
+        p.poly = PolyAddOwn(&p.poly, &q.poly);
+    }
+    pushEntry(s, p);
     return true;
 }
 
@@ -498,20 +79,21 @@ static bool add(Stack *s) {
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
  * @return Czy udało się wykonać polecenie?
  */
-static bool isCoeff(Stack *s) {
+static bool isCoeff(Stack *s, Reporter *rep) {
     if (emptyPoly(s)) {
         return false;
     }
     Poly p = topPoly(s);
     if (PolyIsCoeff(&p)) {
-        printf("%d\n", true);
+        reportNumber(rep, true);
     } else {
         if (PolyIsConst(&p)) {
-            printf("%d\n", true);
+            reportNumber(rep, true);
         } else {
-            printf("%d\n", false);
+            reportNumber(rep, false);
         }
     }
     return true;
@@ -523,17 +105,18 @@ static bool isCoeff(Stack *s) {
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
  * @return Czy udało się wykonać polecenie?
  */
-static bool isZero(Stack *s) {
+static bool isZero(Stack *s, Reporter *rep) {
     if (emptyPoly(s)) {
         return false;
     }
     Poly p = topPoly(s);
     if (PolyIsZero(&p)) {
-        printf("%d\n", true);
+        reportNumber(rep, true);
     } else {
-        printf("%d\n", false);
+        reportNumber(rep, false);
     }
     return true;
 }
@@ -549,9 +132,15 @@ static bool clone(Stack *s) {
     if (emptyPoly(s)) {
         return false;
     }
-    Poly p = topPoly(s);
-    Poly q = PolyClone(&p);
-    pushPoly(s, q);
+    StackEntry e = *topEntry(s);
+    if (e.map != NULL) {
+        PolyMapRetain(e.map);
+    } else if (e.compact) {
+        e.poly = PolyCompact(&e.poly);
+    } else {
+        e.poly = PolyClone(&e.poly);
+    }
+    pushEntry(s, e);
     return true;
 }
 
@@ -567,12 +156,18 @@ static bool mul(Stack *s) {
     if (s->top < 2) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly q = popPoly(s);
-    Poly res = PolyMul(&p, &q);
-    PolyDestroy(&p);
-    PolyDestroy(&q);
-    pushPoly(s, res);
+    StackEntry p = popEntry(s);
+    StackEntry q = popEntry(s);
+    if (isReadOnly(&p) || isReadOnly(&q)) {
+        Poly res = PolyMul(&p.poly, &q.poly);
+        dropEntry(&p);
+        dropEntry(&q);
+        p.poly = res;
+    } else {
+        p.poly = PolyMulOwn(&p.poly, &q.poly);
+    }
+    p.mult *= q.mult;
+    pushEntry(s, p);
     return true;
 }
 
@@ -588,17 +183,56 @@ static bool sub(Stack *s) {
     if (s->top < 2) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly q = popPoly(s);
-    Poly res = PolySub(&p, &q);
-    PolyDestroy(&p);
-    PolyDestroy(&q);
-    pushPoly(s, res);
+    StackEntry p = popEntry(s);
+    StackEntry q = popEntry(s);
+    ownEntry(&p);
+    ownEntry(&q);
+    if (p.mult == q.mult) {
+        p.poly = PolySubOwn(&p.poly, &q.poly);
+    } else if (p.mult == -q.mult) {
+        p.poly = PolyAddOwn(&p.poly, &q.poly);
+    } else {
+        materialize(&p);
+        materialize(&q);
+        p.poly = PolySubOwn(&p.poly, &q.poly);
+    }
+    pushEntry(s, p);
+    return true;
+}
+
+/**
+ * Odejmuje wielomian z wierzchołka od wielomianu pod wierzchołkiem,
+ * usuwa je i wstawia na wierzchołek stosu różnicę. Daje ten sam wynik
+ * co polecenia NEG i ADD, ale liczy go jednym odejmowaniem.
+ * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
+ * aby wykonać polecenie.
+ * @param[in,out] s : stos
+ * @return Czy udało się wykonać polecenie?
+ */
+static bool rsub(Stack *s) {
+    if (s->top < 2) {
+        return false;
+    }
+    StackEntry p = popEntry(s);
+    StackEntry q = popEntry(s);
+    ownEntry(&p);
+    ownEntry(&q);
+    if (q.mult == p.mult) {
+        q.poly = PolySubOwn(&q.poly, &p.poly);
+    } else if (q.mult == -p.mult) {
+        q.poly = PolyAddOwn(&q.poly, &p.poly);
+    } else {
+        materialize(&q);
+        materialize(&p);
+        q.poly = PolySubOwn(&q.poly, &p.poly);
+    }
+    pushEntry(s, q);
     return true;
 }
 
 /**
  * Neguje wielomian na wierzchołku stosu.
+ * Zmienia jedynie odroczony mnożnik, nie przechodząc po wielomianie.
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in,out] s : stos
@@ -608,10 +242,8 @@ static bool neg(Stack *s) {
     if (emptyPoly(s)) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly q = PolyNeg(&p);
-    PolyDestroy(&p);
-    pushPoly(s, q);
+    StackEntry *e = topEntry(s);
+    e->mult = -e->mult;
     return true;
 }
 
@@ -621,19 +253,23 @@ static bool neg(Stack *s) {
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
  * @return Czy udało się wykonać polecenie?
  */
-static bool isEq(Stack *s) {
+static bool isEq(Stack *s, Reporter *rep) {
     if (s->top < 2) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly q = topPoly(s);
-    pushPoly(s, p);
-    if (PolyIsEq(&p, &q)) {
-        printf("%d\n", true);
+    StackEntry *p = peekEntry(s, 0);
+    StackEntry *q = peekEntry(s, 1);
+    if (p->mult != q->mult) {
+        materialize(p);
+        materialize(q);
+    }
+    if (PolyIsEq(&p->poly, &q->poly)) {
+        reportNumber(rep, true);
     } else {
-        printf("%d\n", false);
+        reportNumber(rep, false);
     }
     return true;
 }
@@ -644,34 +280,34 @@ static bool isEq(Stack *s) {
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
  * @return Czy udało się wykonać polecenie?
  */
-static bool deg(Stack *s) {
+static bool deg(Stack *s, Reporter *rep) {
     if (emptyPoly(s)) {
         return false;
     }
     Poly p = topPoly(s);
     poly_exp_t exp = PolyDeg(&p);
-    printf("%d\n", exp);
+    reportNumber(rep, exp);
     return true;
 }
 
-static void PrintPoly(const Poly *p);
 
 /**
  * Wypisuje na standardowe wyjście wielomian z wierzchołka stosu.
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
  * @return Czy udało się wykonać polecenie?
  */
-static bool print(Stack *s) {
+static bool print(Stack *s, Reporter *rep) {
     if (emptyPoly(s)) {
         return false;
     }
-    Poly p = topPoly(s);
-    PrintPoly(&p);
-    printf("\n");
+    StackEntry *e = topEntry(s);
+    reportPoly(rep, &e->poly, e->mult);
     return true;
 }
 
@@ -686,49 +322,31 @@ static bool pop(Stack *s) {
     if (emptyPoly(s)) {
         return false;
     }
-    Poly p = popPoly(s);
-    PolyDestroy(&p);
+    discardTop(s);
     return true;
 }
 
 /**
- * Wczytuje ze standardowego wejścia wartość @f$idx@f$.
- * Jeśli wczyta niedozwolony znak,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
  * Wypisuje na standardowe wyjście stopień wielomianu ze względu na zmienną o numerze @f$idx@f$.
  * Wypisuje −1 dla wielomianu tożsamościowo równego zeru.
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in,out] s : stos
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] buffer : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] idx : numer zmiennej
  * @return Czy udało się wykonać polecenie?
  */
-static bool degBy(Stack *s, bool *correct, char **buffer, size_t *length) {
-    unsigned long idx = readUnsignedLong(correct, buffer, length);
-    if (!*correct) {
-        return true;
-    }
-    int a = getchar();
-    if ((a != EOF) && (a != '\n')) {
-        *correct = false;
-        return false;
-    }
-    ungetc(a, stdin);
+static bool degBy(Stack *s, Reporter *rep, unsigned long idx) {
     if (emptyPoly(s)) {
         return false;
     }
     Poly p = topPoly(s);
     poly_exp_t degBy = PolyDegBy(&p, idx);
-    printf("%d\n", degBy);
+    reportNumber(rep, degBy);
     return true;
 }
 
 /**
- * Wczytuje ze standardowego wejścia wartość @f$k@f$.
- * Jeśli wczyta niedozwolony znak,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
  * Funkcja zdejmuje ze stosu najpierw wielomian @f$p@f$.
  * Następnie zdejumuje ze stosu kolejno @f$q[k - 1], q[k - 2],\ldots, q[0]@f$.
  * Umieszcza na stosie wynik operacji złożenia.
@@ -738,76 +356,223 @@ static bool degBy(Stack *s, bool *correct, char **buffer, size_t *length) {
  * @f$l@f$ oznacza liczbę zmiennych wielomianu @f$p@f$.
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów, aby wykonać polecenie.
  * @param[in,out] s : stos
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] buffer : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość bufora
+ * @param[in] k : liczba podstawianych wielomianów
  * @return Czy udało się wykonać polecenie?
  */
-static bool compose(Stack *s, bool *correct, char **buffer, size_t *length) {
-    unsigned long k = readUnsignedLong(correct, buffer, length);
-    if (!*correct) {
-        return true;
-    }
-    int a = getchar();
-    if ((a != EOF) && (a != '\n')) {
-        *correct = false;
+static bool compose(Stack *s, unsigned long k) {
+    if (emptyPoly(s) || (s->top - 1 < k)) {
         return false;
     }
-    ungetc(a, stdin);
-    if (s->top - 1 < k) {
+    StackEntry p = popEntry(s);
+    Poly *q = malloc(k * sizeof *q);
+    size_t i = k;
+    while (i > 0) {
+        q[i - 1] = popPoly(s);
+        --i;
+    }
+    if (isReadOnly(&p)) {
+        Poly res = PolyCompose(&p.poly, k, q);
+        dropEntry(&p);
+        for (i = 0; i < k; ++i) {
+            PolyDestroy(&q[i]);
+        }
+        p.poly = res;
+    } else {
+        p.poly = PolyComposeOwn(&p.poly, k, q);
+    }
+    pushEntry(s, p);
+    free(q);
+    return true;
+}
+
+/**
+ * Działa jak polecenie COMPOSE, ale w wyniku zachowuje tylko jednomiany
+ * stopnia co najwyżej @f$d@f$.
+ * Zwraca wartość false, jeśli na stosie jest za mało wielomianów, aby wykonać polecenie.
+ * @param[in,out] s : stos
+ * @param[in] k : liczba podstawianych wielomianów
+ * @param[in] d : stopień
+ * @return Czy udało się wykonać polecenie?
+ */
+static bool composeTrunc(Stack *s, unsigned long k, poly_exp_t d) {
+    if (emptyPoly(s) || (s->top - 1 < k)) {
         return false;
     }
-    Poly p = popPoly(s);
+    StackEntry p = popEntry(s);
     Poly *q = malloc(k * sizeof *q);
     size_t i = k;
     while (i > 0) {
         q[i - 1] = popPoly(s);
         --i;
     }
-    Poly res = PolyCompose(&p, k, q);
-    pushPoly(s, res);
-    PolyDestroy(&p);
-    for (size_t j = 0; j < k; ++j) {
-        PolyDestroy(&q[j]);
+    Poly res = PolyComposeTrunc(&p.poly, k, q, d);
+    dropEntry(&p);
+    for (i = 0; i < k; ++i) {
+        PolyDestroy(&q[i]);
     }
     free(q);
+    p.poly = res;
+    pushEntry(s, p);
+    return true;
+}
+
+/**
+ * Mnoży dwa wielomiany z wierzchu stosu, zachowując tylko jednomiany
+ * stopnia co najwyżej @f$d@f$, usuwa je i wstawia na wierzchołek stosu iloczyn.
+ * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
+ * aby wykonać polecenie.
+ * @param[in,out] s : stos
+ * @param[in] d : stopień
+ * @return Czy udało się wykonać polecenie?
+ */
+static bool mulTrunc(Stack *s, poly_exp_t d) {
+    if (s->top < 2) {
+        return false;
+    }
+    StackEntry p = popEntry(s);
+    StackEntry q = popEntry(s);
+    Poly res = PolyMulTrunc(&p.poly, &q.poly, d);
+    dropEntry(&p);
+    dropEntry(&q);
+    p.poly = res;
+    p.mult *= q.mult;
+    pushEntry(s, p);
     return true;
 }
 
 /**
- * Wczytuje ze standardowego wejścia wartość @f$x@f$.
- * Jeśli wczyta niedozwolony znak,
- * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
  * Wylicza wartość wielomianu w punkcie @f$x@f$, usuwa wielomian z wierzchołka i wstawia na stos wynik operacji.
  * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
  * aby wykonać polecenie.
  * @param[in,out] s : stos
- * @param[in,out] correct : wskaźnik na zmienną typu bool
- * @param[in] buffer : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość bufora
+ * @param[in] x : punkt
+ * @return Czy udało się wykonać polecenie?
+ */
+static bool at(Stack *s, poly_coeff_t x) {
+    if (emptyPoly(s)) {
+        return false;
+    }
+    StackEntry *e = topEntry(s);
+    if (isReadOnly(e)) {
+        Poly res = PolyAt(&e->poly, x);
+        dropEntry(e);
+        e->poly = res;
+    } else {
+        e->poly = PolyAtOwn(&e->poly, x);
+    }
+    return true;
+}
+
+/**
+ * Podnosi wielomian z wierzchołka stosu do potęgi @f$e@f$, usuwa go
+ * i wstawia na stos wynik operacji.
+ * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
+ * aby wykonać polecenie.
+ * @param[in,out] s : stos
+ * @param[in] exponent : wykładnik
  * @return Czy udało się wykonać polecenie?
  */
-static bool at(Stack *s, bool *correct, char **buffer, size_t *length) {
-    poly_coeff_t x = readCoeff(correct, buffer, length);
-    if (!*correct) {
-        return true;
+static bool power(Stack *s, poly_exp_t exponent) {
+    if (emptyPoly(s)) {
+        return false;
+    }
+    StackEntry *e = topEntry(s);
+    if ((e->mult != 1) && (e->mult != -1)) {
+        materialize(e);
     }
-    int c = getchar();
-    if ((c != EOF) && (c != '\n')) {
-        *correct = false;
+    Poly res = PolyPow(&e->poly, exponent);
+    dropEntry(e);
+    e->poly = res;
+    if (exponent % 2 == 0) {
+        e->mult = 1;
+    }
+    return true;
+}
+
+/**
+ * Wkłada na stos wielomian zmapowany z pliku zapisanego przez polecenie
+ * EXPORT, bez kopiowania go.
+ * @param[in,out] s : stos
+ * @param[in] path : nazwa pliku
+ * @return Czy udało się zmapować plik?
+ */
+static bool mapFile(Stack *s, const char *path) {
+    PolyMap *map = PolyMapOpen(path);
+    if (map == NULL) {
         return false;
     }
-    ungetc(c, stdin);
+    pushEntry(s, (StackEntry) {.poly = map->root, .mult = 1, .map = map});
+    return true;
+}
+
+/**
+ * Zapisuje do pliku wielomian z wierzchołka stosu tak, żeby można go było
+ * zmapować poleceniem MAP.
+ * Jeśli nie udało się zapisać pliku,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * Zwraca wartość false, jeśli na stosie jest za mało wielomianów,
+ * aby wykonać polecenie.
+ * @param[in] s : stos
+ * @param[in] path : nazwa pliku
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return Czy udało się wykonać polecenie?
+ */
+static bool exportTop(Stack *s, const char *path, bool *correct) {
     if (emptyPoly(s)) {
         return false;
     }
-    Poly p = popPoly(s);
-    Poly res = PolyAt(&p, x);
-    PolyDestroy(&p);
-    pushPoly(s, res);
+    StackEntry *e = topEntry(s);
+    if (e->mult == 1) {
+        *correct = PolyMapExport(&e->poly, path);
+    } else {
+        Poly p = PolyClone(&e->poly);
+        p = PolyScaleOwn(&p, e->mult);
+        *correct = PolyMapExport(&p, path);
+        PolyDestroy(&p);
+    }
     return true;
 }
 
+/**
+ * Wypisuje linię opisu pamięci (zob. PolyMemory).
+ * @param[in,out] out : strumień
+ * @param[in] memory : pamięć
+ */
+static void printMemory(FILE *out, const PolyMemory *memory) {
+    fprintf(out, " BYTES %zu WASTED %zu ARRAYS %zu MONOS %zu\n", memory->bytes,
+            memory->wasted, memory->arrays, memory->monos);
+}
+
+/**
+ * Wypisuje pamięć zajmowaną przez wielomian z wierzchołka stosu
+ * (jeśli stos nie jest pusty) i przez wszystkie wielomiany na stosie
+ * (zob. entryMemoryUsage). Nie zmienia stosu.
+ * @param[in] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ */
+static void mem(Stack *s, Reporter *rep) {
+    char *text;
+    size_t size;
+    FILE *out = open_memstream(&text, &size);
+    CheckReallocOutcome(out);
+    PolyMemory total = {.bytes = 0, .wasted = 0, .arrays = 0, .monos = 0};
+    for (size_t i = 0; i < s->top; ++i) {
+        PolyMemory memory = entryMemoryUsage(&s->array[i]);
+        if (i + 1 == s->top) {
+            fputs("TOP", out);
+            printMemory(out, &memory);
+        }
+        total.bytes += memory.bytes;
+        total.wasted += memory.wasted;
+        total.arrays += memory.arrays;
+        total.monos += memory.monos;
+    }
+    fprintf(out, "STACK ENTRIES %zu", s->top);
+    printMemory(out, &total);
+    fclose(out);
+    reportText(rep, text);
+}
+
 /**
  * Wstawia na wierzchołek stosu wielomian tożsamościowo równy zeru.
  * @param[in] s : stos
@@ -818,277 +583,530 @@ static void zero(Stack *s) {
 }
 
 /**
- * Wczytuje ze standardowego wejścia polecenie i je wykonuje.
- * Jeśli wykryje niepoprawną nazwę polecenia zwraca wartość false.
+ * Zgłasza brak wielomianów na stosie potrzebnych do wykonania polecenia.
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] line : numer linii z poleceniem
+ */
+static void underflow(Reporter *rep, int line) {
+    reportError(rep, line, "STACK UNDERFLOW");
+}
+
+/**
+ * Wykonuje instrukcję (zob. bytecode.h) i wypisuje komunikaty o błędach.
+ * Wielomian instrukcji OP_POLY przechodzi na stos.
  * @param[in,out] s : stos
- * @param[in] line : numer lini, w której znajduje się dane polecenie
- * @param[in] read : bufor do wczytywania znaków z wejścia
- * @param[in] length : długość buffera
- * @return Czy udało się wczytać poprawne polecenie?
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in,out] ins : instrukcja
  */
-static bool readCommand(Stack *s, int line, char **read, size_t *length) {
-    int i = 0;
-    int c = getchar();
-    while ((c != EOF) && (c != '\n') && (!isspace(c))) {
-        if (!isLetter(c) && (c != '_')) {
-            return false;
-        }
-        lengthenIfNecessary(read, length, i);
-        (*read)[i] = c;
-        ++i;
-        c = getchar();
-    }
-    bool EndLine = false;
-    if ((c == EOF) || (c == '\n')) {
-        EndLine = true;
-    }
-    if (EndLine) {
-        ungetc(c, stdin);
-    }
-    lengthenIfNecessary(read, length, i);
-    (*read)[i] = '\0';
-    ++i;
-    switch ((*read)[0]) {
-        case 'Z':
-            if (!EndLine) {
-                return false;
-            }
-            if (strncmp(ZERO, *read, i) == 0) {
-                zero(s);
-            } else {
-                return false;
-            }
+static void executeInstruction(Stack *s, Reporter *rep, Instruction *ins) {
+    int line = ins->line;
+    bool noUnderflow = true;
+    bool correct = true;
+    switch (ins->op) {
+        case OP_POLY:
+            pushPoly(s, ins->poly);
+            ins->poly = PolyZero();
             break;
-        case 'I':
-            if (!EndLine) {
-                return false;
-            }
-            if (strncmp(IS_COEFF, *read, i) == 0) {
-                if (!isCoeff(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(IS_ZERO, *read, i) == 0) {
-                if (!isZero(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(IS_EQ, *read, i) == 0) {
-                if (!isEq(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
-            }
+        case OP_WRONG_POLY:
+            reportError(rep, line, "WRONG POLY");
             break;
-        case 'C':
-            if (strncmp(COMPOSE, *read, i) == 0) {
-                if (c != ' ') {
-                    fprintf(stderr, "ERROR %d COMPOSE WRONG PARAMETER\n", line);
-                    return true;
-                }
-                bool correct = true;
-                bool noUnderflow = compose(s, &correct, read, length);
-                if (!correct) {
-                    fprintf(stderr, "ERROR %d COMPOSE WRONG PARAMETER\n", line);
-                } else if (!noUnderflow) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(CLONE, *read, i) == 0) {
-                if (!EndLine) {
-                    return false;
-                }
-                if (!clone(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
-            }
+        case OP_WRONG_COMMAND:
+            reportError(rep, line, "WRONG COMMAND");
             break;
-        case 'A':
-            if (strncmp(ADD, *read, i) == 0) {
-                if (!EndLine) {
-                    return false;
-                }
-                if (!add(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(AT, *read, i) == 0) {
-                if (c != ' ') {
-                    fprintf(stderr, "ERROR %d AT WRONG VALUE\n", line);
-                    return true;
-                }
-                bool correct = true;
-                bool noUnderflow = at(s, &correct, read, length);
-                if (!correct) {
-                    fprintf(stderr, "ERROR %d AT WRONG VALUE\n", line);
-                } else if (!noUnderflow) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
-            }
+        case OP_ERROR:
+            reportError(rep, line, ins->message);
             break;
-        case 'M':
-            if (!EndLine) {
-                return false;
-            }
-            if (strncmp(MUL, *read, i) == 0) {
-                if (!mul(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
+        case OP_ZERO:
+            zero(s);
+            break;
+        case OP_IS_COEFF:
+            noUnderflow = isCoeff(s, rep);
+            break;
+        case OP_IS_ZERO:
+            noUnderflow = isZero(s, rep);
+            break;
+        case OP_IS_EQ:
+            noUnderflow = isEq(s, rep);
+            break;
+        case OP_CLONE:
+            noUnderflow = clone(s);
+            break;
+        case OP_ADD:
+            noUnderflow = add(s);
+            break;
+        case OP_MUL:
+            noUnderflow = mul(s);
+            break;
+        case OP_NEG:
+            noUnderflow = neg(s);
+            break;
+        case OP_SUB:
+            noUnderflow = sub(s);
+            break;
+        case OP_DEG:
+            noUnderflow = deg(s, rep);
+            break;
+        case OP_DEG_BY:
+            noUnderflow = degBy(s, rep, ins->number);
+            break;
+        case OP_AT:
+            noUnderflow = at(s, ins->value);
+            break;
+        case OP_PRINT:
+            noUnderflow = print(s, rep);
+            break;
+        case OP_POP:
+            noUnderflow = pop(s);
+            break;
+        case OP_COMPOSE:
+            noUnderflow = compose(s, ins->number);
+            break;
+        case OP_COMPOSE_TRUNC:
+            noUnderflow = composeTrunc(s, ins->number, ins->degree);
+            break;
+        case OP_MUL_TRUNC:
+            noUnderflow = mulTrunc(s, ins->degree);
+            break;
+        case OP_POW:
+            noUnderflow = power(s, ins->degree);
+            break;
+        case OP_SAVE:
+            awaitStack(s);
+            if (!saveStack(s, ins->path)) {
+                reportError(rep, line, "SAVE WRONG FILE");
             }
             break;
-        case 'N':
-            if (!EndLine) {
-                return false;
+        case OP_LOAD:
+            if (!loadStack(s, ins->path)) {
+                reportError(rep, line, "LOAD WRONG FILE");
             }
-            if (strncmp(NEG, *read, i) == 0) {
-                if (!neg(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
+            break;
+        case OP_MAP:
+            if (!mapFile(s, ins->path)) {
+                reportError(rep, line, "MAP WRONG FILE");
             }
             break;
-        case 'S':
-            if (!EndLine) {
-                return false;
+        case OP_EXPORT:
+            noUnderflow = exportTop(s, ins->path, &correct);
+            if (!correct) {
+                reportError(rep, line, "EXPORT WRONG FILE");
             }
-            if (strncmp(SUB, *read, i) == 0) {
-                if (!sub(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
+            break;
+        case OP_MEM:
+            awaitStack(s);
+            mem(s, rep);
+            break;
+        case OP_STATS:
+#ifdef POLY_STATS
+            awaitStack(s);
+            reportText(rep, formatStats());
+#endif
+            break;
+        case OP_RSUB:
+            if (emptyPoly(s)) {
+                underflow(rep, line);
+            } else if (s->top < 2) {
+                neg(s);
             }
+            line = ins->other;
+            noUnderflow = rsub(s);
             break;
-        case 'P':
-            if (!EndLine) {
-                return false;
+        case OP_CLONE_POP:
+            if (emptyPoly(s)) {
+                underflow(rep, line);
+                underflow(rep, ins->other);
             }
-            if (strncmp(PRINT, *read, i) == 0) {
-                if (!print(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(POP, *read, i) == 0) {
-                if (!pop(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else {
-                return false;
+            break;
+    }
+    if (!noUnderflow) {
+        underflow(rep, line);
+    }
+}
+
+/**
+ * Przekazuje puli polecenie @c MUL albo @c COMPOSE (zob. dataflow.h),
+ * jeśli na stosie jest dość wielomianów, żeby je wykonać. W przeciwnym
+ * razie polecenie jest wykonywane od razu i zgłasza błąd w swojej linii.
+ * @param[in,out] pool : pula
+ * @param[in,out] s : stos
+ * @param[in] ins : instrukcja
+ * @return Czy polecenie będzie wykonane w tle?
+ */
+static bool deferInstruction(TaskPool *pool, Stack *s, const Instruction *ins) {
+    if (ins->op == OP_MUL) {
+        return (s->top >= 2) && deferMul(pool, s);
+    }
+    if (ins->op == OP_COMPOSE) {
+        return !emptyPoly(s) && (s->top - 1 >= ins->number) && deferCompose(pool, s, ins->number);
+    }
+    return false;
+}
+
+/**
+ * Wykonuje przeanalizowaną linię wejścia: polecenie albo wstawienie
+ * wielomianu na stos. Wypisuje komunikaty o błędach.
+ * @param[in,out] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] line : numer linii
+ * @param[in] parsed : wynik analizy linii
+ * @param[in,out] in : kursor na początku linii
+ * @param[in,out] pool : pula licząca polecenia w tle lub NULL
+ */
+static void executeLine(Stack *s, Reporter *rep, int line, const ParsedLine *parsed, Cursor *in,
+                        TaskPool *pool) {
+    STATS_BEGIN_LINE(parsed->kind, in);
+    Cursor text = *in;
+    double start = isTracing() ? PolyTraceClock() : 0;
+    if (isCounting()) {
+        countersBeginLine();
+    }
+    bool correct = true;
+    switch (parsed->kind) {
+        case LINE_EMPTY:
+            break;
+        case LINE_COMMAND: {
+            Instruction ins;
+            correct = decodeCommand(in, line, &ins);
+            if ((pool == NULL) || !deferInstruction(pool, s, &ins)) {
+                executeInstruction(s, rep, &ins);
             }
+            freeInstruction(&ins);
             break;
-        case 'D':
-            if (strncmp(DEG_BY, *read, i) == 0) {
-                if (c != ' ') {
-                    fprintf(stderr, "ERROR %d DEG BY WRONG VARIABLE\n", line);
-                    return true;
-                }
-                bool correct = true;
-                bool noUnderflow = degBy(s, &correct, read, length);
-                if (!correct) {
-                    fprintf(stderr, "ERROR %d DEG BY WRONG VARIABLE\n", line);
-                } else if (!noUnderflow) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
-            } else if (strncmp(DEG, *read, i) == 0) {
-                if (!EndLine) {
-                    return false;
-                }
-                if (!deg(s)) {
-                    fprintf(stderr, "ERROR %d STACK UNDERFLOW\n", line);
-                }
+        }
+        case LINE_POLY:
+            correct = parsed->correct;
+            if (!correct) {
+                reportError(rep, line, "WRONG POLY");
             } else {
-                return false;
+                pushPoly(s, parsed->poly);
             }
             break;
-        default:
-            return false;
     }
-    return true;
+    if (isCounting()) {
+        countersEndLine(parsed->kind, &text, correct);
+    }
+    STATS_END_LINE(s, correct);
+    if (isTracing()) {
+        traceLine(line, parsed->kind, &text, correct, start, s);
+    }
 }
 
-static void PrintMono(const Mono *m);
+/**
+ * Wykonuje instrukcję programu (zob. runCompiled) i wypisuje komunikaty
+ * o błędach. Statystyki, ślad wykonania i liczniki sprzętowe opisują
+ * instrukcję pod jej nazwą (zob. instructionName), tak jak linię.
+ * @param[in,out] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in,out] ins : instrukcja
+ */
+static void executeCompiled(Stack *s, Reporter *rep, Instruction *ins) {
+    LineKind kind = instructionKind(ins);
+    const char *name = instructionName(ins);
+    Cursor text = {.pos = name, .end = name + strlen(name)};
+    STATS_BEGIN_LINE(kind, &text);
+    double start = isTracing() ? PolyTraceClock() : 0;
+    if (isCounting()) {
+        countersBeginLine();
+    }
+    executeInstruction(s, rep, ins);
+    bool correct = (ins->op != OP_WRONG_POLY) && (ins->op != OP_WRONG_COMMAND);
+    if (isCounting()) {
+        countersEndLine(kind, &text, correct);
+    }
+    STATS_END_LINE(s, correct);
+    if (isTracing()) {
+        traceLine(ins->line, kind, &text, correct, start, s);
+    }
+}
 
 /**
- * Wypisuje na standarsoe wyjście wielomian @f$p@f$.
- * @param[in] p : wielomian @f$p@f$
+ * Tłumaczy linie wejścia na program (zob. bytecode.h) i wykonuje
+ * instrukcje, których reguły lokalne już nie zmienią.
+ * @param[in,out] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in,out] reader : czytnik linii
  */
-static void PrintPoly(const Poly *p) {
-    if (p->arr == NULL) {
-        printf("%ld", p->coeff);
-    } else {
-        for (size_t i = 0; i < p->size; ++i) {
-            printf("(");
-            PrintMono(&p->arr[i]);
-            if (i != p->size - 1) {
-                printf(",%d)+", p->arr[i].exp);
+static void runCompiled(Stack *s, Reporter *rep, LineReader *reader) {
+    PolyParser parser = newPolyParser();
+    Program program = newProgram();
+    Cursor in;
+    ParsedLine parsed;
+    int line = 1;
+    while (nextLine(reader, &in)) {
+        parseLine(&parser, &in, &parsed);
+        compileLine(&program, line, &parsed, &in);
+        size_t settled = settledInstructions(&program);
+        for (size_t i = 0; i < settled; ++i) {
+            executeCompiled(s, rep, &program.code[i]);
+        }
+        removeInstructions(&program, settled);
+        ++line;
+    }
+    freePolyParser(&parser);
+    for (size_t i = 0; i < program.count; ++i) {
+        executeCompiled(s, rep, &program.code[i]);
+    }
+    freeProgram(&program);
+}
 
-            } else {
-                printf(",%d)", p->arr[i].exp);
+/**
+ * Wykonuje linie wejścia jedna po drugiej. Jeśli podano pulę, polecenia
+ * @c MUL i @c COMPOSE są liczone w tle (zob. dataflow.h).
+ * @param[in,out] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in,out] reader : czytnik linii
+ * @param[in,out] pool : pula licząca polecenia w tle lub NULL
+ */
+static void runSequential(Stack *s, Reporter *rep, LineReader *reader, TaskPool *pool) {
+    PolyParser parser = newPolyParser();
+    Cursor in;
+    ParsedLine parsed;
+    int line = 1;
+    while (nextLine(reader, &in)) {
+        parseLine(&parser, &in, &parsed);
+        executeLine(s, rep, line, &parsed, &in, pool);
+        ++line;
+    }
+    freePolyParser(&parser);
+}
 
+/**
+ * Wykonuje linie wejścia, wczytując wielomiany równolegle.
+ * Wejście jest dzielone na paczki; gdy wątek główny wykonuje polecenia
+ * jednej paczki, pula analizuje już następną. Następna paczka bierze
+ * tylko linie obecne w buforze czytnika, żeby przy pracy interaktywnej
+ * odpowiedzi nie czekały na kolejne wejście.
+ * @param[in,out] s : stos
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in,out] reader : czytnik linii
+ * @param[in] threads : liczba wątków analizujących wejście, razem z głównym
+ */
+static void runParallel(Stack *s, Reporter *rep, LineReader *reader, size_t threads) {
+    ParsePool pool;
+    initParsePool(&pool, threads - 1);
+    ParseBatch batches[2];
+    initParseBatch(&batches[0]);
+    initParseBatch(&batches[1]);
+    ParseBatch *current = &batches[0];
+    ParseBatch *spare = &batches[1];
+    bool more = fillParseBatch(current, reader, 1, true);
+    if (more) {
+        submitParseBatch(&pool, current);
+    }
+    while (more) {
+        int nextLineNumber = current->firstLine + (int) current->count;
+        bool ahead = fillParseBatch(spare, reader, nextLineNumber, false);
+        if (ahead) {
+            submitParseBatch(&pool, spare);
+        }
+        waitParseBatch(&pool, current);
+        for (size_t i = 0; i < current->count; ++i) {
+            Cursor in = batchLineCursor(current, i);
+            executeLine(s, rep, current->firstLine + (int) i, &current->lines[i].parsed, &in, NULL);
+        }
+        if (!ahead) {
+            ahead = fillParseBatch(spare, reader, nextLineNumber, true);
+            if (ahead) {
+                submitParseBatch(&pool, spare);
             }
         }
+        ParseBatch *done = current;
+        current = spare;
+        spare = done;
+        more = ahead;
     }
+    freeParseBatch(&batches[0]);
+    freeParseBatch(&batches[1]);
+    closeParsePool(&pool);
 }
 
 /**
- * Wypisuje na standarsoe wyjście jednomain @f$m@f$.
- * @param[in] m : jednomian @f$m@f$
+ * Wykonuje linie wejścia w trzech wątkach: analiza linii i formatowanie
+ * wyników odbywają się równolegle z wykonywaniem poleceń w bieżącym wątku.
+ * @param[in,out] s : stos
+ * @param[in,out] out : bufor wyjścia
+ * @param[in,out] reader : czytnik linii
  */
-static void PrintMono(const Mono *m) {
-    PrintPoly(&m->p);
+static void runPipelined(Stack *s, Output *out, LineReader *reader) {
+    Pipeline pipeline;
+    startPipeline(&pipeline, reader, out);
+    Job job;
+    while (nextJob(&pipeline, &job)) {
+        Cursor in = jobCursor(&job);
+        executeLine(s, &pipeline.reporter, job.line, &job.parsed, &in, NULL);
+        finishJob(&job);
+    }
+    stopPipeline(&pipeline);
 }
 
+/**
+ * To jest struktura przechowująca opcje wywołania programu.
+ */
+typedef struct {
+    size_t threads; ///< liczba wątków wczytujących wielomiany lub zero
+    bool pipelined; ///< czy wykonywać obliczenia potokowo
+    bool compiled; ///< czy tłumaczyć wejście na kod bajtowy (zob. bytecode.h)
+    size_t workers; ///< liczba wątków liczących polecenia w tle lub zero (zob. dataflow.h)
+    size_t memoryLimit; ///< limit pamięci głębszych elementów stosu w bajtach lub zero
+    bool stats; ///< czy wypisać statystyki na koniec (zob. stats.h)
+    const char *tracePath; ///< plik śladu wykonania lub NULL (zob. trace.h)
+    bool counters; ///< czy mierzyć polecenia licznikami sprzętowymi (zob. perf.h)
+    bool deferFree; ///< czy usuwać duże wielomiany w tle (zob. reclaim.h)
+} Options;
+
 /**
  * Wczytuje dane z wejścia, wykonuje polecenia i wypisuje kominikaty o błędach.
+ * Wejście jest dzielone na linie przez czytnik linii, a każda linia
+ * jest analizowana niezależnie od pozostałych.
+ * @param[in] options : opcje wywołania programu
  */
-void calculator(void) {
+void calculator(const Options *options) {
     Stack stack = newPolyStack();
-    int c = getchar();
-    int line = 1;
-    char *buffer = malloc(INITIAL_LENGTH * sizeof *buffer);
-    size_t length = INITIAL_LENGTH;
-    while (c != EOF) {
-        switch (c) {
-            case '#':
-                readRestOfLine();
-                break;
-            case '\n':
-                break;
-            default:
-                ungetc(c, stdin);
-                if (isLetter(c)) {
-                    if (!readCommand(&stack, line, &buffer, &length)) {
-                        fprintf(stderr, "ERROR %d WRONG COMMAND\n", line);
-                    }
-                    readRestOfLine();
-                } else {
-                    bool correct = true;
-                    Poly p = readPoly(&correct, &buffer, &length);
-                    c = getchar();
-                    if ((c != EOF) && (c != '\n')) {
-                        correct = false;
-                    }
-                    ungetc(c, stdin);
-                    readRestOfLine();
-                    if (!correct) {
-                        PolyDestroy(&p);
-                        fprintf(stderr, "ERROR %d WRONG POLY\n", line);
-                    } else {
-                        pushPoly(&stack, p);
-                    }
-                }
+    limitStackMemory(&stack, options->memoryLimit);
+    Output out;
+    initOutput(&out, STDOUT_FILENO);
+    LineReader reader;
+    if (options->pipelined) {
+        initLineReader(&reader, STDIN_FILENO, NULL);
+        runPipelined(&stack, &out, &reader);
+    } else {
+        initLineReader(&reader, STDIN_FILENO, &out);
+        Reporter rep = {.out = &out, .ring = NULL};
+        if (options->compiled) {
+            runCompiled(&stack, &rep, &reader);
+        } else if (options->workers > 0) {
+            TaskPool pool;
+            initTaskPool(&pool, options->workers);
+            runSequential(&stack, &rep, &reader, &pool);
+            awaitStack(&stack);
+            closeTaskPool(&pool);
+        } else if (options->threads == 0) {
+            runSequential(&stack, &rep, &reader, NULL);
+        } else {
+            runParallel(&stack, &rep, &reader, options->threads);
         }
-        c = getchar();
-        ++line;
     }
-    free(buffer);
+    closeLineReader(&reader);
+    closeOutput(&out);
+    if (isCounting()) {
+        char *text = formatCounters();
+        fputs(text, stderr);
+        free(text);
+    }
+#ifdef POLY_STATS
+    if (options->stats) {
+        char *text = formatStats();
+        fputs(text, stderr);
+        free(text);
+    }
+#endif
     freeStack(&stack);
 }
 
-int main(void) {
-    calculator();
+/**
+ * Wypisuje sposób użycia programu.
+ * @param[in] program : nazwa programu
+ */
+static void usage(const char *program) {
+    fprintf(stderr, USAGE, program);
+}
+
+/**
+ * Uruchamia kalkulator. Opcja @c -j @c N włącza wczytywanie wielomianów
+ * w @c N wątkach, opcja @c -p potokowe wykonywanie obliczeń, opcja @c -b
+ * tłumaczenie wejścia na kod bajtowy przed wykonaniem (zob. bytecode.h),
+ * a opcja @c -w @c N liczenie niezależnych poleceń @c MUL i @c COMPOSE
+ * w @c N wątkach w tle (zob. dataflow.h).
+ * Opcja @c -m @c M ogranicza do @c M megabajtów pamięć wielomianów leżących
+ * głębiej na stosie; nadmiar jest zamrażany, a w ostateczności przenoszony
+ * do pliku tymczasowego. Opcja @c -t @c plik zapisuje do pliku ślad wykonania
+ * (zob. trace.h), a opcja @c -c wypisuje na koniec liczniki sprzętowe
+ * procesora zmierzone dla każdego rodzaju polecenia (zob. perf.h). Opcja @c -d
+ * przenosi usuwanie dużych wielomianów do osobnego wątku (zob. reclaim.h). W programie skompilowanym z flagą @c POLY_STATS
+ * opcja @c -s wypisuje na koniec statystyki działania (zob. stats.h).
+ * @param[in] argc : liczba argumentów
+ * @param[in] argv : argumenty
+ * @return kod wyjścia programu
+ */
+int main(int argc, char *argv[]) {
+    Options options = {.threads = 0, .pipelined = false, .compiled = false, .workers = 0, .memoryLimit = 0, .stats = false,
+                       .tracePath = NULL, .counters = false, .deferFree = false};
+    int opt;
+    while ((opt = getopt(argc, argv, OPTIONS)) != -1) {
+        switch (opt) {
+            case 'j': {
+                char *end;
+                unsigned long value = strtoul(optarg, &end, 10);
+                if ((*optarg < '0') || (*optarg > '9') || (*end != '\0') ||
+                    (value == 0) || (value > MAX_THREADS)) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                options.threads = (size_t) value;
+                break;
+            }
+            case 'p':
+                options.pipelined = true;
+                break;
+            case 'b':
+                options.compiled = true;
+                break;
+            case 'w': {
+                char *end;
+                unsigned long value = strtoul(optarg, &end, 10);
+                if ((*optarg < '0') || (*optarg > '9') || (*end != '\0') ||
+                    (value == 0) || (value > MAX_THREADS)) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                options.workers = (size_t) value;
+                break;
+            }
+            case 'm': {
+                char *end;
+                unsigned long value = strtoul(optarg, &end, 10);
+                if ((*optarg < '0') || (*optarg > '9') || (*end != '\0') ||
+                    (value == 0) || (value > (SIZE_MAX >> MEGABYTE_SHIFT))) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                options.memoryLimit = (size_t) value << MEGABYTE_SHIFT;
+                break;
+            }
+            case 't':
+                options.tracePath = optarg;
+                break;
+            case 'c':
+                options.counters = true;
+                break;
+            case 'd':
+                options.deferFree = true;
+                break;
+            case 's':
+                options.stats = true;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((optind != argc) || (options.pipelined + options.compiled + (options.threads > 0) + (options.workers > 0) > 1)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((options.tracePath != NULL) && !openTrace(options.tracePath)) {
+        perror(options.tracePath);
+        return EXIT_FAILURE;
+    }
+    if (options.counters && !openCounters()) {
+        fprintf(stderr, "%s: hardware counters unavailable\n", argv[0]);
+    }
+    if (options.deferFree && !startReclaimer()) {
+        fprintf(stderr, "%s: background reclaimer unavailable\n", argv[0]);
+    }
+    calculator(&options);
+    stopReclaimer();
+    closeCounters();
+    closeTrace();
     return 0;
-}
\ No newline at end of file
+}
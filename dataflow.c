@@ -0,0 +1,287 @@
+/** @file
+  Implementacja wykonywania niezależnych operacji stosu w tle.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "dataflow.h"
+#include "additional_functions.h"
+#include <stdlib.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define MAX_QUEUED 64
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * Usuwa wielomian argumentu zadania. W przeciwieństwie do dropEntry
+ * nie przekazuje wielomianu wątkowi sprzątającemu (zob. reclaim.h),
+ * którego bufor ma tylko jednego producenta.
+ * @param[in,out] e : argument zadania
+ */
+static void releaseInput(StackEntry *e) {
+    if (e->compact) {
+        PolyCompactDestroy(&e->poly);
+        e->compact = false;
+    } else {
+        PolyDestroy(&e->poly);
+    }
+}
+
+/**
+ * Liczy iloczyn argumentów zadania, tak jak polecenie MUL.
+ * @param[in,out] task : zadanie
+ */
+static void runMul(Task *task) {
+    StackEntry *p = &task->inputs[0];
+    StackEntry *q = &task->inputs[1];
+    Poly res;
+    if (isReadOnly(p) || isReadOnly(q)) {
+        res = PolyMul(&p->poly, &q->poly);
+        releaseInput(p);
+        releaseInput(q);
+    } else {
+        res = PolyMulOwn(&p->poly, &q->poly);
+    }
+    task->result = (StackEntry) {.poly = res, .mult = p->mult * q->mult, .map = NULL, .compact = false};
+}
+
+/**
+ * Liczy złożenie argumentów zadania, tak jak polecenie COMPOSE.
+ * @param[in,out] task : zadanie
+ */
+static void runCompose(Task *task) {
+    StackEntry *p = &task->inputs[0];
+    size_t k = task->count - 1;
+    Poly *q = malloc(task->count * sizeof *q);
+    CheckReallocOutcome(q);
+    for (size_t i = 0; i < k; ++i) {
+        StackEntry *e = &task->inputs[1 + i];
+        if (e->compact) {
+            Poly copy = PolyClone(&e->poly);
+            releaseInput(e);
+            e->poly = copy;
+        }
+        q[i] = PolyScaleOwn(&e->poly, e->mult);
+    }
+    Poly res;
+    if (isReadOnly(p)) {
+        res = PolyCompose(&p->poly, k, q);
+        releaseInput(p);
+        for (size_t i = 0; i < k; ++i) {
+            PolyDestroy(&q[i]);
+        }
+    } else {
+        res = PolyComposeOwn(&p->poly, k, q);
+    }
+    free(q);
+    task->result = (StackEntry) {.poly = res, .mult = p->mult, .map = NULL, .compact = false};
+}
+
+/**
+ * Liczy zadanie: najpierw czeka na argumenty oczekujące na inne zadania,
+ * potem wykonuje polecenie. Wywoływana bez zamka puli.
+ * @param[in,out] task : zadanie
+ */
+static void runTask(Task *task) {
+    for (size_t i = 0; i < task->count; ++i) {
+        if (task->inputs[i].state == ENTRY_PENDING) {
+            task->inputs[i] = awaitTask(task->inputs[i].task);
+        }
+    }
+    if (task->compose) {
+        runCompose(task);
+    } else {
+        runMul(task);
+    }
+}
+
+/**
+ * Liczy zadanie przydzielone wątkowi i oznacza je jako zakończone.
+ * Wywoływana z zamkiem puli, który zwalnia na czas liczenia.
+ * @param[in,out] pool : pula
+ * @param[in,out] task : zadanie
+ */
+static void finishTask(TaskPool *pool, Task *task) {
+    task->claimed = true;
+    pthread_mutex_unlock(&pool->lock);
+    runTask(task);
+    pthread_mutex_lock(&pool->lock);
+    task->done = true;
+    pthread_cond_broadcast(&pool->done);
+}
+
+/**
+ * Wyjmuje zadanie z kolejki puli.
+ * @param[in,out] pool : pula
+ * @param[in] task : zadanie z kolejki
+ */
+static void unlinkTask(TaskPool *pool, Task *task) {
+    Task *prev = NULL;
+    Task *t = pool->head;
+    while (t != task) {
+        prev = t;
+        t = t->next;
+    }
+    if (prev == NULL) {
+        pool->head = task->next;
+    } else {
+        prev->next = task->next;
+    }
+    if (pool->tail == task) {
+        pool->tail = prev;
+    }
+    --pool->queued;
+    pthread_cond_broadcast(&pool->done);
+}
+
+/**
+ * Główna funkcja wątku roboczego: liczy zadania z kolejki w kolejności
+ * ich tworzenia, dopóki pula nie zostanie zamknięta. Argumenty zadania
+ * są starsze od niego, więc wątek, który na nie czeka, nigdy nie czeka
+ * na samego siebie.
+ * @param[in,out] arg : pula
+ * @return NULL
+ */
+static void *taskWorker(void *arg) {
+    TaskPool *pool = arg;
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while ((pool->head == NULL) && !pool->stop) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->head == NULL) {
+            break;
+        }
+        Task *task = pool->head;
+        unlinkTask(pool, task);
+        finishTask(pool, task);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+void initTaskPool(TaskPool *pool, size_t threads) {
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->head = NULL;
+    pool->tail = NULL;
+    pool->queued = 0;
+    pool->stop = false;
+    pool->threads = malloc((threads > 0 ? threads : 1) * sizeof *pool->threads);
+    CheckReallocOutcome(pool->threads);
+    pool->threadsCount = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, taskWorker, pool) != 0) {
+            break;
+        }
+        ++pool->threadsCount;
+    }
+}
+
+void closeTaskPool(TaskPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->threadsCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+/**
+ * Sprawdza, czy któryś z @f$count@f$ elementów z wierzchu stosu jest
+ * zmapowany. Nie sięga po same wielomiany, więc nie odmraża elementów.
+ * @param[in] stack : stos
+ * @param[in] count : liczba elementów
+ * @return Czy któryś element jest zmapowany?
+ */
+static bool anyMapped(const Stack *stack, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (stack->array[stack->top - 1 - i].map != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Zdejmuje argumenty zadania ze stosu, wstawia zadanie do kolejki
+ * i wkłada na stos element oczekujący na jego wynik. Jeśli kolejka
+ * jest pełna, najpierw sam liczy najstarsze zadania z kolejki.
+ * @param[in,out] pool : pula
+ * @param[in,out] stack : stos
+ * @param[in] count : liczba argumentów
+ * @param[in] compose : czy zadanie jest złożeniem
+ */
+static void submitTask(TaskPool *pool, Stack *stack, size_t count, bool compose) {
+    Task *task = malloc(sizeof *task);
+    CheckReallocOutcome(task);
+    task->pool = pool;
+    task->inputs = malloc(count * sizeof *task->inputs);
+    CheckReallocOutcome(task->inputs);
+    task->count = count;
+    task->compose = compose;
+    task->claimed = false;
+    task->done = false;
+    task->next = NULL;
+    task->inputs[0] = popDeferred(stack);
+    for (size_t i = count - 1; i > 0; --i) {
+        task->inputs[i] = popDeferred(stack);
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (pool->queued >= MAX_QUEUED) {
+        Task *oldest = pool->head;
+        unlinkTask(pool, oldest);
+        finishTask(pool, oldest);
+    }
+    if (pool->tail == NULL) {
+        pool->head = task;
+    } else {
+        pool->tail->next = task;
+    }
+    pool->tail = task;
+    ++pool->queued;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    pushPending(stack, task);
+}
+
+bool deferMul(TaskPool *pool, Stack *stack) {
+    if (anyMapped(stack, 2)) {
+        return false;
+    }
+    submitTask(pool, stack, 2, false);
+    return true;
+}
+
+bool deferCompose(TaskPool *pool, Stack *stack, size_t k) {
+    if (anyMapped(stack, k + 1)) {
+        return false;
+    }
+    submitTask(pool, stack, k + 1, true);
+    return true;
+}
+
+StackEntry awaitTask(Task *task) {
+    TaskPool *pool = task->pool;
+    pthread_mutex_lock(&pool->lock);
+    if (!task->claimed) {
+        unlinkTask(pool, task);
+        finishTask(pool, task);
+    }
+    while (!task->done) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    StackEntry result = task->result;
+    free(task->inputs);
+    free(task);
+    return result;
+}
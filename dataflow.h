@@ -0,0 +1,113 @@
+/** @file
+  Interfejs wykonywania niezależnych operacji stosu w tle.
+
+  W trybie @c -w kalkulator nie liczy od razu wyników poleceń @c MUL
+  i @c COMPOSE. Zdejmuje ich argumenty, tworzy z nich zadanie dla puli
+  wątków i wkłada na stos element oczekujący na wynik zadania. Argumentem
+  zadania może być element oczekujący, więc zadania tworzą graf zależności,
+  w którym krawędzie prowadzą od zadań liczących argumenty. Zadania, które
+  od siebie nie zależą, na przykład iloczyny kilku podwyrażeń budowanych
+  obok siebie na stosie, są liczone jednocześnie.
+
+  Wątek wykonujący polecenia dalej przechodzi linie po kolei i sam wypisuje
+  wszystkie wyniki i komunikaty o błędach. Braki wielomianów na stosie
+  wykrywa przed utworzeniem zadania, a na wynik zadania czeka dopiero
+  wtedy, gdy polecenie sięga po element oczekujący (np. @c PRINT), więc
+  wyjście jest takie samo jak przy wykonaniu sekwencyjnym. Okno zadań
+  czekających na wątek roboczy jest ograniczone; po jego zapełnieniu
+  wątek wykonujący polecenia sam liczy najstarsze zadania, zanim utworzy
+  kolejne.
+  Zadanie, na które ktoś czeka, a którego żaden wątek jeszcze nie wziął,
+  jest liczone przez czekającego.
+
+  Zadania nie dotykają wielomianów zmapowanych, bo liczniki referencji
+  mapowań nie są bezpieczne dla wielu wątków; polecenia z takimi
+  argumentami są wykonywane od razu.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_DATAFLOW_H
+#define POLYNOMIALS_DATAFLOW_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "stack.h"
+
+typedef struct TaskPool TaskPool;
+
+/**
+ * To jest struktura reprezentująca zadanie: polecenie @c MUL albo
+ * @c COMPOSE z argumentami zdjętymi ze stosu.
+ */
+typedef struct Task {
+    TaskPool *pool; ///< pula, do której należy zadanie
+    StackEntry *inputs; ///< argumenty: wielomian z wierzchołka, a za nim pozostałe od najgłębszego
+    size_t count; ///< liczba argumentów
+    bool compose; ///< czy zadanie jest złożeniem, a nie iloczynem
+    bool claimed; ///< czy jakiś wątek liczy już zadanie
+    bool done; ///< czy wynik jest gotowy
+    StackEntry result; ///< wynik zadania
+    struct Task *next; ///< następne zadanie w kolejce
+} Task;
+
+/**
+ * To jest struktura reprezentująca pulę wątków liczących zadania.
+ */
+struct TaskPool {
+    pthread_mutex_t lock; ///< zamek chroniący kolejkę i stan zadań
+    pthread_cond_t work; ///< sygnalizuje nowe zadanie w kolejce
+    pthread_cond_t done; ///< sygnalizuje zakończenie zadania lub zwolnienie miejsca w kolejce
+    Task *head; ///< pierwsze zadanie w kolejce
+    Task *tail; ///< ostatnie zadanie w kolejce
+    size_t queued; ///< liczba zadań w kolejce
+    bool stop; ///< czy pula jest zamykana
+    pthread_t *threads; ///< wątki robocze
+    size_t threadsCount; ///< liczba uruchomionych wątków
+};
+
+/**
+ * Tworzy pulę wątków i uruchamia wątki robocze.
+ * @param[out] pool : pula
+ * @param[in] threads : liczba wątków roboczych
+ */
+void initTaskPool(TaskPool *pool, size_t threads);
+
+/**
+ * Kończy wątki robocze i usuwa pulę z pamięci. Na stosach nie może
+ * być już elementów oczekujących na zadania puli (zob. awaitStack).
+ * @param[in,out] pool : pula
+ */
+void closeTaskPool(TaskPool *pool);
+
+/**
+ * Zastępuje dwa wielomiany z wierzchu stosu elementem oczekującym na ich
+ * iloczyn, o ile żaden z nich nie jest zmapowany.
+ * @param[in,out] pool : pula
+ * @param[in,out] stack : stos z co najmniej dwoma elementami
+ * @return Czy utworzono zadanie? Jeśli nie, stos jest niezmieniony.
+ */
+bool deferMul(TaskPool *pool, Stack *stack);
+
+/**
+ * Zastępuje wielomian z wierzchu stosu i @f$k@f$ wielomianów pod nim
+ * elementem oczekującym na ich złożenie, o ile żaden z nich nie jest
+ * zmapowany.
+ * @param[in,out] pool : pula
+ * @param[in,out] stack : stos z co najmniej @f$k + 1@f$ elementami
+ * @param[in] k : liczba wielomianów podstawianych za zmienne
+ * @return Czy utworzono zadanie? Jeśli nie, stos jest niezmieniony.
+ */
+bool deferCompose(TaskPool *pool, Stack *stack, size_t k);
+
+/**
+ * Czeka na wynik zadania, a jeśli żaden wątek go jeszcze nie wziął,
+ * sam je liczy. Usuwa zadanie z pamięci.
+ * @param[in,out] task : zadanie
+ * @return wynik zadania
+ */
+StackEntry awaitTask(Task *task);
+
+#endif //POLYNOMIALS_DATAFLOW_H
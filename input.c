@@ -0,0 +1,210 @@
+/** @file
+  Implementacja buforowanego wczytywania wejścia kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "input.h"
+#include "additional_functions.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define READ_BLOCK (1 << 20)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SWAR_DIGITS
+#endif
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * Próbuje zmapować do pamięci zwykły plik wskazywany przez deskryptor.
+ * Czytanie zaczyna się od bieżącej pozycji deskryptora.
+ * @param[in,out] reader : czytnik
+ * @return Czy udało się zmapować plik?
+ */
+static bool mapLineReader(LineReader *reader) {
+    struct stat st;
+    if ((fstat(reader->fd, &st) != 0) || !S_ISREG(st.st_mode) || (st.st_size <= 0)) {
+        return false;
+    }
+    off_t offset = lseek(reader->fd, 0, SEEK_CUR);
+    if ((offset < 0) || (offset > st.st_size)) {
+        return false;
+    }
+    size_t size = (size_t) st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, reader->fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+    reader->data = map;
+    reader->size = size;
+    reader->capacity = size;
+    reader->begin = (size_t) offset;
+    reader->scanned = (size_t) offset;
+    reader->mapped = true;
+    reader->eof = true;
+    return true;
+}
+
+void initLineReader(LineReader *reader, int fd, Output *output) {
+    reader->fd = fd;
+    reader->output = output;
+    reader->begin = 0;
+    reader->scanned = 0;
+    reader->size = 0;
+    reader->mapped = false;
+    reader->eof = false;
+    if (mapLineReader(reader)) {
+        return;
+    }
+    reader->capacity = READ_BLOCK;
+    reader->data = malloc(reader->capacity);
+    CheckReallocOutcome(reader->data);
+}
+
+void closeLineReader(LineReader *reader) {
+    if (reader->mapped) {
+        munmap(reader->data, reader->capacity);
+    } else {
+        free(reader->data);
+    }
+    reader->data = NULL;
+}
+
+/**
+ * Dowczytuje kolejny blok danych do bufora czytnika.
+ * Nieodczytaną część przesuwa na początek bufora, a jeśli bufor jest pełny,
+ * powiększa go.
+ * @param[in,out] reader : czytnik
+ */
+static void fillLineReader(LineReader *reader) {
+    if (reader->begin > 0) {
+        memmove(reader->data, reader->data + reader->begin, reader->size - reader->begin);
+        reader->size -= reader->begin;
+        reader->scanned -= reader->begin;
+        reader->begin = 0;
+    }
+    if (reader->size == reader->capacity) {
+        reader->capacity = more(reader->capacity);
+        reader->data = realloc(reader->data, reader->capacity);
+        CheckReallocOutcome(reader->data);
+    }
+    if (reader->output != NULL) {
+        flushOutput(reader->output);
+    }
+    ssize_t n;
+    do {
+        n = read(reader->fd, reader->data + reader->size, reader->capacity - reader->size);
+    } while ((n < 0) && (errno == EINTR));
+    if (n <= 0) {
+        reader->eof = true;
+    } else {
+        reader->size += (size_t) n;
+    }
+}
+
+bool nextBufferedLine(LineReader *reader, Cursor *line) {
+    char *newline = memchr(reader->data + reader->scanned, '\n',
+                           reader->size - reader->scanned);
+    if (newline != NULL) {
+        line->pos = reader->data + reader->begin;
+        line->end = newline + 1;
+        reader->begin = (size_t) (line->end - reader->data);
+        reader->scanned = reader->begin;
+        return true;
+    }
+    reader->scanned = reader->size;
+    if (reader->eof && (reader->begin < reader->size)) {
+        line->pos = reader->data + reader->begin;
+        line->end = reader->data + reader->size;
+        reader->begin = reader->size;
+        return true;
+    }
+    return false;
+}
+
+bool nextLine(LineReader *reader, Cursor *line) {
+    while (!nextBufferedLine(reader, line)) {
+        if (reader->eof) {
+            return false;
+        }
+        fillLineReader(reader);
+    }
+    return true;
+}
+
+#ifdef SWAR_DIGITS
+
+/**
+ * Sprawdza, czy wszystkie osiem bajtów słowa to cyfry dziesiętne.
+ * @param[in] chunk : osiem kolejnych znaków wejścia
+ * @return Czy słowo składa się z samych cyfr?
+ */
+static bool isEightDigits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+            (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+           0x3333333333333333;
+}
+
+/**
+ * Zamienia osiem cyfr dziesiętnych na liczbę za pomocą trzech mnożeń:
+ * najpierw łączy sąsiednie cyfry w pary, potem pary w czwórki,
+ * a na końcu czwórki w wynik.
+ * @param[in] chunk : osiem cyfr, pierwsza w najmłodszym bajcie
+ * @return wartość liczby
+ */
+static unsigned long parseEightDigits(uint64_t chunk) {
+    const uint64_t mask = 0x000000FF000000FF;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return (unsigned long) chunk;
+}
+
+#endif /* SWAR_DIGITS */
+
+size_t readDigits(Cursor *in, unsigned long *value, bool *overflow) {
+    const char *start = in->pos;
+    unsigned long res = 0;
+    bool over = false;
+#ifdef SWAR_DIGITS
+    while (in->end - in->pos >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, in->pos, sizeof chunk);
+        if (!isEightDigits(chunk)) {
+            break;
+        }
+        unsigned long eight = parseEightDigits(chunk);
+        if (res > (ULONG_MAX - eight) / 100000000UL) {
+            over = true;
+        }
+        res = res * 100000000UL + eight;
+        in->pos += 8;
+    }
+#endif
+    while ((in->pos < in->end) && (*in->pos >= '0') && (*in->pos <= '9')) {
+        unsigned long digit = (unsigned long) (*in->pos - '0');
+        if (res > (ULONG_MAX - digit) / 10) {
+            over = true;
+        }
+        res = res * 10 + digit;
+        ++in->pos;
+    }
+    *value = res;
+    *overflow = over;
+    return (size_t) (in->pos - start);
+}
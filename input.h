@@ -0,0 +1,116 @@
+/** @file
+  Interfejs buforowanego wczytywania wejścia kalkulatora.
+  Wejście jest czytane dużymi blokami albo mapowane do pamięci w całości,
+  a następnie dzielone na linie. Każdą linię odczytuje się kursorem,
+  który zachowuje się jak getchar() i ungetc() ograniczone do tej linii.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_INPUT_H
+#define POLYNOMIALS_INPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "output.h"
+
+/**
+ * To jest struktura reprezentująca kursor w jednej linii wejścia.
+ * Zakres @f$[pos, end)@f$ obejmuje końcowy znak nowej linii, jeśli linia go ma.
+ */
+typedef struct {
+    const char *pos; ///< następny znak do odczytania
+    const char *end; ///< koniec linii
+} Cursor;
+
+/**
+ * To jest struktura reprezentująca czytnik linii z deskryptora pliku.
+ * Jeśli deskryptor wskazuje na zwykły plik, jest on mapowany do pamięci,
+ * w przeciwnym przypadku dane są czytane blokami do bufora.
+ */
+typedef struct {
+    int fd; ///< deskryptor czytanego pliku
+    char *data; ///< bufor lub zmapowany plik
+    size_t begin; ///< początek nieodczytanych danych
+    size_t scanned; ///< koniec danych przeszukanych bez znalezienia końca linii
+    size_t size; ///< liczba bajtów w @p data
+    size_t capacity; ///< rozmiar bufora
+    bool mapped; ///< czy @p data to zmapowany plik
+    bool eof; ///< czy wczytano już całe wejście
+    Output *output; ///< wyjście opróżniane przed czekaniem na dane
+} LineReader;
+
+/**
+ * Przygotowuje czytnik linii z deskryptora @p fd.
+ * @param[out] reader : czytnik
+ * @param[in] fd : deskryptor pliku
+ * @param[in] output : wyjście opróżniane przed czekaniem na dane lub NULL
+ */
+void initLineReader(LineReader *reader, int fd, Output *output);
+
+/**
+ * Zwalnia zasoby czytnika linii.
+ * @param[in,out] reader : czytnik
+ */
+void closeLineReader(LineReader *reader);
+
+/**
+ * Ustawia kursor na kolejnej linii wejścia.
+ * Linia pozostaje ważna do następnego wywołania funkcji.
+ * Zanim czytnik zablokuje się w oczekiwaniu na dane, opróżnia bufor
+ * wyjścia, żeby odpowiedzi na wcześniejsze polecenia
+ * nie czekały na kolejne wejście.
+ * @param[in,out] reader : czytnik
+ * @param[out] line : kursor na początku linii
+ * @return Czy wczytano linię?
+ */
+bool nextLine(LineReader *reader, Cursor *line);
+
+/**
+ * Ustawia kursor na kolejnej linii wejścia, jeśli jest ona już w całości
+ * w buforze czytnika. W przeciwieństwie do nextLine nigdy nie czeka na dane.
+ * Linia pozostaje ważna do następnego wywołania nextLine.
+ * @param[in,out] reader : czytnik
+ * @param[out] line : kursor na początku linii
+ * @return Czy w buforze była cała linia?
+ */
+bool nextBufferedLine(LineReader *reader, Cursor *line);
+
+/**
+ * Wczytuje z kursora znak tak jak getchar(). Na końcu linii
+ * bez znaku nowej linii zwraca EOF.
+ * @param[in,out] in : kursor
+ * @return wczytany znak lub EOF
+ */
+static inline int cursorGet(Cursor *in) {
+    if (in->pos == in->end) {
+        return EOF;
+    }
+    return (unsigned char) *in->pos++;
+}
+
+/**
+ * Cofa ostatnio wczytany znak tak jak ungetc(). Nie robi nic dla EOF.
+ * @param[in,out] in : kursor
+ * @param[in] c : ostatnio wczytany znak
+ */
+static inline void cursorUnget(Cursor *in, int c) {
+    if (c != EOF) {
+        --in->pos;
+    }
+}
+
+/**
+ * Wczytuje z kursora ciąg cyfr dziesiętnych, przetwarzając po osiem cyfr naraz.
+ * Zatrzymuje się na pierwszym znaku, który nie jest cyfrą.
+ * Jeśli wartość nie mieści się w typie unsigned long,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @p overflow, na true.
+ * @param[in,out] in : kursor
+ * @param[out] value : wczytana wartość
+ * @param[out] overflow : czy wartość przekroczyła zakres
+ * @return liczba wczytanych cyfr
+ */
+size_t readDigits(Cursor *in, unsigned long *value, bool *overflow);
+
+#endif //POLYNOMIALS_INPUT_H
@@ -0,0 +1,160 @@
+/** @file
+  Implementacja buforowanego wypisywania wyników kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "output.h"
+#include "additional_functions.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define OUTPUT_BLOCK (1 << 20)
+#define MAX_LONG_DIGITS 20
+#define TEMP_SUFFIX ".XXXXXX"
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/** Zapisy dziesiętne liczb od 0 do 99, po dwa znaki na liczbę. */
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+void initOutput(Output *out, int fd) {
+    out->fd = fd;
+    out->size = 0;
+    out->capacity = OUTPUT_BLOCK;
+    out->data = malloc(out->capacity);
+    CheckReallocOutcome(out->data);
+    out->lineFlush = isatty(fd);
+    out->failed = false;
+}
+
+/**
+ * Zapisuje do deskryptora wszystkie podane bajty,
+ * ponawiając zapis przerwany przez sygnał lub wykonany częściowo.
+ * @param[in] fd : deskryptor pliku
+ * @param[in] bytes : bajty
+ * @param[in] count : liczba bajtów
+ * @return Czy udało się zapisać wszystkie bajty?
+ */
+static bool writeAll(int fd, const char *bytes, size_t count) {
+    size_t written = 0;
+    while (written < count) {
+        ssize_t n = write(fd, bytes + written, count - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += (size_t) n;
+    }
+    return true;
+}
+
+void flushOutput(Output *out) {
+    if (!writeAll(out->fd, out->data, out->size)) {
+        out->failed = true;
+    }
+    out->size = 0;
+}
+
+void closeOutput(Output *out) {
+    flushOutput(out);
+    free(out->data);
+    out->data = NULL;
+}
+
+int openReplacement(const char *path, char **temp) {
+    size_t length = strlen(path) + sizeof TEMP_SUFFIX;
+    *temp = malloc(length);
+    CheckReallocOutcome(*temp);
+    snprintf(*temp, length, "%s%s", path, TEMP_SUFFIX);
+    int fd = mkstemp(*temp);
+    if (fd < 0) {
+        free(*temp);
+        *temp = NULL;
+        return -1;
+    }
+    mode_t mask = umask(0);
+    umask(mask);
+    if (fchmod(fd, 0666 & ~mask) != 0) {
+        close(fd);
+        unlink(*temp);
+        free(*temp);
+        *temp = NULL;
+        return -1;
+    }
+    return fd;
+}
+
+bool replaceFile(int fd, char *temp, const char *path, bool correct) {
+    if (close(fd) != 0) {
+        correct = false;
+    }
+    if (!correct || (rename(temp, path) != 0)) {
+        unlink(temp);
+        correct = false;
+    }
+    free(temp);
+    return correct;
+}
+
+void writeBytes(Output *out, const char *bytes, size_t count) {
+    if (out->capacity - out->size < count) {
+        flushOutput(out);
+        if (count >= out->capacity) {
+            if (!writeAll(out->fd, bytes, count)) {
+                out->failed = true;
+            }
+            return;
+        }
+    }
+    memcpy(out->data + out->size, bytes, count);
+    out->size += count;
+}
+
+void writeLong(Output *out, long x) {
+    if (out->capacity - out->size < MAX_LONG_DIGITS + 1) {
+        flushOutput(out);
+    }
+    unsigned long value = (unsigned long) x;
+    if (x < 0) {
+        out->data[out->size++] = '-';
+        value = 0 - value;
+    }
+    char digits[MAX_LONG_DIGITS];
+    char *end = digits + MAX_LONG_DIGITS;
+    char *pos = end;
+    while (value >= 100) {
+        unsigned long pair = (value % 100) * 2;
+        value /= 100;
+        pos -= 2;
+        memcpy(pos, digitPairs + pair, 2);
+    }
+    if (value >= 10) {
+        pos -= 2;
+        memcpy(pos, digitPairs + value * 2, 2);
+    } else {
+        *--pos = (char) ('0' + value);
+    }
+    memcpy(out->data + out->size, pos, (size_t) (end - pos));
+    out->size += (size_t) (end - pos);
+}
@@ -0,0 +1,108 @@
+/** @file
+  Interfejs buforowanego wypisywania wyników kalkulatora.
+  Wyniki są formatowane bezpośrednio w dużym buforze i zapisywane
+  do deskryptora pliku dużymi blokami.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_OUTPUT_H
+#define POLYNOMIALS_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * To jest struktura reprezentująca bufor wyjścia.
+ */
+typedef struct {
+    int fd; ///< deskryptor, do którego trafia wyjście
+    char *data; ///< bufor
+    size_t size; ///< liczba bajtów w buforze
+    size_t capacity; ///< rozmiar bufora
+    bool lineFlush; ///< czy opróżniać bufor po każdej linii
+    bool failed; ///< czy któryś zapis do deskryptora się nie powiódł
+} Output;
+
+/**
+ * Przygotowuje bufor wyjścia dla deskryptora @p fd.
+ * Jeśli deskryptor jest terminalem, bufor jest opróżniany po każdej linii.
+ * @param[out] out : bufor wyjścia
+ * @param[in] fd : deskryptor pliku
+ */
+void initOutput(Output *out, int fd);
+
+/**
+ * Zapisuje zawartość bufora do deskryptora.
+ * @param[in,out] out : bufor wyjścia
+ */
+void flushOutput(Output *out);
+
+/**
+ * Opróżnia bufor wyjścia i zwalnia jego pamięć.
+ * @param[in,out] out : bufor wyjścia
+ */
+void closeOutput(Output *out);
+
+/**
+ * Tworzy plik tymczasowy w katalogu pliku @p path, który po zapisaniu
+ * zastąpi ten plik (zob. replaceFile). Plik tymczasowy ma takie prawa,
+ * jakie dostałby nowo utworzony plik docelowy.
+ * @param[in] path : ścieżka pliku docelowego
+ * @param[out] temp : ścieżka pliku tymczasowego, do zwolnienia przez replaceFile
+ * @return deskryptor pliku tymczasowego lub -1, jeśli nie udało się go utworzyć
+ */
+int openReplacement(const char *path, char **temp);
+
+/**
+ * Zamyka plik tymczasowy utworzony przez openReplacement i, jeśli zapis
+ * się powiódł, zastępuje nim plik docelowy. W przeciwnym przypadku plik
+ * tymczasowy jest usuwany, a plik docelowy pozostaje bez zmian.
+ * Istniejące mapowania pliku docelowego nie są zmieniane.
+ * @param[in] fd : deskryptor pliku tymczasowego
+ * @param[in,out] temp : ścieżka pliku tymczasowego, zwalniana przez funkcję
+ * @param[in] path : ścieżka pliku docelowego
+ * @param[in] correct : czy zapis pliku tymczasowego się powiódł
+ * @return Czy plik docelowy został zastąpiony?
+ */
+bool replaceFile(int fd, char *temp, const char *path, bool correct);
+
+/**
+ * Dopisuje do bufora ciąg bajtów.
+ * @param[in,out] out : bufor wyjścia
+ * @param[in] bytes : bajty
+ * @param[in] count : liczba bajtów
+ */
+void writeBytes(Output *out, const char *bytes, size_t count);
+
+/**
+ * Dopisuje do bufora zapis dziesiętny liczby.
+ * @param[in,out] out : bufor wyjścia
+ * @param[in] x : liczba
+ */
+void writeLong(Output *out, long x);
+
+/**
+ * Dopisuje do bufora znak.
+ * @param[in,out] out : bufor wyjścia
+ * @param[in] c : znak
+ */
+static inline void writeChar(Output *out, char c) {
+    if (out->size == out->capacity) {
+        flushOutput(out);
+    }
+    out->data[out->size++] = c;
+}
+
+/**
+ * Kończy linię wyjścia. Na terminalu od razu opróżnia bufor.
+ * @param[in,out] out : bufor wyjścia
+ */
+static inline void endLine(Output *out) {
+    writeChar(out, '\n');
+    if (out->lineFlush) {
+        flushOutput(out);
+    }
+}
+
+#endif //POLYNOMIALS_OUTPUT_H
@@ -0,0 +1,360 @@
+/** @file
+  Implementacja parsera linii wejścia kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "parser.h"
+#include "additional_functions.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "poly_stats.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+#define FIRST_NUMBER 48
+#define LAST_NUMBER 57
+#define FIRST_SMALL_LETTER 97
+#define LAST_SMALL_LETTER 122
+#define FIRST_BIG_LETTER 65
+#define LAST_BIG_LETTER 90
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+bool isLetter(int c) {
+    if (((c <= LAST_BIG_LETTER) && (c >= FIRST_BIG_LETTER)) ||
+        ((c >= FIRST_SMALL_LETTER) && (c <= LAST_SMALL_LETTER))) {
+        return true;
+    } else {
+        return false;
+    }
+}
+
+poly_coeff_t readCoeff(Cursor *in, bool *correct) {
+    bool negative = false;
+    int c = cursorGet(in);
+    if (c == '-') {
+        negative = true;
+    } else {
+        cursorUnget(in, c);
+    }
+    unsigned long value;
+    bool overflow;
+    size_t i = readDigits(in, &value, &overflow);
+    c = cursorGet(in);
+    if ((c != EOF) && (c != ',') && (c != '\n')) {
+        *correct = false;
+    }
+    cursorUnget(in, c);
+    if ((i == 0) && !negative) {
+        *correct = false;
+    }
+    unsigned long limit = negative ? (unsigned long) LONG_MAX + 1 : (unsigned long) LONG_MAX;
+    if (overflow || (value > limit)) {
+        *correct = false;
+    }
+    return negative ? (poly_coeff_t) (0 - value) : (poly_coeff_t) value;
+}
+
+unsigned long readUnsignedLong(Cursor *in, bool *correct) {
+    unsigned long value;
+    bool overflow;
+    size_t i = readDigits(in, &value, &overflow);
+    int c = cursorGet(in);
+    if ((c != EOF) && (c != ',') && (c != '\n') && (c != ' ')) {
+        *correct = false;
+    }
+    cursorUnget(in, c);
+    if ((i == 0) || overflow) {
+        *correct = false;
+    }
+    return value;
+}
+
+/**
+ * Wczytuje z kursora liczbę typu poly_exp_t.
+ * Jeśli wczyta niedozwolony znak
+ * lub liczba nie mieści się w typie poly_exp_t,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return wczytana wartość
+ */
+static poly_exp_t readExp(Cursor *in, bool *correct) {
+    unsigned long value;
+    bool overflow;
+    size_t i = readDigits(in, &value, &overflow);
+    int c = cursorGet(in);
+    cursorUnget(in, c);
+    if ((c != EOF) && (c != ')') && (c != '\n')) {
+        *correct = false;
+        return 0;
+    }
+    if ((i == 0) || overflow || (value > INT_MAX)) {
+        *correct = false;
+        return 0;
+    }
+    return (poly_exp_t) value;
+}
+
+PolyParser newPolyParser(void) {
+    PolyParser parser;
+    parser.termsLength = INITIAL_LENGTH;
+    parser.terms = malloc(parser.termsLength * sizeof *parser.terms);
+    parser.levelsLength = INITIAL_LENGTH;
+    parser.levels = malloc(parser.levelsLength * sizeof *parser.levels);
+    return parser;
+}
+
+void freePolyParser(PolyParser *parser) {
+    free(parser->terms);
+    free(parser->levels);
+}
+
+/**
+ * Daje jednomian tożsamościowo równy zeru.
+ * @return jednomian zerowy
+ */
+static Mono zeroMono(void) {
+    Poly res = PolyZero();
+    return MonoFromPoly(&res, 0);
+}
+
+/**
+ * Wczytuje z kursora jednomian postaci @f$(c,e)@f$, gdzie @f$c@f$ jest liczbą,
+ * zaczynając zaraz za nawiasem otwierającym.
+ * Jeśli wczyta niedozwolony znak,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return wczytany jednomian
+ */
+static Mono readCoeffMono(Cursor *in, bool *correct) {
+    poly_coeff_t coeff = readCoeff(in, correct);
+    if (cursorGet(in) != ',') {
+        *correct = false;
+        return zeroMono();
+    }
+    poly_exp_t exp = readExp(in, correct);
+    if (cursorGet(in) != ')') {
+        *correct = false;
+        return zeroMono();
+    }
+    if (coeff == 0) {
+        return zeroMono();
+    }
+    Poly p = PolyFromCoeff(coeff);
+    return MonoFromPoly(&p, exp);
+}
+
+/**
+ * Wczytuje z kursora stałą bez nawiasów, która musi kończyć linię.
+ * Jeśli wczyta niedozwolony znak,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return jednomian o wykładniku zero ze wczytaną stałą
+ */
+static Mono readConstMono(Cursor *in, bool *correct) {
+    int a = cursorGet(in);
+    bool negative = (a == '-');
+    if (!negative) {
+        cursorUnget(in, a);
+    }
+    a = cursorGet(in);
+    cursorUnget(in, a);
+    if ((a < FIRST_NUMBER) || (a > LAST_NUMBER)) {
+        *correct = false;
+        return zeroMono();
+    }
+    poly_coeff_t coeff = readCoeff(in, correct);
+    a = cursorGet(in);
+    cursorUnget(in, a);
+    if (a != '\n') {
+        *correct = false;
+        return zeroMono();
+    }
+    Poly res = PolyFromCoeff(negative ? -1 * coeff : coeff);
+    return MonoFromPoly(&res, 0);
+}
+
+/**
+ * Sprawdza, czy wielomian zbudowany przez parser jest zerem.
+ * Parser nie tworzy jednomianów o zerowym współczynniku, więc w przeciwieństwie
+ * do PolyIsZero wystarczy sprawdzić tylko najwyższy poziom.
+ * @param[in] p : wielomian zbudowany przez parser
+ * @return Czy wielomian jest zerem?
+ */
+static bool isZeroCoeff(const Poly *p) {
+    return (p->arr == NULL) && (p->coeff == 0);
+}
+
+/**
+ * Dokłada jednomian do pamięci roboczej parsera.
+ * @param[in,out] parser : parser
+ * @param[in,out] count : liczba jednomianów w pamięci roboczej
+ * @param[in] m : jednomian
+ */
+static void pushTerm(PolyParser *parser, size_t *count, Mono m) {
+    LengthenArrayIfNecessary(&parser->terms, &parser->termsLength, *count);
+    parser->terms[*count] = m;
+    ++*count;
+}
+
+/**
+ * Tworzy wielomian z jednomianów leżących w pamięci roboczej parsera
+ * od indeksu @f$first@f$ do końca. Pojedyncza stała staje się
+ * współczynnikiem bez alokacji. Jednomiany podane w kolejności rosnących
+ * wykładników są kopiowane bez sortowania i łączenia.
+ * @param[in] parser : parser
+ * @param[in] first : indeks pierwszego jednomianu
+ * @param[in] count : liczba jednomianów w pamięci roboczej
+ * @return wielomian będący sumą jednomianów
+ */
+static Poly buildPoly(PolyParser *parser, size_t first, size_t count) {
+    Mono *terms = parser->terms + first;
+    size_t size = count - first;
+    if ((size == 1) && (terms[0].exp == 0) && (terms[0].p.arr == NULL)) {
+        return terms[0].p;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (isZeroCoeff(&terms[i].p) || ((i > 0) && (terms[i - 1].exp >= terms[i].exp))) {
+            return PolyAddMonos(size, terms);
+        }
+    }
+    Mono *arr = malloc(size * sizeof *arr);
+    memcpy(arr, terms, size * sizeof *arr);
+    return (Poly) {.size = size, .arr = arr};
+}
+
+/**
+ * Tworzy wielomian na podstawie znaków wczytanych z kursora.
+ * Zamiast rekurencji używa jawnego stosu poziomów zagnieżdżenia, więc
+ * głęboko zagnieżdżone wielomiany nie przepełniają stosu wywołań.
+ * Wielomian budowany jest od najgłębszego poziomu: po nawiasie zamykającym
+ * jednomiany poziomu zastępowane są jednym jednomianem poziomu wyżej.
+ * Jeśli wczyta niedozwolony znak,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] parser : parser
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return wczytany wielomian
+ */
+static Poly readPoly(PolyParser *parser, Cursor *in, bool *correct) {
+    size_t depth = 0;
+    size_t count = 0;
+    parser->levels[0] = 0;
+    while (*correct) {
+        int a = cursorGet(in);
+        if (a == '(') {
+            int b = cursorGet(in);
+            cursorUnget(in, b);
+            if (b == '(') {
+                ++depth;
+                if (depth == parser->levelsLength) {
+                    parser->levelsLength = more(parser->levelsLength);
+                    parser->levels = realloc(parser->levels,
+                                             parser->levelsLength * sizeof *parser->levels);
+                    CheckReallocOutcome(parser->levels);
+                }
+                parser->levels[depth] = count;
+                continue;
+            }
+            if (((b < FIRST_NUMBER) || (b > LAST_NUMBER)) && (b != '-')) {
+                *correct = false;
+                break;
+            }
+            pushTerm(parser, &count, readCoeffMono(in, correct));
+        } else if ((depth == 0) && ((a == '-') || ((a >= FIRST_NUMBER) && (a <= LAST_NUMBER)))) {
+            cursorUnget(in, a);
+            pushTerm(parser, &count, readConstMono(in, correct));
+        } else {
+            *correct = false;
+            break;
+        }
+        int c = cursorGet(in);
+        while (*correct && (c != '+')) {
+            if (depth == 0) {
+                if (c != '\n') {
+                    *correct = false;
+                    break;
+                }
+                cursorUnget(in, c);
+                return buildPoly(parser, 0, count);
+            }
+            if (c != ',') {
+                *correct = false;
+                break;
+            }
+            Poly coeff = buildPoly(parser, parser->levels[depth], count);
+            count = parser->levels[depth];
+            --depth;
+            poly_exp_t exp = readExp(in, correct);
+            if (cursorGet(in) != ')') {
+                *correct = false;
+            }
+            if (isZeroCoeff(&coeff)) {
+                exp = 0;
+            }
+            pushTerm(parser, &count, (Mono) {.p = coeff, .exp = exp});
+            c = cursorGet(in);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        MonoDestroy(&parser->terms[i]);
+    }
+    return PolyZero();
+}
+
+void parseLine(PolyParser *parser, Cursor *in, ParsedLine *res) {
+    int c = cursorGet(in);
+    if ((c == '#') || (c == '\n')) {
+        res->kind = LINE_EMPTY;
+        return;
+    }
+    cursorUnget(in, c);
+    if (isLetter(c)) {
+        res->kind = LINE_COMMAND;
+        return;
+    }
+    res->kind = LINE_POLY;
+    bool correct = true;
+    Poly p = readPoly(parser, in, &correct);
+    c = cursorGet(in);
+    if ((c != EOF) && (c != '\n')) {
+        correct = false;
+    }
+    if (!correct) {
+        PolyDestroy(&p);
+        p = PolyZero();
+    }
+    res->correct = correct;
+    res->poly = p;
+}
+
+void lineName(LineKind kind, const Cursor *line, bool correct, char *name, size_t size) {
+    const char *fixed = NULL;
+    if (kind == LINE_POLY) {
+        fixed = correct ? "POLY" : "WRONG POLY";
+    } else if (kind == LINE_EMPTY) {
+        fixed = "EMPTY";
+    } else if (!correct) {
+        fixed = "WRONG COMMAND";
+    }
+    size_t length = 0;
+    if (fixed != NULL) {
+        while ((fixed[length] != '\0') && (length < size - 1)) {
+            name[length] = fixed[length];
+            ++length;
+        }
+    } else {
+        while ((line->pos + length < line->end) && (length < size - 1) &&
+               (line->pos[length] != ' ') && (line->pos[length] != '\n')) {
+            name[length] = line->pos[length];
+            ++length;
+        }
+    }
+    name[length] = '\0';
+}
@@ -0,0 +1,115 @@
+/** @file
+  Interfejs parsera linii wejścia kalkulatora.
+  Parser rozpoznaje rodzaj linii i wczytuje wielomiany. Nie korzysta
+  ze stanu globalnego, więc każdy wątek może używać własnego parsera.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_PARSER_H
+#define POLYNOMIALS_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "input.h"
+#include "poly.h"
+
+/**
+ * Zwraca wartość true, jeśli na zmiennej @f$c@f$ zapisana jest mała lub wielka litera alfabetu angielskiego.
+ * Zwraca wartość false w przeciwnym przypadku.
+ * @param[in] c : znak
+ * @return Czy @c to litera?
+ */
+bool isLetter(int c);
+
+/**
+ * Wczytuje z kursora liczbę typu poly_coeff_t, poprzedzoną opcjonalnym minusem.
+ * Jeśli wczyta niedozwolony znak
+ * lub nastąpi przekroczenie zakresu typu poly_coeff_t,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * Sam minus jest traktowany jak zero.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return wczytana wartość
+ */
+poly_coeff_t readCoeff(Cursor *in, bool *correct);
+
+/**
+ * Wczytuje z kursora liczbę typu unsigned long.
+ * Jeśli wczyta niedozwolony znak
+ * lub nastąpi przekroczenie zakresu typu unsigned long,
+ * ustawia wartość zmiennej, na którą wskazuje wskaźnik @f$correct@f$, na false.
+ * @param[in,out] in : kursor
+ * @param[in,out] correct : wskaźnik na zmienną typu bool
+ * @return wczytana wartość
+ */
+unsigned long readUnsignedLong(Cursor *in, bool *correct);
+
+/**
+ * To jest struktura przechowująca pamięć roboczą parsera wielomianów.
+ * Jednomiany wszystkich otwartych poziomów zagnieżdżenia leżą kolejno
+ * w jednej tablicy @p terms, a @p levels pamięta, gdzie zaczynają się
+ * jednomiany każdego poziomu. Obie tablice są używane ponownie
+ * przy wczytywaniu kolejnych wielomianów.
+ */
+typedef struct {
+    Mono *terms; ///< jednomiany wczytywanych wielomianów
+    size_t termsLength; ///< rozmiar tablicy @p terms
+    size_t *levels; ///< indeksy pierwszych jednomianów otwartych poziomów
+    size_t levelsLength; ///< rozmiar tablicy @p levels
+} PolyParser;
+
+/**
+ * Tworzy parser wielomianów z pustą pamięcią roboczą.
+ * @return parser
+ */
+PolyParser newPolyParser(void);
+
+/**
+ * Usuwa z pamięci parser wielomianów.
+ * @param[in] parser : parser
+ */
+void freePolyParser(PolyParser *parser);
+
+/**
+ * To jest typ wyliczeniowy opisujący rodzaj linii wejścia.
+ */
+typedef enum {
+    LINE_EMPTY, ///< linia pusta lub komentarz
+    LINE_COMMAND, ///< linia z poleceniem
+    LINE_POLY ///< linia z wielomianem
+} LineKind;
+
+/**
+ * To jest struktura reprezentująca wynik analizy jednej linii wejścia.
+ */
+typedef struct {
+    LineKind kind; ///< rodzaj linii
+    bool correct; ///< czy wielomian jest poprawny
+    Poly poly; ///< wczytany wielomian, jeśli jest poprawny
+} ParsedLine;
+
+/**
+ * Rozpoznaje rodzaj linii i wczytuje z niej wielomian.
+ * Dla linii z poleceniem pozostawia kursor na początku linii,
+ * żeby polecenie mogło zostać wykonane później.
+ * @param[in,out] parser : parser
+ * @param[in,out] in : kursor na początku linii
+ * @param[out] res : wynik analizy linii
+ */
+void parseLine(PolyParser *parser, Cursor *in, ParsedLine *res);
+
+/**
+ * Wyznacza nazwę wykonanej linii, pod którą opisują ją statystyki
+ * i ślad wykonania: nazwę polecenia, POLY dla wielomianu, EMPTY dla
+ * linii pustej lub WRONG COMMAND i WRONG POLY dla błędnych linii.
+ * Nazwa dłuższa niż @p size - 1 znaków jest obcinana.
+ * @param[in] kind : rodzaj linii
+ * @param[in] line : kursor na początku linii
+ * @param[in] correct : czy linia była poprawna
+ * @param[out] name : bufor na nazwę
+ * @param[in] size : rozmiar bufora, dodatni
+ */
+void lineName(LineKind kind, const Cursor *line, bool correct, char *name, size_t size);
+
+#endif //POLYNOMIALS_PARSER_H
@@ -0,0 +1,253 @@
+/** @file
+  Implementacja liczników sprzętowych procesora przypisywanych poleceniom kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "perf.h"
+#include "additional_functions.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define MAX_NAME 16
+#define MAX_KINDS 64
+#define COUNTERS 5
+#define CYCLES 0
+#define INSTRUCTIONS 1
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/** Nazwy liczników w zestawieniu. */
+static const char *const counterNames[COUNTERS] = {
+        "CYCLES", "INSTRUCTIONS", "L1D_MISSES", "LLC_MISSES", "BRANCH_MISSES"
+};
+
+/**
+ * To jest struktura przechowująca sumy liczników jednego rodzaju linii.
+ */
+typedef struct {
+    char name[MAX_NAME]; ///< nazwa polecenia lub rodzaju linii
+    unsigned long calls; ///< liczba wykonań
+    uint64_t counts[COUNTERS]; ///< sumy przyrostów liczników
+} LineCounters;
+
+/** Sumy liczników rodzajów linii w kolejności pierwszego wystąpienia. */
+static LineCounters kinds[MAX_KINDS];
+/** Liczba rodzajów linii. */
+static size_t kindsCount;
+/** Czy liczniki są otwarte. */
+static bool counting = false;
+/** Pozycja licznika w odczycie grupy lub -1, jeśli licznika nie udało się otworzyć. */
+static int slots[COUNTERS];
+
+#ifdef __linux__
+
+/** Liczba otwartych liczników. */
+static size_t opened;
+/** Deskryptory otwartych liczników; pierwszy jest liderem grupy. */
+static int fds[COUNTERS];
+/** Wartości liczników na początku bieżącej linii. */
+static uint64_t startValues[COUNTERS];
+/** Czas włączenia grupy liczników na początku bieżącej linii. */
+static uint64_t startEnabled;
+/** Czas działania grupy liczników na początku bieżącej linii. */
+static uint64_t startRunning;
+
+/**
+ * To jest struktura odczytu grupy liczników w formacie
+ * PERF_FORMAT_GROUP z czasami włączenia i działania.
+ */
+typedef struct {
+    uint64_t count; ///< liczba wartości
+    uint64_t enabled; ///< czas włączenia grupy w nanosekundach
+    uint64_t running; ///< czas działania grupy w nanosekundach
+    uint64_t values[COUNTERS]; ///< wartości liczników w kolejności otwarcia
+} GroupRead;
+
+/**
+ * Otwiera licznik zdarzenia procesora dla bieżącego wątku.
+ * @param[in] type : typ zdarzenia
+ * @param[in] config : zdarzenie
+ * @param[in] group : deskryptor lidera grupy lub -1 dla nowej grupy
+ * @return deskryptor licznika lub -1
+ */
+static int openCounter(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+/**
+ * Odczytuje wartości grupy liczników.
+ * @param[out] group : odczyt
+ * @return Czy odczyt się udał?
+ */
+static bool readGroup(GroupRead *group) {
+    ssize_t size = read(fds[0], group, sizeof *group);
+    return (size >= (ssize_t) (3 * sizeof(uint64_t))) && (group->count == opened);
+}
+
+bool openCounters(void) {
+    static const uint32_t types[COUNTERS] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+    };
+    static const uint64_t configs[COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    opened = 0;
+    for (size_t i = 0; i < COUNTERS; ++i) {
+        int fd = openCounter(types[i], configs[i], opened == 0 ? -1 : fds[0]);
+        if (fd < 0) {
+            slots[i] = -1;
+        } else {
+            slots[i] = (int) opened;
+            fds[opened++] = fd;
+        }
+    }
+    counting = opened > 0;
+    return counting;
+}
+
+void closeCounters(void) {
+    for (size_t i = opened; i > 0; --i) {
+        close(fds[i - 1]);
+    }
+    opened = 0;
+    counting = false;
+}
+
+void countersBeginLine(void) {
+    GroupRead group;
+    if (!readGroup(&group)) {
+        startEnabled = startRunning = 0;
+        return;
+    }
+    startEnabled = group.enabled;
+    startRunning = group.running;
+    memcpy(startValues, group.values, opened * sizeof *startValues);
+}
+
+/**
+ * Znajduje sumy liczników rodzaju linii o podanej nazwie, w razie potrzeby
+ * je tworząc.
+ * @param[in] name : nazwa
+ * @return sumy liczników lub NULL, jeśli zabrakło miejsca na nowy rodzaj
+ */
+static LineCounters *findKind(const char *name) {
+    for (size_t i = 0; i < kindsCount; ++i) {
+        if (strcmp(kinds[i].name, name) == 0) {
+            return &kinds[i];
+        }
+    }
+    if (kindsCount == MAX_KINDS) {
+        return NULL;
+    }
+    LineCounters *k = &kinds[kindsCount++];
+    strcpy(k->name, name);
+    return k;
+}
+
+void countersEndLine(LineKind kind, const Cursor *line, bool correct) {
+    GroupRead group;
+    if (!readGroup(&group) || (kind == LINE_EMPTY)) {
+        return;
+    }
+    char name[MAX_NAME];
+    lineName(kind, line, correct, name, sizeof name);
+    LineCounters *k = findKind(name);
+    if (k == NULL) {
+        return;
+    }
+    ++k->calls;
+    uint64_t enabled = group.enabled - startEnabled;
+    uint64_t running = group.running - startRunning;
+    if (running == 0) {
+        return;
+    }
+    for (size_t i = 0; i < COUNTERS; ++i) {
+        if (slots[i] >= 0) {
+            uint64_t delta = group.values[slots[i]] - startValues[slots[i]];
+            if (running < enabled) {
+                delta = (uint64_t) ((double) delta * (double) enabled / (double) running);
+            }
+            k->counts[i] += delta;
+        }
+    }
+}
+
+#else
+
+bool openCounters(void) {
+    return false;
+}
+
+void closeCounters(void) {
+}
+
+void countersBeginLine(void) {
+}
+
+void countersEndLine(LineKind kind, const Cursor *line, bool correct) {
+    (void) kind;
+    (void) line;
+    (void) correct;
+}
+
+#endif /* __linux__ */
+
+bool isCounting(void) {
+    return counting;
+}
+
+char *formatCounters(void) {
+    char *text;
+    size_t size;
+    FILE *out = open_memstream(&text, &size);
+    CheckReallocOutcome(out);
+    fprintf(out, "%-15s %10s", "LINE", "CALLS");
+    for (size_t i = 0; i < COUNTERS; ++i) {
+        fprintf(out, " %14s", counterNames[i]);
+    }
+    fprintf(out, " %6s\n", "IPC");
+    for (size_t i = 0; i < kindsCount; ++i) {
+        const LineCounters *k = &kinds[i];
+        fprintf(out, "%-15s %10lu", k->name, k->calls);
+        for (size_t j = 0; j < COUNTERS; ++j) {
+            if (slots[j] >= 0) {
+                fprintf(out, " %14llu", (unsigned long long) k->counts[j]);
+            } else {
+                fprintf(out, " %14s", "-");
+            }
+        }
+        if ((slots[CYCLES] >= 0) && (slots[INSTRUCTIONS] >= 0) && (k->counts[CYCLES] > 0)) {
+            fprintf(out, " %6.2f\n", (double) k->counts[INSTRUCTIONS] / (double) k->counts[CYCLES]);
+        } else {
+            fprintf(out, " %6s\n", "-");
+        }
+    }
+    fclose(out);
+    return text;
+}
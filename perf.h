@@ -0,0 +1,70 @@
+/** @file
+  Interfejs liczników sprzętowych procesora przypisywanych poleceniom kalkulatora.
+
+  Po włączeniu liczników opcją @c -c kalkulator otwiera w systemie Linux
+  liczniki zdarzeń procesora (funkcja systemowa @c perf_event_open):
+  cykle, wykonane instrukcje, chybienia w pamięci podręcznej danych
+  pierwszego poziomu i ostatniego poziomu oraz błędnie przewidziane skoki.
+  Dla każdego rodzaju linii sumowane są przyrosty liczników podczas jej
+  wykonania. Liczniki mierzą tylko wątek wykonujący polecenia i tylko
+  kod użytkownika, więc wczytywanie wielomianów w innych wątkach
+  w trybach @c -j i @c -p nie jest wliczane.
+
+  Licznik, którego nie udało się otworzyć (np. w kontenerze lub maszynie
+  wirtualnej bez dostępu do jednostki monitorowania wydajności), jest
+  pomijany i w zestawieniu ma wartość @c -. Jeśli nie udało się otworzyć
+  żadnego licznika lub system nie jest Linuksem, kalkulator działa dalej
+  bez pomiarów. Gdy jądro przełącza liczniki, bo jest ich więcej niż
+  rejestrów procesora, przyrosty są skalowane proporcjonalnie do czasu,
+  w którym liczniki działały.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_PERF_H
+#define POLYNOMIALS_PERF_H
+
+#include <stdbool.h>
+#include "input.h"
+#include "parser.h"
+
+/**
+ * Otwiera liczniki sprzętowe dla bieżącego wątku.
+ * @return Czy udało się otworzyć choć jeden licznik?
+ */
+bool openCounters(void);
+
+/**
+ * Zamyka liczniki. Nic nie robi, jeśli liczniki nie są otwarte.
+ */
+void closeCounters(void);
+
+/**
+ * Sprawdza, czy liczniki są otwarte.
+ * @return Czy liczniki są otwarte?
+ */
+bool isCounting(void);
+
+/**
+ * Odczytuje liczniki na początku wykonania linii.
+ */
+void countersBeginLine(void);
+
+/**
+ * Odczytuje liczniki na końcu wykonania linii i dolicza ich przyrosty
+ * od wywołania countersBeginLine do rodzaju linii.
+ * @param[in] kind : rodzaj linii
+ * @param[in] line : kursor na początku linii
+ * @param[in] correct : czy linia była poprawna
+ */
+void countersEndLine(LineKind kind, const Cursor *line, bool correct);
+
+/**
+ * Tworzy tekstowe zestawienie liczników, po jednej linii na rodzaj
+ * linii wejścia.
+ * @return zestawienie, do zwolnienia funkcją free
+ */
+char *formatCounters(void);
+
+#endif //POLYNOMIALS_PERF_H
@@ -0,0 +1,99 @@
+/** @file
+  Implementacja potokowego trybu pracy kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "pipeline.h"
+#include "additional_functions.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define JOBS_CAPACITY 1024
+#define REPORTS_CAPACITY 4096
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * Główna funkcja wątku analizującego: wczytuje linie, wczytuje z nich
+ * wielomiany i przekazuje je dalej. Na końcu wejścia zamyka bufor.
+ * @param[in,out] arg : potok
+ * @return NULL
+ */
+static void *parserThread(void *arg) {
+    Pipeline *pipeline = arg;
+    PolyParser parser = newPolyParser();
+    Cursor in;
+    int line = 1;
+    while (nextLine(pipeline->reader, &in)) {
+        Job job = {.line = line, .text = NULL, .length = 0};
+        parseLine(&parser, &in, &job.parsed);
+        if (job.parsed.kind == LINE_COMMAND) {
+            job.length = (size_t) (in.end - in.pos);
+            job.text = malloc(job.length);
+            CheckReallocOutcome(job.text);
+            memcpy(job.text, in.pos, job.length);
+        }
+        ringPush(&pipeline->jobs, &job);
+        ++line;
+    }
+    ringClose(&pipeline->jobs);
+    freePolyParser(&parser);
+    return NULL;
+}
+
+/**
+ * Główna funkcja wątku formatującego: wypisuje wyniki w kolejności,
+ * w jakiej przyszły. Zanim zaśnie na pustym buforze, opróżnia bufor
+ * wyjścia, żeby odpowiedzi nie czekały na kolejne polecenia.
+ * @param[in,out] arg : potok
+ * @return NULL
+ */
+static void *printerThread(void *arg) {
+    Pipeline *pipeline = arg;
+    Report r;
+    while (true) {
+        if (!ringTryPop(&pipeline->reports, &r)) {
+            flushOutput(pipeline->out);
+            if (!ringPop(&pipeline->reports, &r)) {
+                break;
+            }
+        }
+        writeReport(pipeline->out, &r);
+    }
+    flushOutput(pipeline->out);
+    return NULL;
+}
+
+void startPipeline(Pipeline *pipeline, LineReader *reader, Output *out) {
+    initRing(&pipeline->jobs, sizeof(Job), JOBS_CAPACITY);
+    initRing(&pipeline->reports, sizeof(Report), REPORTS_CAPACITY);
+    pipeline->reader = reader;
+    pipeline->out = out;
+    pipeline->reporter = (Reporter) {.out = out, .ring = &pipeline->reports};
+    pthread_create(&pipeline->parser, NULL, parserThread, pipeline);
+    pthread_create(&pipeline->printer, NULL, printerThread, pipeline);
+}
+
+bool nextJob(Pipeline *pipeline, Job *job) {
+    return ringPop(&pipeline->jobs, job);
+}
+
+Cursor jobCursor(const Job *job) {
+    return (Cursor) {.pos = job->text, .end = job->text + job->length};
+}
+
+void finishJob(Job *job) {
+    free(job->text);
+    job->text = NULL;
+}
+
+void stopPipeline(Pipeline *pipeline) {
+    pthread_join(pipeline->parser, NULL);
+    ringClose(&pipeline->reports);
+    pthread_join(pipeline->printer, NULL);
+    freeRing(&pipeline->jobs);
+    freeRing(&pipeline->reports);
+}
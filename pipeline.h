@@ -0,0 +1,86 @@
+/** @file
+  Interfejs potokowego trybu pracy kalkulatora.
+  Wczytywanie i analiza linii, wykonywanie poleceń oraz formatowanie wyników
+  odbywają się w trzech wątkach połączonych ograniczonymi buforami
+  cyklicznymi. Każdy etap przetwarza dane w kolejności linii,
+  więc kolejność wyników się nie zmienia.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_PIPELINE_H
+#define POLYNOMIALS_PIPELINE_H
+
+#include <pthread.h>
+#include "input.h"
+#include "output.h"
+#include "parser.h"
+#include "report.h"
+#include "ring.h"
+
+/**
+ * To jest struktura reprezentująca przeanalizowaną linię przekazywaną
+ * do wykonania. Tekst linii z poleceniem jest kopiowany, bo czytnik
+ * może go nadpisać, zanim polecenie zostanie wykonane.
+ */
+typedef struct {
+    int line; ///< numer linii
+    ParsedLine parsed; ///< wynik analizy linii
+    char *text; ///< kopia linii z poleceniem lub NULL
+    size_t length; ///< długość kopii linii
+} Job;
+
+/**
+ * To jest struktura reprezentująca potok.
+ * Wątek analizujący wstawia linie do @p jobs, wątek wykonujący polecenia
+ * pobiera je i wstawia wyniki do @p reports, z których korzysta
+ * wątek formatujący.
+ */
+typedef struct {
+    Ring jobs; ///< przeanalizowane linie czekające na wykonanie
+    Ring reports; ///< wyniki czekające na wypisanie
+    LineReader *reader; ///< czytnik linii
+    Output *out; ///< bufor wyjścia, używany tylko przez wątek formatujący
+    Reporter reporter; ///< odbiorca wyników dla wątku wykonującego polecenia
+    pthread_t parser; ///< wątek analizujący
+    pthread_t printer; ///< wątek formatujący
+} Pipeline;
+
+/**
+ * Uruchamia wątek analizujący i wątek formatujący.
+ * Czytnik nie może opróżniać bufora wyjścia, bo ten należy
+ * do wątku formatującego.
+ * @param[out] pipeline : potok
+ * @param[in,out] reader : czytnik linii
+ * @param[in,out] out : bufor wyjścia
+ */
+void startPipeline(Pipeline *pipeline, LineReader *reader, Output *out);
+
+/**
+ * Pobiera kolejną przeanalizowaną linię.
+ * @param[in,out] pipeline : potok
+ * @param[out] job : linia
+ * @return Czy pobrano linię? Wartość false oznacza koniec wejścia.
+ */
+bool nextJob(Pipeline *pipeline, Job *job);
+
+/**
+ * Daje kursor na początku linii z poleceniem.
+ * @param[in] job : linia
+ * @return kursor
+ */
+Cursor jobCursor(const Job *job);
+
+/**
+ * Zwalnia kopię tekstu linii.
+ * @param[in,out] job : wykonana linia
+ */
+void finishJob(Job *job);
+
+/**
+ * Czeka na wypisanie wszystkich wyników i kończy pracę wątków potoku.
+ * @param[in,out] pipeline : potok
+ */
+void stopPipeline(Pipeline *pipeline);
+
+#endif //POLYNOMIALS_PIPELINE_H
@@ -9,8 +9,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 #include "poly.h"
 #include "additional_functions.h"
+#include "poly_trace.h"
+#include "poly_stats.h"
 
 /** Zwraca większą wartość. */
 static size_t max(size_t a, size_t b) {
@@ -21,6 +27,113 @@ static size_t max(size_t a, size_t b) {
     }
 }
 
+/**
+ * Zgłasza odbiorcy śledzenia zakończone wywołanie funkcji (zob. poly_trace.h).
+ * @param[in] name : nazwa funkcji
+ * @param[in] start : czas rozpoczęcia wywołania
+ * @param[in] firstName : nazwa pierwszego rozmiaru
+ * @param[in] first : pierwszy rozmiar argumentu
+ * @param[in] secondName : nazwa drugiego rozmiaru
+ * @param[in] second : drugi rozmiar argumentu
+ * @param[in] res : wynik
+ */
+static void Trace(const char *name, double start, const char *firstName, size_t first,
+                  const char *secondName, size_t second, const Poly *res) {
+    PolyTraceSpan span = {
+        .name = name, .start = start, .end = PolyTraceClock(),
+        .firstName = firstName, .first = first, .secondName = secondName, .second = second,
+        .result = PolyTraceSize(res)
+    };
+    PolyTraceTarget(&span);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define WALK_LOCAL_FRAMES 64
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca tablicę jednomianów odłożoną
+ * do przejścia, razem z numerem następnego jednomianu.
+ */
+typedef struct {
+    Mono *arr; ///< tablica jednomianów
+    const Mono *other; ///< tablica przechodzona równolegle lub NULL
+    size_t size; ///< liczba jednomianów
+    size_t index; ///< numer następnego jednomianu
+    poly_exp_t value; ///< wartość liczona dla tablicy
+} WalkFrame;
+
+/**
+ * To jest struktura reprezentująca jawny stos przechodzenia drzewa
+ * wielomianu. Funkcje, które bez niej byłyby rekurencyjne, odkładają
+ * na nim tablice jednomianów zamiast wywoływać się dla współczynników,
+ * więc głęboko zagnieżdżone wielomiany nie wyczerpują stosu wywołań.
+ * Przejścia, których kolejność nie ma znaczenia, zdejmują tablicę
+ * ze stosu od razu i obsługują ją w całości; przejścia, które wracają
+ * do rodzica z wynikiem, trzymają ją na stosie z numerem następnego
+ * jednomianu. Pierwsze ramki leżą w samej strukturze, więc przejście
+ * płytkiego wielomianu nie przydziela pamięci.
+ */
+typedef struct {
+    WalkFrame *frames; ///< ramki, @p local lub tablica na stercie
+    size_t depth; ///< liczba ramek na stosie
+    size_t length; ///< rozmiar tablicy @p frames
+    WalkFrame local[WALK_LOCAL_FRAMES]; ///< ramki dla płytkich wielomianów
+} Walk;
+
+/**
+ * Rozpoczyna przechodzenie od tablicy jednomianów wielomianu @f$p@f$.
+ * @param[out] w : stos przechodzenia
+ * @param[in] p : wielomian z tablicą jednomianów
+ * @param[in] other : wielomian przechodzony równolegle lub NULL
+ */
+static void WalkStart(Walk *w, const Poly *p, const Poly *other) {
+    w->frames = w->local;
+    w->length = WALK_LOCAL_FRAMES;
+    w->depth = 1;
+    w->local[0] = (WalkFrame) {
+        .arr = p->arr, .other = other == NULL ? NULL : other->arr, .size = p->size,
+        .index = 0, .value = 0
+    };
+}
+
+/**
+ * Odkłada na stos przechodzenia tablicę jednomianów wielomianu @f$p@f$.
+ * Unieważnia wskaźniki na ramki.
+ * @param[in,out] w : stos przechodzenia
+ * @param[in] p : wielomian z tablicą jednomianów
+ * @param[in] other : wielomian przechodzony równolegle lub NULL
+ */
+static void WalkPush(Walk *w, const Poly *p, const Poly *other) {
+    if (w->depth == w->length) {
+        w->length = more(w->length);
+        if (w->frames == w->local) {
+            w->frames = malloc(w->length * sizeof *w->frames);
+            CheckReallocOutcome(w->frames);
+            memcpy(w->frames, w->local, sizeof w->local);
+        } else {
+            w->frames = realloc(w->frames, w->length * sizeof *w->frames);
+            CheckReallocOutcome(w->frames);
+        }
+    }
+    w->frames[w->depth++] = (WalkFrame) {
+        .arr = p->arr, .other = other == NULL ? NULL : other->arr, .size = p->size,
+        .index = 0, .value = 0
+    };
+}
+
+/**
+ * Kończy przechodzenie i zwalnia pamięć stosu.
+ * @param[in,out] w : stos przechodzenia
+ */
+static void WalkEnd(Walk *w) {
+    if (w->frames != w->local) {
+        free(w->frames);
+    }
+}
+
 /**
  * Sumuje dwie tablice jedmonianów w jedną.
  * @param[in] p : tablica jednomianów @f$p@f$
@@ -104,6 +217,8 @@ static Mono *AddExpZero(const Mono *m, size_t *size, poly_coeff_t coeff) {
 
 static bool MonoSimplify(const Mono *m, poly_coeff_t *coeff);
 
+static Mono MonoFromCoeff(poly_coeff_t coeff);
+
 /**
  * Sprawdza, czy wielomian @f$p@f$ da się uprościć do wspólczynnika.
  * Jeśli tak, zapisuje na wskaźniku wartość współczynnika.
@@ -242,6 +357,144 @@ Poly PolyAdd(const Poly *p, const Poly *q) {
     return new;
 }
 
+/**
+ * Sumuje tablicę jednomianów @f$p@f$ z tablicą jednomianów @f$q@f$ pomnożoną
+ * przez stałą @f$c@f$, przenosząc jednomiany zamiast je kopiować.
+ * Mnożenie przez @f$c@f$ odbywa się w trakcie scalania tablic.
+ * Przejmuje na własność obie tablice wraz z zawartością.
+ * @param[in] p : tablica jednomianów @f$p@f$
+ * @param[in] size_p : liczba jednomianów w tablicy @f$p@f$
+ * @param[in] q : tablica jednomianów @f$q@f$
+ * @param[in] size_q : liczba jednomianów w tablicy @f$q@f$
+ * @param[in] c : mnożnik tablicy @f$q@f$
+ * @param[in] new_size : liczba jednomianów w tablicy wynikowej
+ * @return tablica jednomianów
+ */
+static Mono *AddTwoMonoArraysOwn(Mono *p, size_t size_p, Mono *q, size_t size_q, poly_coeff_t c,
+                                 size_t *new_size) {
+    Mono *new = malloc((size_p + size_q) * sizeof *new);
+    size_t index_p = 0;
+    size_t index_q = 0;
+    size_t i = 0;
+    while ((index_p < size_p) && (index_q < size_q)) {
+        if (p[index_p].exp == q[index_q].exp) {
+            new[i].exp = p[index_p].exp;
+            new[i].p = PolyAddScaledOwn(&p[index_p].p, &q[index_q].p, c);
+            ++index_p;
+            ++index_q;
+        } else if (p[index_p].exp < q[index_q].exp) {
+            new[i] = p[index_p];
+            ++index_p;
+        } else {
+            new[i].exp = q[index_q].exp;
+            new[i].p = PolyScaleOwn(&q[index_q].p, c);
+            ++index_q;
+        }
+        if (!PolyIsZero(&new[i].p)) {
+            ++i;
+        } else {
+            PolyDestroy(&new[i].p);
+        }
+    }
+    while (index_p < size_p) {
+        new[i] = p[index_p];
+        ++i;
+        ++index_p;
+    }
+    while (index_q < size_q) {
+        new[i].exp = q[index_q].exp;
+        new[i].p = PolyScaleOwn(&q[index_q].p, c);
+        if ((c == 1) || !PolyIsZero(&new[i].p)) {
+            ++i;
+        } else {
+            PolyDestroy(&new[i].p);
+        }
+        ++index_q;
+    }
+    free(p);
+    free(q);
+    *new_size = i;
+    if (i == 0) {
+        free(new);
+        return NULL;
+    }
+    return new;
+}
+
+/**
+ * Dodaje stałą do wielomianu, który nie jest współczynnikiem.
+ * Przejmuje na własność zawartość wielomianu @f$p@f$.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] coeff : stała
+ * @return @f$p + coeff@f$
+ */
+static Poly PolyAddCoeffOwn(Poly *p, poly_coeff_t coeff) {
+    if (coeff == 0) {
+        if (PolyIsZero(p)) {
+            PolyDestroy(p);
+            return PolyZero();
+        }
+        return *p;
+    }
+    if (PolyHasExpZero(p)) {
+        Poly c = PolyFromCoeff(coeff);
+        Poly temp = PolyAddOwn(&p->arr[0].p, &c);
+        if (PolyIsZero(&temp)) {
+            PolyDestroy(&temp);
+            if (p->size == 1) {
+                free(p->arr);
+                return PolyZero();
+            }
+            --p->size;
+            memmove(p->arr, p->arr + 1, p->size * sizeof *p->arr);
+        } else {
+            p->arr[0].p = temp;
+        }
+        return *p;
+    }
+    p->arr = realloc(p->arr, (p->size + 1) * sizeof *p->arr);
+    CheckReallocOutcome(p->arr);
+    memmove(p->arr + 1, p->arr, p->size * sizeof *p->arr);
+    p->arr[0] = MonoFromCoeff(coeff);
+    ++p->size;
+    return *p;
+}
+
+Poly PolyAddOwn(Poly *p, Poly *q) {
+    return PolyAddScaledOwn(p, q, 1);
+}
+
+Poly PolyAddScaledOwn(Poly *p, Poly *q, poly_coeff_t c) {
+    if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
+        return PolyFromCoeff(p->coeff + c * q->coeff);
+    }
+    if (PolyIsCoeff(p)) {
+        Poly scaled = PolyScaleOwn(q, c);
+        if (PolyIsCoeff(&scaled)) {
+            return PolyFromCoeff(p->coeff + scaled.coeff);
+        }
+        return PolyAddCoeffOwn(&scaled, p->coeff);
+    }
+    if (PolyIsCoeff(q)) {
+        return PolyAddCoeffOwn(p, c * q->coeff);
+    }
+    Poly new;
+    size_t new_size;
+    new.arr = AddTwoMonoArraysOwn(p->arr, p->size, q->arr, q->size, c, &new_size);
+    new.size = new_size;
+    if (new_size == 0) {
+        new = PolyZero();
+    } else if ((new.arr[0].exp == 0) && (new.size == 1)) {
+        poly_coeff_t coeff;
+        if (MonoSimplify(&new.arr[0], &coeff)) {
+            PolyDestroy(&new.arr[0].p);
+            free(new.arr);
+            new = PolyFromCoeff(coeff);
+        }
+    }
+    return new;
+}
+
 /**
  * Porównuje wykładniki dwóch jednomianów.
  * Zwraca 1, jeśli wykładnik @f$a@f$ jest większy od wykładnika @f$b@f$.
@@ -271,37 +524,62 @@ Poly PolyAddMonos(size_t count, const Mono monos[]) {
     return PolyOwnMonos(count, copy);
 }
 
-Poly PolyOwnMonos(size_t count, Mono *monos) {
+/**
+ * Sprawdza, czy jednomiany są już w postaci, którą zwróciłaby funkcja
+ * PolyOwnMonos: żaden nie jest zerowy, a wykładniki rosną ściśle.
+ * @param[in] count : liczba jednomianów
+ * @param[in] monos : tablica jednomianów
+ * @return Czy tablica nie wymaga sortowania ani łączenia jednomianów?
+ */
+static bool MonosAreCanonical(size_t count, const Mono *monos) {
+    for (size_t i = 0; i < count; ++i) {
+        if (PolyIsZero(&monos[i].p) || ((i > 0) && (monos[i - 1].exp >= monos[i].exp))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Implementacja PolyOwnMonos, bez śledzenia.
+ * @param[in] count : liczba jednomianów
+ * @param[in] monos : tablica jednomianów
+ * @return wielomian będący sumą jednomianów
+ */
+static Poly OwnMonos(size_t count, Mono *monos) {
     if ((count <= 0) || (monos == NULL)) {
         return PolyZero();
     }
+    if (MonosAreCanonical(count, monos)) {
+        if ((count == 1) && (monos[0].exp == 0) && (monos[0].p.arr == NULL)) {
+            Poly res = monos[0].p;
+            free(monos);
+            return res;
+        }
+        return (Poly) {.size = count, .arr = monos};
+    }
     qsort((void *) monos, count, sizeof(Mono), CompareMono);
     Poly new;
     size_t length = count;
     Mono *arr = malloc(length * sizeof *arr);
-    size_t index_m = 1;
+    size_t index_m = 0;
     size_t i = 1;
-    if (PolyIsZero(&monos[0].p)) {
-        PolyDestroy(&monos[0].p);
-        if (count == 1) {
-            free(monos);
-            free(arr);
-            return PolyZero();
-        } else {
-            arr[0] = monos[1];
-            ++index_m;
-        }
-    } else {
-        arr[0] = monos[0];
+    while ((index_m < count) && PolyIsZero(&monos[index_m].p)) {
+        PolyDestroy(&monos[index_m].p);
+        ++index_m;
+    }
+    if (index_m == count) {
+        free(monos);
+        free(arr);
+        return PolyZero();
     }
+    arr[0] = monos[index_m];
+    ++index_m;
     while (index_m < (count - 1)) {
         LengthenArrayIfNecessary(&arr, &length, i);
         Mono mono;
         if (monos[index_m].exp == monos[index_m + 1].exp) {
-            Poly p = PolyAdd(&monos[index_m].p, &monos[index_m + 1].p);
-            PolyDestroy(&monos[index_m].p);
-            PolyDestroy(&monos[index_m + 1].p);
-            mono.p = p;
+            mono.p = PolyAddOwn(&monos[index_m].p, &monos[index_m + 1].p);
             mono.exp = monos[index_m].exp;
             index_m = index_m + 2;
         } else {
@@ -312,10 +590,7 @@ Poly PolyOwnMonos(size_t count, Mono *monos) {
         if (!PolyIsZero(&mono.p)) {
             if (i > 0) {
                 if (arr[i - 1].exp == mono.exp) {
-                    Poly temp = arr[i - 1].p;
-                    arr[i - 1].p = PolyAdd(&arr[i - 1].p, &mono.p);
-                    PolyDestroy(&temp);
-                    PolyDestroy(&mono.p);
+                    arr[i - 1].p = PolyAddOwn(&arr[i - 1].p, &mono.p);
                     if (PolyIsZero(&arr[i - 1].p)) {
                         PolyDestroy(&arr[i - 1].p);
                         --i;
@@ -333,11 +608,8 @@ Poly PolyOwnMonos(size_t count, Mono *monos) {
         }
     }
     if (index_m == count - 1) {
-        if (arr[i - 1].exp == monos[index_m].exp) {
-            Poly temp = arr[i - 1].p;
-            arr[i - 1].p = PolyAdd(&arr[i - 1].p, &monos[index_m].p);
-            PolyDestroy(&temp);
-            PolyDestroy(&monos[index_m].p);
+        if ((i > 0) && (arr[i - 1].exp == monos[index_m].exp)) {
+            arr[i - 1].p = PolyAddOwn(&arr[i - 1].p, &monos[index_m].p);
             if (PolyIsZero(&arr[i - 1].p)) {
                 PolyDestroy(&arr[i - 1].p);
                 --i;
@@ -367,6 +639,16 @@ Poly PolyOwnMonos(size_t count, Mono *monos) {
     return new;
 }
 
+Poly PolyOwnMonos(size_t count, Mono *monos) {
+    if (PolyTraceTarget == NULL) {
+        return OwnMonos(count, monos);
+    }
+    double start = PolyTraceClock();
+    Poly res = OwnMonos(count, monos);
+    Trace("PolyOwnMonos", start, "count", count, NULL, 0, &res);
+    return res;
+}
+
 Poly PolyCloneMonos(size_t count, const Mono monos[]) {
     if ((count <= 0) || (monos == NULL)) {
         return PolyZero();
@@ -384,79 +666,308 @@ Poly PolyCloneMonos(size_t count, const Mono monos[]) {
  * @return Czy wielomian jest stały?
  */
 bool PolyIsConst(const Poly *p) {
-    if (p->size != 1) {
-        return false;
+    while (true) {
+        if ((p->size != 1) || (p->arr[0].exp != 0)) {
+            return false;
+        }
+        if (p->arr[0].p.arr == NULL) {
+            return true;
+        }
+        p = &p->arr[0].p;
     }
-    if (p->arr[0].exp != 0) {
-        return false;
+}
+
+static poly_coeff_t PolyGetCoeff(const Poly *p);
+
+/**
+ * Sprawdza równość dwóch wielomianów, z których co najmniej jeden
+ * jest współczynnikiem.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p = q@f$
+ */
+static bool CoeffIsEq(const Poly *p, const Poly *q) {
+    if ((p->arr == NULL) && (q->arr == NULL)) {
+        return (p->coeff == q->coeff);
     }
-    if (p->arr[0].p.arr != NULL) {
-        return PolyIsConst(&p->arr[0].p);
+    if (p->arr == NULL) {
+        return PolyIsConst(q) && (PolyGetCoeff(q) == p->coeff);
     }
-    return true;
+    return PolyIsConst(p) && (PolyGetCoeff(p) == q->coeff);
 }
 
 /**
- * Sprawdza równość dwóch jednomianów.
+ * Sprawdza równość dwóch jednomianów, nie porównując ich współczynników,
+ * które mają tablice jednomianów tej samej długości.
+ * Takie współczynniki trzeba porównać osobno.
  * @param[in] m1 : jednomian @f$m_1@f$
  * @param[in] m2 : jednomian @f$m_2@f$
- * @return @f$m_1 = m_2@f$
+ * @param[out] descend : czy trzeba porównać współczynniki
+ * @return Czy jednomiany mogą być równe?
  */
-static bool MonoIsEqual(const Mono *m1, const Mono *m2) {
+static bool MonoIsEqual(const Mono *m1, const Mono *m2, bool *descend) {
+    *descend = false;
     if (m1->exp != m2->exp) {
         return false;
     }
-    return (PolyIsEq(&m1->p, &m2->p));
+    if ((m1->p.arr == NULL) && (m2->p.arr == NULL)) {
+        return (m1->p.coeff == m2->p.coeff);
+    }
+    if ((m1->p.arr == NULL) || (m2->p.arr == NULL)) {
+        return CoeffIsEq(&m1->p, &m2->p);
+    }
+    *descend = true;
+    return (m1->p.size == m2->p.size);
 }
 
-static poly_coeff_t PolyGetCoeff(const Poly *p);
-
-/**
- * Sprawdza równość dwóch wielomianów.
- * @param[in] p : wielomian @f$p@f$
- * @param[in] q : wielomian @f$q@f$
- * @return @f$p = q@f$
- */
 bool PolyIsEq(const Poly *p, const Poly *q) {
-    if ((p->arr == NULL) && (q->arr == NULL)) {
-        return (p->coeff == q->coeff);
+    if ((p->arr == NULL) || (q->arr == NULL)) {
+        return CoeffIsEq(p, q);
     }
-    if ((p->arr == NULL) && (q->arr != NULL)) {
-        if (!PolyIsConst(q)) {
-            return false;
+    if (p->size != q->size) {
+        return false;
+    }
+    Walk w;
+    WalkStart(&w, p, q);
+    bool equal = true;
+    while (equal && (w.depth > 0)) {
+        WalkFrame f = w.frames[--w.depth];
+        for (size_t i = 0; equal && (i < f.size); ++i) {
+            bool descend;
+            equal = MonoIsEqual(&f.arr[i], &f.other[i], &descend);
+            if (equal && descend) {
+                WalkPush(&w, &f.arr[i].p, &f.other[i].p);
+            }
         }
-        if (PolyGetCoeff(q) != p->coeff) {
-            return false;
+    }
+    WalkEnd(&w);
+    return equal;
+}
+
+void PolyDestroy(Poly *p) {
+    if (p->arr == NULL) {
+        return;
+    }
+    Walk w;
+    WalkStart(&w, p, NULL);
+    while (w.depth > 0) {
+        WalkFrame f = w.frames[--w.depth];
+        for (size_t i = 0; i < f.size; ++i) {
+            if (f.arr[i].p.arr != NULL) {
+                WalkPush(&w, &f.arr[i].p, NULL);
+            }
         }
-        return true;
+        free(f.arr);
     }
-    if ((p->arr != NULL) && (q->arr == NULL)) {
-        if (!PolyIsConst(p)) {
-            return false;
+    WalkEnd(&w);
+}
+
+Poly PolyClone(const Poly *p) {
+    if (p->arr == NULL) {
+        return PolyFromCoeff(p->coeff);
+    }
+    Poly new = {.size = p->size, .arr = malloc(p->size * sizeof(Mono))};
+    CheckReallocOutcome(new.arr);
+    memcpy(new.arr, p->arr, p->size * sizeof(Mono));
+    Walk w;
+    WalkStart(&w, &new, NULL);
+    while (w.depth > 0) {
+        WalkFrame f = w.frames[--w.depth];
+        for (size_t i = 0; i < f.size; ++i) {
+            Poly *child = &f.arr[i].p;
+            if (child->arr == NULL) {
+                continue;
+            }
+            Mono *arr = malloc(child->size * sizeof *arr);
+            CheckReallocOutcome(arr);
+            memcpy(arr, child->arr, child->size * sizeof *arr);
+            child->arr = arr;
+            WalkPush(&w, child, NULL);
         }
-        if (PolyGetCoeff(p) != q->coeff) {
-            return false;
+    }
+    WalkEnd(&w);
+    return new;
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define COMPACT_INITIAL_FRAMES 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca tablicę jednomianów skopiowaną już
+ * do bloku, której współczynniki są właśnie przenoszone.
+ */
+typedef struct {
+    Mono *arr; ///< tablica w bloku
+    size_t size; ///< liczba jednomianów
+    size_t index; ///< numer przenoszonego współczynnika
+} CompactFrame;
+
+/**
+ * Liczy wszystkie jednomiany wielomianu, na wszystkich poziomach.
+ * @param[in] p : wielomian
+ * @return liczba jednomianów
+ */
+static size_t CountMonos(const Poly *p) {
+    if (p->arr == NULL) {
+        return 0;
+    }
+    size_t total = 0;
+    Walk w;
+    WalkStart(&w, p, NULL);
+    while (w.depth > 0) {
+        WalkFrame f = w.frames[--w.depth];
+        total += f.size;
+        for (size_t i = 0; i < f.size; ++i) {
+            if (f.arr[i].p.arr != NULL) {
+                WalkPush(&w, &f.arr[i].p, NULL);
+            }
         }
-        return true;
     }
-    if (p->size != q->size) {
-        return false;
+    WalkEnd(&w);
+    return total;
+}
+
+Poly PolyCompact(const Poly *p) {
+    if (p->arr == NULL) {
+        return *p;
+    }
+    Mono *block = malloc(CountMonos(p) * sizeof *block);
+    CheckReallocOutcome(block);
+    memcpy(block, p->arr, p->size * sizeof *block);
+    size_t next = p->size;
+    size_t length = COMPACT_INITIAL_FRAMES;
+    CompactFrame *frames = malloc(length * sizeof *frames);
+    CheckReallocOutcome(frames);
+    size_t depth = 0;
+    frames[depth++] = (CompactFrame) {.arr = block, .size = p->size, .index = 0};
+    while (depth > 0) {
+        CompactFrame *frame = &frames[depth - 1];
+        if (frame->index == frame->size) {
+            --depth;
+            continue;
+        }
+        Poly *child = &frame->arr[frame->index].p;
+        ++frame->index;
+        if (child->arr == NULL) {
+            continue;
+        }
+        Mono *arr = block + next;
+        memcpy(arr, child->arr, child->size * sizeof *arr);
+        next += child->size;
+        child->arr = arr;
+        if (depth == length) {
+            length = more(length);
+            frames = realloc(frames, length * sizeof *frames);
+            CheckReallocOutcome(frames);
+        }
+        frames[depth++] = (CompactFrame) {.arr = arr, .size = child->size, .index = 0};
     }
-    for (size_t i = 0; i < p->size; ++i) {
-        if (!MonoIsEqual(&p->arr[i], &q->arr[i])) {
-            return false;
+    free(frames);
+    return (Poly) {.size = p->size, .arr = block};
+}
+
+void PolyCompactDestroy(Poly *p) {
+    free(p->arr);
+}
+
+/**
+ * Liczy zapas pamięci bloku ponad podany rozmiar.
+ * @param[in] block : blok przydzielony funkcją malloc lub realloc
+ * @param[in] used : używana część bloku w bajtach
+ * @return zapas w bajtach lub zero, jeśli nie da się go zmierzyć
+ */
+static size_t Slack(const void *block, size_t used) {
+#ifdef __GLIBC__
+    return malloc_usable_size((void *) block) - used;
+#else
+    (void) block;
+    (void) used;
+    return 0;
+#endif
+}
+
+/**
+ * Liczy tablice, jednomiany i używaną pamięć wielomianu, a jeśli trzeba,
+ * także zapas każdej z tablic.
+ * @param[in] p : wielomian
+ * @param[in] separate : czy tablice są osobnymi blokami pamięci
+ * @return pamięć wielomianu
+ */
+static PolyMemory MeasureMemory(const Poly *p, bool separate) {
+    PolyMemory memory = {.bytes = 0, .wasted = 0, .arrays = 0, .monos = 0};
+    if (p->arr == NULL) {
+        return memory;
+    }
+    Walk w;
+    WalkStart(&w, p, NULL);
+    while (w.depth > 0) {
+        WalkFrame f = w.frames[--w.depth];
+        ++memory.arrays;
+        memory.monos += f.size;
+        memory.bytes += f.size * sizeof(Mono);
+        if (separate) {
+            memory.wasted += Slack(f.arr, f.size * sizeof(Mono));
+        }
+        for (size_t i = 0; i < f.size; ++i) {
+            if (f.arr[i].p.arr != NULL) {
+                WalkPush(&w, &f.arr[i].p, NULL);
+            }
         }
     }
-    return true;
+    WalkEnd(&w);
+    return memory;
 }
 
-void PolyDestroy(Poly *p) {
+PolyMemory PolyMemoryUsage(const Poly *p) {
+    return MeasureMemory(p, true);
+}
+
+PolyMemory PolyCompactMemoryUsage(const Poly *p) {
+    PolyMemory memory = MeasureMemory(p, false);
     if (p->arr != NULL) {
-        for (size_t i = 0; i < p->size; ++i) {
-            MonoDestroy(&p->arr[i]);
+        memory.wasted = Slack(p->arr, memory.bytes);
+    }
+    return memory;
+}
+
+/**
+ * Zmniejsza tablicę jednomianów wielomianu do potrzebnego rozmiaru,
+ * jeśli ma ona zapas (zob. PolyShrinkToFit).
+ * @param[in,out] p : wielomian z tablicą jednomianów
+ */
+static void ShrinkArray(Poly *p) {
+#ifdef __GLIBC__
+    if (Slack(p->arr, p->size * sizeof(Mono)) < sizeof(Mono)) {
+        return;
+    }
+#endif
+    Mono *arr = realloc(p->arr, p->size * sizeof *arr);
+    if (arr != NULL) {
+        p->arr = arr;
+    }
+}
+
+void PolyShrinkToFit(Poly *p) {
+    if (p->arr == NULL) {
+        return;
+    }
+    ShrinkArray(p);
+    Walk w;
+    WalkStart(&w, p, NULL);
+    while (w.depth > 0) {
+        WalkFrame f = w.frames[--w.depth];
+        for (size_t i = 0; i < f.size; ++i) {
+            Poly *child = &f.arr[i].p;
+            if (child->arr != NULL) {
+                ShrinkArray(child);
+                WalkPush(&w, child, NULL);
+            }
         }
-        free(p->arr);
     }
+    WalkEnd(&w);
 }
 
 /**
@@ -485,7 +996,13 @@ static Mono MonoCoeffMul(const Mono *m, const Poly *coeff) {
     return new;
 }
 
-Poly PolyMul(const Poly *p, const Poly *q) {
+/**
+ * Implementacja PolyMul, bez śledzenia.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p * q@f$
+ */
+static Poly Mul(const Poly *p, const Poly *q) {
     if ((p->arr == NULL) && (q->arr == NULL)) {
         return PolyFromCoeff(p->coeff * q->coeff);
     }
@@ -552,13 +1069,115 @@ Poly PolyMul(const Poly *p, const Poly *q) {
             ++index;
         }
     }
-    new = PolyAddMonos(index, arr);
-    free(arr);
-    return new;
+    return PolyOwnMonos(index, arr);
 }
 
-/**
- * Zwraca przeciwny jednomian.
+Poly PolyMul(const Poly *p, const Poly *q) {
+    if (PolyTraceTarget == NULL) {
+        return Mul(p, q);
+    }
+    double start = PolyTraceClock();
+    Poly res = Mul(p, q);
+    Trace("PolyMul", start, "p", PolyTraceSize(p), "q", PolyTraceSize(q), &res);
+    return res;
+}
+
+/**
+ * Mnoży wielomian, który nie jest współczynnikiem, przez stałą.
+ * Przejmuje na własność zawartość wielomianu @f$p@f$ i mnoży jego
+ * współczynniki w miejscu.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] coeff : stała
+ * @return @f$p * coeff@f$
+ */
+static Poly PolyMulCoeffOwn(Poly *p, poly_coeff_t coeff) {
+    if (coeff == 0) {
+        PolyDestroy(p);
+        return PolyZero();
+    }
+    size_t index = 0;
+    for (size_t index_p = 0; index_p < p->size; ++index_p) {
+        Poly c = PolyFromCoeff(coeff);
+        Mono temp;
+        temp.exp = p->arr[index_p].exp;
+        temp.p = PolyMulOwn(&p->arr[index_p].p, &c);
+        if (!PolyIsZero(&temp.p)) {
+            p->arr[index] = temp;
+            ++index;
+        } else {
+            PolyDestroy(&temp.p);
+        }
+    }
+    if (index == 0) {
+        free(p->arr);
+        return PolyZero();
+    }
+    p->size = index;
+    return *p;
+}
+
+/**
+ * Implementacja PolyMulOwn, bez śledzenia.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p * q@f$
+ */
+static Poly MulOwn(Poly *p, Poly *q) {
+    if ((p->arr == NULL) && (q->arr == NULL)) {
+        return PolyFromCoeff(p->coeff * q->coeff);
+    }
+    if (p->arr == NULL) {
+        return PolyMulCoeffOwn(q, p->coeff);
+    }
+    if (q->arr == NULL) {
+        return PolyMulCoeffOwn(p, q->coeff);
+    }
+    size_t index = 0;
+    Mono *arr = malloc(p->size * q->size * sizeof *arr);
+    for (size_t index_p = 0; index_p < p->size; ++index_p) {
+        for (size_t index_q = 0; index_q < q->size; ++index_q) {
+            arr[index] = MonoMul(&p->arr[index_p], &q->arr[index_q]);
+            ++index;
+        }
+    }
+    PolyDestroy(p);
+    PolyDestroy(q);
+    return PolyOwnMonos(index, arr);
+}
+
+Poly PolyMulOwn(Poly *p, Poly *q) {
+    if (PolyTraceTarget == NULL) {
+        return MulOwn(p, q);
+    }
+    size_t sizeP = PolyTraceSize(p);
+    size_t sizeQ = PolyTraceSize(q);
+    double start = PolyTraceClock();
+    Poly res = MulOwn(p, q);
+    Trace("PolyMulOwn", start, "p", sizeP, "q", sizeQ, &res);
+    return res;
+}
+
+Poly PolySqr(const Poly *p) {
+    if (p->arr == NULL) {
+        return PolyFromCoeff(p->coeff * p->coeff);
+    }
+    size_t index = 0;
+    Mono *arr = malloc(p->size * (p->size + 1) / 2 * sizeof *arr);
+    for (size_t i = 0; i < p->size; ++i) {
+        arr[index].exp = p->arr[i].exp + p->arr[i].exp;
+        arr[index].p = PolySqr(&p->arr[i].p);
+        ++index;
+        for (size_t j = i + 1; j < p->size; ++j) {
+            arr[index] = MonoMul(&p->arr[i], &p->arr[j]);
+            arr[index].p = PolyScaleOwn(&arr[index].p, 2);
+            ++index;
+        }
+    }
+    return PolyOwnMonos(index, arr);
+}
+
+/**
+ * Zwraca przeciwny jednomian.
  * @param[in] m : jednomian @f$m@f$
  * @return @f$-m@f$
  */
@@ -588,10 +1207,40 @@ Poly PolyNeg(const Poly *p) {
     return new;
 }
 
+Poly PolyNegOwn(Poly *p) {
+    if (PolyIsZero(p)) {
+        PolyDestroy(p);
+        return PolyZero();
+    }
+    if (p->arr == NULL) {
+        poly_coeff_t neg = -1;
+        return PolyFromCoeff(neg * p->coeff);
+    }
+    for (size_t i = 0; i < p->size; ++i) {
+        p->arr[i].p = PolyNegOwn(&p->arr[i].p);
+    }
+    return *p;
+}
+
+Poly PolyScaleOwn(Poly *p, poly_coeff_t c) {
+    if (c == 1) {
+        return *p;
+    }
+    if (c == -1) {
+        return PolyNegOwn(p);
+    }
+    Poly k = PolyFromCoeff(c);
+    return PolyMulOwn(p, &k);
+}
+
 Poly PolySub(const Poly *p, const Poly *q) {
-    Poly q_neg = PolyNeg(q);
-    Poly new = PolyAdd(p, &q_neg);
-    PolyDestroy(&q_neg);
+    Poly p_copy = PolyClone(p);
+    Poly q_copy = PolyClone(q);
+    return PolySubOwn(&p_copy, &q_copy);
+}
+
+Poly PolySubOwn(Poly *p, Poly *q) {
+    Poly new = PolyAddScaledOwn(p, q, -1);
     if (PolyIsZero(&new)) {
         PolyDestroy(&new);
         return PolyZero();
@@ -622,10 +1271,26 @@ static poly_exp_t PolyDegByHelper(const Poly *p, size_t var_idx) {
         return p->arr[p->size - 1].exp;
     }
     poly_exp_t maximum = 0;
-    for (size_t i = 0; i < p->size; ++i) {
-        poly_exp_t new = PolyDegByHelper(&p->arr[i].p, var_idx - 1);
-        maximum = max_poly_exp_t(maximum, new);
+    Walk w;
+    WalkStart(&w, p, NULL);
+    while (w.depth > 0) {
+        WalkFrame *f = &w.frames[w.depth - 1];
+        if (f->index == f->size) {
+            --w.depth;
+            continue;
+        }
+        const Poly *child = &f->arr[f->index].p;
+        ++f->index;
+        if (child->arr == NULL) {
+            continue;
+        }
+        if (w.depth == var_idx) {
+            maximum = max_poly_exp_t(maximum, child->arr[child->size - 1].exp);
+        } else {
+            WalkPush(&w, child, NULL);
+        }
     }
+    WalkEnd(&w);
     return maximum;
 }
 
@@ -645,12 +1310,31 @@ static poly_exp_t PolyDegHelper(const Poly *p) {
     if (p->arr == NULL) {
         return 0;
     }
-    poly_exp_t maximum = 0;
-    for (size_t i = 0; i < p->size; ++i) {
-        poly_exp_t new = p->arr[i].exp + PolyDegHelper(&p->arr[i].p);
-        maximum = max_poly_exp_t(maximum, new);
+    Walk w;
+    WalkStart(&w, p, NULL);
+    poly_exp_t degree = 0;
+    while (w.depth > 0) {
+        WalkFrame *f = &w.frames[w.depth - 1];
+        size_t i = f->index;
+        while ((i < f->size) && (f->arr[i].p.arr == NULL)) {
+            f->value = max_poly_exp_t(f->value, f->arr[i].exp);
+            ++i;
+        }
+        if (i < f->size) {
+            f->index = i + 1;
+            WalkPush(&w, &f->arr[i].p, NULL);
+            continue;
+        }
+        degree = f->value;
+        --w.depth;
+        if (w.depth > 0) {
+            WalkFrame *parent = &w.frames[w.depth - 1];
+            poly_exp_t new = parent->arr[parent->index - 1].exp + degree;
+            parent->value = max_poly_exp_t(parent->value, new);
+        }
     }
-    return maximum;
+    WalkEnd(&w);
+    return degree;
 }
 
 poly_exp_t PolyDeg(const Poly *p) {
@@ -681,12 +1365,12 @@ static bool PolyIsSimple(const Poly *p) {
  * @return wspólczynnik wielomianu @f$p@f$
  */
 static poly_coeff_t PolyGetCoeff(const Poly *p) {
-    if (p->arr == NULL) {
-        return p->coeff;
+    while (p->arr != NULL) {
+        assert(p->size == 1);
+        assert(p->arr[0].exp == 0);
+        p = &p->arr[0].p;
     }
-    assert(p->size == 1);
-    assert(p->arr[0].exp == 0);
-    return PolyGetCoeff(&p->arr[0].p);
+    return p->coeff;
 }
 
 /**
@@ -759,8 +1443,55 @@ Poly PolyAt(const Poly *p, poly_coeff_t x) {
     return res;
 }
 
+Poly PolyAtOwn(Poly *p, poly_coeff_t x) {
+    if ((p->arr == NULL) || PolyIsSimple(p)) {
+        Poly res = PolyAt(p, x);
+        PolyDestroy(p);
+        return res;
+    }
+    size_t length = p->size;
+    Mono *arr = malloc(length * sizeof *arr);
+    size_t index_arr = 0;
+    for (size_t index_p = 0; index_p < p->size; ++index_p) {
+        LengthenArrayIfNecessary(&arr, &length, index_arr);
+        poly_coeff_t a = Power(x, p->arr[index_p].exp);
+        if (PolyDeg(&p->arr[index_p].p) == 0) {
+            poly_coeff_t coeff = PolyGetCoeff(&p->arr[index_p].p);
+            PolyDestroy(&p->arr[index_p].p);
+            arr[index_arr] = MonoFromCoeff(coeff * a);
+            ++index_arr;
+        } else {
+            Poly A = PolyFromCoeff(a);
+            Poly temp = PolyMulOwn(&p->arr[index_p].p, &A);
+            for (size_t index_temp = 0; index_temp < temp.size; ++index_temp, ++index_arr) {
+                LengthenArrayIfNecessary(&arr, &length, index_arr);
+                arr[index_arr] = temp.arr[index_temp];
+            }
+            free(temp.arr);
+        }
+    }
+    free(p->arr);
+    if (index_arr == 0) {
+        free(arr);
+        return PolyZero();
+    }
+    return PolyOwnMonos(index_arr, arr);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/* Progi wyboru algorytmu potęgowania, dobrane pomiarami z bench/pow_bench.c. */
+#define POW_MULTINOMIAL_MAX_TERMS 3
+#define POW_MULTINOMIAL_MAX_EXP 512
+#define POW_SPARSE_DENSITY 8
+#define POW_DENSE_DENSITY 4
+#define POW_DENSE_MAX_LENGTH (1 << 22)
+#define KARATSUBA_THRESHOLD 32
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
 /**
- * Podnosi wielomian @f$p@f$ do potęgi @f$exp@f$.
+ * Podnosi wielomian @f$p@f$ do potęgi @f$exp@f$ przez podnoszenie do kwadratu.
  * @param[in] p : wielomian @f$p@f$
  * @param[in] exp : wykładnik @f$exp@f$
  * @return @f$p^{exp}@f$
@@ -782,14 +1513,580 @@ static Poly PowerPoly(const Poly *p, poly_exp_t exp) {
             PolyDestroy(&help);
         }
         exp = exp / 2;
+        if (exp == 0) {
+            break;
+        }
         help = x;
-        x = PolyMul(&x, &x);
+        x = PolySqr(&x);
         PolyDestroy(&help);
     }
     PolyDestroy(&x);
     return res;
 }
 
+/**
+ * Podnosi wielomian @f$p@f$ do potęgi @f$exp@f$ przez wielokrotne mnożenie
+ * przez podstawę. Dla wielomianów rzadkich, w których potęgach prawie nic się
+ * nie redukuje, jest to tańsze niż podnoszenie do kwadratu.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] exp : wykładnik @f$exp@f$, większy od zera
+ * @return @f$p^{exp}@f$
+ */
+static Poly PowerPolyRepeated(const Poly *p, poly_exp_t exp) {
+    Poly res = PolyClone(p);
+    for (poly_exp_t i = 1; i < exp; ++i) {
+        Poly help = res;
+        res = PolyMul(&res, p);
+        PolyDestroy(&help);
+    }
+    return res;
+}
+
+/**
+ * Liczy odwrotność liczby nieparzystej modulo @f$2^{64}@f$ metodą Newtona.
+ * @param[in] a : liczba nieparzysta
+ * @return @f$a^{-1} \bmod 2^{64}@f$
+ */
+static unsigned long InverseOdd(unsigned long a) {
+    unsigned long x = a;
+    for (int i = 0; i < 6; ++i) {
+        x *= 2 - a * x;
+    }
+    return x;
+}
+
+/**
+ * Wylicza kolejny współczynnik dwumianowy @f$\binom{n}{k}@f$ z poprzedniego
+ * w arytmetyce współczynników (modulo @f$2^{64}@f$). Dzielenie jest dokładne,
+ * bo potęgi dwójki są liczone osobno, a przez część nieparzystą mnoży się
+ * jej odwrotnością. Przed wyliczeniem @f$\binom{n}{1}@f$ część nieparzysta
+ * musi być równa 1, a wykładnik dwójki 0.
+ * @param[in] n : górny indeks
+ * @param[in] k : dolny indeks, od 1 do @f$n@f$
+ * @param[in,out] odd : część nieparzysta @f$\binom{n}{k - 1}@f$
+ * @param[in,out] twos : wykładnik potęgi dwójki w @f$\binom{n}{k - 1}@f$
+ * @return @f$\binom{n}{k}@f$
+ */
+static poly_coeff_t NextBinomial(poly_exp_t n, poly_exp_t k, unsigned long *odd, int *twos) {
+    unsigned long num = (unsigned long) (n - k + 1);
+    unsigned long den = (unsigned long) k;
+    while (num % 2 == 0) {
+        num /= 2;
+        ++*twos;
+    }
+    while (den % 2 == 0) {
+        den /= 2;
+        --*twos;
+    }
+    *odd = *odd * num * InverseOdd(den);
+    return (*twos >= 64) ? 0 : (poly_coeff_t) (*odd << *twos);
+}
+
+/**
+ * Podnosi jednomian @f$m = c x^e@f$ do potęgi @f$n@f$. Wynikiem jest
+ * @f$c^n x^{e n}@f$, więc wystarczy podnieść do potęgi sam współczynnik.
+ * Wykładnik jest liczony modulo @f$2^{32}@f$, tak jak przy wielokrotnym
+ * mnożeniu jednomianów.
+ * @param[in] m : jednomian @f$m@f$
+ * @param[in] n : wykładnik @f$n@f$
+ * @return @f$m^n@f$
+ */
+static Mono MonoPower(const Mono *m, poly_exp_t n) {
+    return (Mono) {.p = PolyPow(&m->p, n), .exp = (poly_exp_t) ((unsigned) m->exp * (unsigned) n)};
+}
+
+/**
+ * Podnosi wielomian o jednym jednomianie do potęgi @f$n@f$ (zob. MonoPower).
+ * Koszt zależy tylko od współczynnika, a nie od wykładnika wyniku.
+ * @param[in] p : wielomian @f$p@f$ o jednym jednomianie
+ * @param[in] n : wykładnik @f$n@f$, większy od zera
+ * @return @f$p^n@f$
+ */
+static Poly PowerPolySingle(const Poly *p, poly_exp_t n) {
+    Mono *arr = malloc(sizeof *arr);
+    arr[0] = MonoPower(&p->arr[0], n);
+    return PolyOwnMonos(1, arr);
+}
+
+/**
+ * Usuwa z tablicy jednomiany zerowe i tworzy z pozostałych wielomian.
+ * Przejmuje na własność tablicę @p monos wraz z zawartością.
+ * @param[in] count : liczba jednomianów
+ * @param[in] monos : tablica jednomianów
+ * @return wielomian będący sumą jednomianów
+ */
+static Poly PolyOwnNonZeroMonos(size_t count, Mono *monos) {
+    size_t i = 0;
+    for (size_t j = 0; j < count; ++j) {
+        if (PolyIsZero(&monos[j].p)) {
+            PolyDestroy(&monos[j].p);
+        } else {
+            monos[i] = monos[j];
+            ++i;
+        }
+    }
+    if (i == 0) {
+        free(monos);
+        return PolyZero();
+    }
+    return PolyOwnMonos(i, monos);
+}
+
+/**
+ * Podnosi wielomian @f$p@f$ do potęgi @f$n@f$ rozwijając
+ * @f$(m + r)^n = \sum_j \binom{n}{j} m^{n - j} r^j@f$, gdzie @f$m@f$ to pierwszy
+ * jednomian wielomianu, a @f$r@f$ to pozostałe. Potęgi @f$r@f$ i współczynniki
+ * dwumianowe liczone są przyrostowo, a potęgi jednomianu @f$m@f$ wprost
+ * (zob. MonoPower), więc dla wielomianów o kilku jednomianach nie powstają
+ * duże iloczyny pośrednie ani tablice długości @f$n@f$.
+ * @param[in] p : wielomian @f$p@f$ o co najmniej dwóch jednomianach
+ * @param[in] n : wykładnik @f$n@f$, większy od zera
+ * @return @f$p^n@f$
+ */
+static Poly PowerPolyMultinomial(const Poly *p, poly_exp_t n) {
+    const Mono *m = &p->arr[0];
+    Poly r = {.size = p->size - 1, .arr = p->arr + 1};
+    size_t length = p->size;
+    size_t index = 0;
+    Mono *arr = malloc(length * sizeof *arr);
+    Poly r_pow = PolyFromCoeff(1);
+    unsigned long odd = 1;
+    int twos = 0;
+    poly_coeff_t binom = 1;
+    for (poly_exp_t j = 0; j <= n; ++j) {
+        if (j > 0) {
+            binom = NextBinomial(n, j, &odd, &twos);
+        }
+        Mono term = MonoPower(m, n - j);
+        term.p = PolyScaleOwn(&term.p, binom);
+        if (r_pow.arr == NULL) {
+            LengthenArrayIfNecessary(&arr, &length, index);
+            arr[index] = (Mono) {.p = PolyMulOwn(&term.p, &r_pow), .exp = term.exp};
+            ++index;
+        } else {
+            for (size_t i = 0; i < r_pow.size; ++i) {
+                LengthenArrayIfNecessary(&arr, &length, index);
+                arr[index] = MonoMul(&term, &r_pow.arr[i]);
+                ++index;
+            }
+            MonoDestroy(&term);
+        }
+        if (j < n) {
+            Poly help = r_pow;
+            r_pow = PolyMul(&r_pow, &r);
+            PolyDestroy(&help);
+        }
+    }
+    PolyDestroy(&r_pow);
+    return PolyOwnNonZeroMonos(index, arr);
+}
+
+/**
+ * Mnoży dwie gęste tablice współczynników długości @f$n@f$ algorytmem
+ * Karatsuby; poniżej progu KARATSUBA_THRESHOLD mnoży szkolnie. Jeśli @f$a = b@f$,
+ * korzysta z symetrii kwadratu. Arytmetyka jest modulo @f$2^{64}@f$, tak jak
+ * przy mnożeniu współczynników w PolyMul.
+ * @param[in] a : tablica współczynników @f$a@f$
+ * @param[in] b : tablica współczynników @f$b@f$
+ * @param[in] n : długość tablic @f$a@f$ i @f$b@f$
+ * @param[out] res : tablica długości @f$2n - 1@f$ na iloczyn
+ */
+static void DenseMul(const unsigned long *a, const unsigned long *b, size_t n, unsigned long *res) {
+    bool square = (a == b);
+    if (n <= KARATSUBA_THRESHOLD) {
+        memset(res, 0, (2 * n - 1) * sizeof *res);
+        for (size_t i = 0; i < n; ++i) {
+            if (square) {
+                res[2 * i] += a[i] * a[i];
+                for (size_t j = i + 1; j < n; ++j) {
+                    res[i + j] += 2 * a[i] * a[j];
+                }
+            } else {
+                for (size_t j = 0; j < n; ++j) {
+                    res[i + j] += a[i] * b[j];
+                }
+            }
+        }
+        return;
+    }
+    size_t low = n / 2;
+    size_t high = n - low;
+    unsigned long *sum_a = calloc(high, sizeof *sum_a);
+    unsigned long *sum_b = square ? sum_a : calloc(high, sizeof *sum_b);
+    unsigned long *mid = malloc((2 * high - 1) * sizeof *mid);
+    for (size_t i = 0; i < high; ++i) {
+        sum_a[i] = a[low + i] + ((i < low) ? a[i] : 0);
+        if (!square) {
+            sum_b[i] = b[low + i] + ((i < low) ? b[i] : 0);
+        }
+    }
+    memset(res, 0, (2 * n - 1) * sizeof *res);
+    DenseMul(a, square ? a : b, low, res);
+    DenseMul(a + low, square ? a + low : b + low, high, res + 2 * low);
+    DenseMul(sum_a, sum_b, high, mid);
+    for (size_t i = 0; i < 2 * low - 1; ++i) {
+        mid[i] -= res[i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; ++i) {
+        mid[i] -= res[2 * low + i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; ++i) {
+        res[low + i] += mid[i];
+    }
+    if (!square) {
+        free(sum_b);
+    }
+    free(sum_a);
+    free(mid);
+}
+
+/**
+ * Mnoży dwie gęste tablice współczynników o dowolnych długościach,
+ * dopełniając krótszą zerami.
+ * @param[in] a : tablica współczynników @f$a@f$
+ * @param[in] len_a : długość tablicy @f$a@f$
+ * @param[in] b : tablica współczynników @f$b@f$
+ * @param[in] len_b : długość tablicy @f$b@f$
+ * @param[out] res : tablica długości co najmniej @f$2 \max(len_a, len_b) - 1@f$ na iloczyn
+ */
+static void DenseMulPadded(const unsigned long *a, size_t len_a, const unsigned long *b, size_t len_b,
+                           unsigned long *res) {
+    if (len_a == len_b) {
+        DenseMul(a, b, len_a, res);
+        return;
+    }
+    if (len_a < len_b) {
+        DenseMulPadded(b, len_b, a, len_a, res);
+        return;
+    }
+    unsigned long *pad = calloc(len_a, sizeof *pad);
+    memcpy(pad, b, len_b * sizeof *pad);
+    DenseMul(a, pad, len_a, res);
+    free(pad);
+}
+
+/**
+ * Podnosi do potęgi wielomian jednej zmiennej o stałych współczynnikach,
+ * przechowując potęgi pośrednie jako gęste tablice współczynników.
+ * @param[in] p : wielomian @f$p@f$ o współczynnikach będących stałymi
+ * @param[in] exp : wykładnik @f$exp@f$, większy od zera
+ * @return @f$p^{exp}@f$
+ */
+static Poly PowerPolyDense(const Poly *p, poly_exp_t exp) {
+    size_t length = (size_t) p->arr[p->size - 1].exp * (size_t) exp + 1;
+    unsigned long *x = calloc(length, sizeof *x);
+    unsigned long *res = calloc(length, sizeof *res);
+    unsigned long *help = malloc(2 * length * sizeof *help);
+    for (size_t i = 0; i < p->size; ++i) {
+        x[p->arr[i].exp] = (unsigned long) p->arr[i].p.coeff;
+    }
+    size_t x_len = (size_t) p->arr[p->size - 1].exp + 1;
+    size_t res_len = 1;
+    res[0] = 1;
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            DenseMulPadded(res, res_len, x, x_len, help);
+            res_len = res_len + x_len - 1;
+            memcpy(res, help, res_len * sizeof *res);
+        }
+        exp = exp / 2;
+        if (exp == 0) {
+            break;
+        }
+        DenseMul(x, x, x_len, help);
+        x_len = 2 * x_len - 1;
+        memcpy(x, help, x_len * sizeof *x);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < res_len; ++i) {
+        count += (res[i] != 0);
+    }
+    Poly new = PolyZero();
+    if ((count == 1) && (res[0] != 0)) {
+        new = PolyFromCoeff((poly_coeff_t) res[0]);
+    } else if (count > 0) {
+        new.size = count;
+        new.arr = malloc(count * sizeof *new.arr);
+        size_t index = 0;
+        for (size_t i = 0; i < res_len; ++i) {
+            if (res[i] != 0) {
+                new.arr[index].p = PolyFromCoeff((poly_coeff_t) res[i]);
+                new.arr[index].exp = (poly_exp_t) i;
+                ++index;
+            }
+        }
+    }
+    free(x);
+    free(res);
+    free(help);
+    return new;
+}
+
+/**
+ * Sprawdza, czy wielomian jest wielomianem jednej zmiennej o stałych
+ * współczynnikach, którego potęga zmieści się w gęstej tablicy.
+ * @param[in] p : wielomian @f$p@f$, który nie jest współczynnikiem
+ * @param[in] exp : wykładnik
+ * @return Czy wielomian można potęgować na gęstych tablicach?
+ */
+static bool PolyFitsDense(const Poly *p, poly_exp_t exp) {
+    size_t deg = (size_t) p->arr[p->size - 1].exp;
+    if ((deg == 0) || (deg * (size_t) exp + 1 > POW_DENSE_MAX_LENGTH)) {
+        return false;
+    }
+    for (size_t i = 0; i < p->size; ++i) {
+        if (p->arr[i].p.arr != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Wybiera algorytm potęgowania na podstawie liczby jednomianów i gęstości
+ * wielomianu. Gęstość to stosunek liczby jednomianów do stopnia ze względu
+ * na główną zmienną. Rozwinięcie wielomianowe liczy tyle składników,
+ * ile wynosi wykładnik, więc jest wybierane tylko dla małych wykładników.
+ * @param[in] p : wielomian @f$p@f$ o co najmniej dwóch jednomianach
+ * @param[in] exp : wykładnik @f$exp@f$
+ * @return algorytm potęgowania
+ */
+static PolyPowMethod ChoosePowMethod(const Poly *p, poly_exp_t exp) {
+    size_t length = (size_t) p->arr[p->size - 1].exp + 1;
+    if ((p->size * POW_DENSE_DENSITY >= length) && PolyFitsDense(p, exp)) {
+        return POLY_POW_DENSE;
+    }
+    if ((p->size <= POW_MULTINOMIAL_MAX_TERMS) && (exp <= POW_MULTINOMIAL_MAX_EXP)) {
+        return POLY_POW_MULTINOMIAL;
+    }
+    if (p->size * POW_SPARSE_DENSITY < length) {
+        return POLY_POW_REPEATED;
+    }
+    return POLY_POW_BINARY;
+}
+
+Poly PolyPowWith(const Poly *p, poly_exp_t exp, PolyPowMethod method) {
+    assert(exp >= 0);
+    if (exp == 0) {
+        return PolyFromCoeff(1);
+    }
+    if (PolyIsZero(p)) {
+        return PolyZero();
+    }
+    if (p->arr == NULL) {
+        return PolyFromCoeff(Power(p->coeff, exp));
+    }
+    if (p->size == 1) {
+        return PowerPolySingle(p, exp);
+    }
+    if (method == POLY_POW_AUTO) {
+        method = ChoosePowMethod(p, exp);
+    }
+    switch (method) {
+        case POLY_POW_REPEATED:
+            return PowerPolyRepeated(p, exp);
+        case POLY_POW_MULTINOMIAL:
+            return PowerPolyMultinomial(p, exp);
+        case POLY_POW_DENSE:
+            if (PolyFitsDense(p, exp)) {
+                return PowerPolyDense(p, exp);
+            }
+            return PowerPoly(p, exp);
+        default:
+            return PowerPoly(p, exp);
+    }
+}
+
+Poly PolyPow(const Poly *p, poly_exp_t exp) {
+    return PolyPowWith(p, exp, POLY_POW_AUTO);
+}
+
+/**
+ * Zwraca najmniejszy stopień jednomianu wielomianu,
+ * który nie jest tożsamościowo równy zeru.
+ * @param[in] p : wielomian
+ * @return najmniejszy stopień jednomianu wielomianu @p p
+ */
+static poly_exp_t PolyMinDegHelper(const Poly *p) {
+    if (p->arr == NULL) {
+        return 0;
+    }
+    poly_exp_t minimum = -1;
+    for (size_t i = 0; i < p->size; ++i) {
+        poly_exp_t new = p->arr[i].exp + PolyMinDegHelper(&p->arr[i].p);
+        if ((minimum < 0) || (new < minimum)) {
+            minimum = new;
+        }
+    }
+    return minimum;
+}
+
+/**
+ * Zwraca najmniejszy stopień jednomianu wielomianu.
+ * Dla wielomianu tożsamościowo równego zeru zwraca @f$-1@f$.
+ * @param[in] p : wielomian
+ * @return najmniejszy stopień jednomianu wielomianu @p p
+ */
+static poly_exp_t PolyMinDeg(const Poly *p) {
+    if (PolyIsZero(p)) {
+        return -1;
+    }
+    return PolyMinDegHelper(p);
+}
+
+Poly PolyTrunc(const Poly *p, poly_exp_t maxdeg) {
+    if ((maxdeg < 0) || PolyIsZero(p)) {
+        return PolyZero();
+    }
+    if (PolyDeg(p) <= maxdeg) {
+        return PolyClone(p);
+    }
+    Mono *monos = malloc(p->size * sizeof *monos);
+    size_t count = 0;
+    for (size_t i = 0; (i < p->size) && (p->arr[i].exp <= maxdeg); ++i) {
+        monos[count].p = PolyTrunc(&p->arr[i].p, maxdeg - p->arr[i].exp);
+        monos[count].exp = p->arr[i].exp;
+        ++count;
+    }
+    return PolyOwnNonZeroMonos(count, monos);
+}
+
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t maxdeg) {
+    if ((maxdeg < 0) || PolyIsZero(p) || PolyIsZero(q)) {
+        return PolyZero();
+    }
+    if ((long) PolyDeg(p) + PolyDeg(q) <= maxdeg) {
+        return PolyMul(p, q);
+    }
+    if (p->arr == NULL) {
+        Poly coeff = *p;
+        Poly trunc = PolyTrunc(q, maxdeg);
+        return PolyMulOwn(&coeff, &trunc);
+    }
+    if (q->arr == NULL) {
+        Poly coeff = *q;
+        Poly trunc = PolyTrunc(p, maxdeg);
+        return PolyMulOwn(&trunc, &coeff);
+    }
+    size_t length = p->size + q->size;
+    Mono *monos = malloc(length * sizeof *monos);
+    size_t count = 0;
+    for (size_t i = 0; (i < p->size) && (p->arr[i].exp <= maxdeg); ++i) {
+        for (size_t j = 0; j < q->size; ++j) {
+            long exp = (long) p->arr[i].exp + q->arr[j].exp;
+            if (exp > maxdeg) {
+                break;
+            }
+            LengthenArrayIfNecessary(&monos, &length, count);
+            monos[count].p = PolyMulTrunc(&p->arr[i].p, &q->arr[j].p,
+                                          maxdeg - (poly_exp_t) exp);
+            monos[count].exp = (poly_exp_t) exp;
+            ++count;
+        }
+    }
+    return PolyOwnNonZeroMonos(count, monos);
+}
+
+/**
+ * Podnosi wielomian @f$p@f$ do potęgi @f$exp@f$ przez podnoszenie do kwadratu,
+ * pomijając jednomiany stopnia większego niż @f$maxdeg@f$.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] exp : wykładnik @f$exp@f$
+ * @param[in] maxdeg : największy zachowywany stopień
+ * @return @f$p^{exp}@f$ obcięty do stopnia @f$maxdeg@f$
+ */
+static Poly PowerPolyTrunc(const Poly *p, poly_exp_t exp, poly_exp_t maxdeg) {
+    if (maxdeg < 0) {
+        return PolyZero();
+    }
+    if (exp == 0) {
+        return PolyFromCoeff(1);
+    }
+    poly_exp_t min_deg = PolyMinDeg(p);
+    if ((min_deg < 0) || ((long) min_deg * exp > maxdeg)) {
+        return PolyZero();
+    }
+    if ((long) PolyDeg(p) * exp <= maxdeg) {
+        return PolyPow(p, exp);
+    }
+    Poly res = PolyFromCoeff(1);
+    Poly base = PolyTrunc(p, maxdeg);
+    while (true) {
+        if (exp % 2 == 1) {
+            Poly help = PolyMulTrunc(&res, &base, maxdeg);
+            PolyDestroy(&res);
+            res = help;
+        }
+        exp /= 2;
+        if (exp == 0) {
+            break;
+        }
+        Poly help = PolyMulTrunc(&base, &base, maxdeg);
+        PolyDestroy(&base);
+        base = help;
+    }
+    PolyDestroy(&base);
+    return res;
+}
+
+static Poly PolyComposeTruncHelperII(const Poly *p, size_t k, const Poly q[],
+                                     size_t depth, poly_exp_t maxdeg);
+
+/**
+ * Funkcja pomocnicza funkcji PolyComposeTrunc.
+ * @param[in] m : jednomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in] q : tablica wielomianów
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in] maxdeg : największy zachowywany stopień
+ */
+static Poly PolyComposeTruncHelperI(const Mono *m, size_t k, const Poly q[],
+                                    size_t depth, poly_exp_t maxdeg) {
+    Poly help = PolyZero();
+    Poly composed = PowerPolyTrunc((depth >= k) ? &help : &q[depth], m->exp, maxdeg);
+    if (PolyIsZero(&composed)) {
+        return composed;
+    }
+    Poly p = PolyComposeTruncHelperII(&m->p, k, q, depth + 1,
+                                      maxdeg - PolyMinDeg(&composed));
+    Poly res = PolyMulTrunc(&p, &composed, maxdeg);
+    PolyDestroy(&p);
+    PolyDestroy(&composed);
+    return res;
+}
+
+/**
+ * Funkcja pomocnicza funkcji PolyComposeTrunc.
+ * Jednomiany są uporządkowane rosnąco względem wykładników, więc gdy
+ * najmniejszy stopień potęgi podstawianego wielomianu przekroczy @f$maxdeg@f$,
+ * pozostałe jednomiany można pominąć.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in] q : tablica wielomianów
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in] maxdeg : największy zachowywany stopień
+ */
+static Poly PolyComposeTruncHelperII(const Poly *p, size_t k, const Poly q[],
+                                     size_t depth, poly_exp_t maxdeg) {
+    if ((maxdeg < 0) || (p->arr == NULL)) {
+        return PolyTrunc(p, maxdeg);
+    }
+    poly_exp_t min_deg = (depth >= k) ? -1 : PolyMinDeg(&q[depth]);
+    Poly res = PolyZero();
+    for (size_t i = 0; i < p->size; ++i) {
+        if ((min_deg > 0) && ((long) min_deg * p->arr[i].exp > maxdeg)) {
+            break;
+        }
+        Poly composed = PolyComposeTruncHelperI(&p->arr[i], k, q, depth, maxdeg);
+        res = PolyAddOwn(&res, &composed);
+    }
+    return res;
+}
+
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t maxdeg) {
+    return PolyComposeTruncHelperII(p, k, q, 0, maxdeg);
+}
+
 static Poly PolyComposeHelperII(const Poly *p, size_t k, const Poly q[], size_t depth);
 
 /**
@@ -805,26 +2102,21 @@ static Poly PolyComposeHelperI(const Mono *m, size_t k, const Poly q[], size_t d
         Poly composed;
         if (depth >= k) {
             Poly help = PolyZero();
-            composed = PowerPoly(&help, m->exp);
+            composed = PolyPow(&help, m->exp);
         } else {
-            composed = PowerPoly(&q[depth], m->exp);
+            composed = PolyPow(&q[depth], m->exp);
         }
-        Poly res = PolyMul(&coeff, &composed);
-        PolyDestroy(&composed);
-        return res;
+        return PolyMulOwn(&coeff, &composed);
     } else {
         Poly p = PolyComposeHelperII(&m->p, k, q, depth + 1);
         Poly composed;
         if (depth >= k) {
             Poly help = PolyZero();
-            composed = PowerPoly(&help, m->exp);
+            composed = PolyPow(&help, m->exp);
         } else {
-            composed = PowerPoly(&q[depth], m->exp);
+            composed = PolyPow(&q[depth], m->exp);
         }
-        Poly res = PolyMul(&p, &composed);
-        PolyDestroy(&p);
-        PolyDestroy(&composed);
-        return res;
+        return PolyMulOwn(&p, &composed);
     }
 }
 
@@ -865,7 +2157,14 @@ static Poly PolyComposeHelperII(const Poly *p, size_t k, const Poly q[], size_t
     return PolyOwnMonos(i, arr);
 }
 
-Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
+/**
+ * Implementacja PolyCompose, bez śledzenia.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] k : liczba podstawianych wielomianów
+ * @param[in] q : tablica podstawianych wielomianów
+ * @return @f$p(q_0, q_1, \ldots)@f$
+ */
+static Poly Compose(const Poly *p, size_t k, const Poly q[]) {
     if (p->arr == NULL) {
         return PolyClone(p);
     }
@@ -896,3 +2195,148 @@ Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
     Poly res = PolyOwnMonos(i, arr);
     return res;
 }
+
+Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
+    if (PolyTraceTarget == NULL) {
+        return Compose(p, k, q);
+    }
+    double start = PolyTraceClock();
+    Poly res = Compose(p, k, q);
+    Trace("PolyCompose", start, "p", PolyTraceSize(p), "k", k, &res);
+    return res;
+}
+
+/**
+ * Liczy, ile razy złożenie sięgnie po każdy z podstawianych wielomianów,
+ * czyli ile jednomianów na każdym poziomie zagnieżdżenia mniejszym niż
+ * @f$k@f$ ma dodatni wykładnik.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in,out] uses : liczby użyć podstawianych wielomianów
+ */
+static void CountComposeUses(const Poly *p, size_t k, size_t depth, size_t uses[]) {
+    if ((p->arr == NULL) || (depth >= k)) {
+        return;
+    }
+    for (size_t i = 0; i < p->size; ++i) {
+        if (p->arr[i].exp > 0) {
+            ++uses[depth];
+        }
+        CountComposeUses(&p->arr[i].p, k, depth + 1, uses);
+    }
+}
+
+/**
+ * Podnosi podstawiany wielomian do potęgi, tak jak PolyComposeHelperI.
+ * Przy ostatnim użyciu wielomianu z pierwszą potęgą przenosi go do wyniku
+ * zamiast kopiować, zostawiając w tablicy wielomian zerowy.
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in,out] q : tablica wielomianów
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in] exp : wykładnik
+ * @param[in,out] uses : liczby pozostałych użyć podstawianych wielomianów
+ * @return @f$q_{depth}^{exp}@f$
+ */
+static Poly ComposePowerOwn(size_t k, Poly q[], size_t depth, poly_exp_t exp, size_t uses[]) {
+    if (depth >= k) {
+        Poly help = PolyZero();
+        return PolyPow(&help, exp);
+    }
+    if (exp == 0) {
+        return PolyFromCoeff(1);
+    }
+    --uses[depth];
+    if ((uses[depth] == 0) && (exp == 1)) {
+        Poly res = q[depth];
+        q[depth] = PolyZero();
+        return res;
+    }
+    return PolyPow(&q[depth], exp);
+}
+
+static Poly PolyComposeOwnHelperII(Poly *p, size_t k, Poly q[], size_t depth, size_t uses[]);
+
+/**
+ * Funkcja pomocnicza funkcji PolyComposeOwn, odpowiednik PolyComposeHelperI
+ * przejmujący na własność współczynnik jednomianu.
+ * @param[in,out] m : jednomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in,out] q : tablica wielomianów
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in,out] uses : liczby pozostałych użyć podstawianych wielomianów
+ */
+static Poly PolyComposeOwnHelperI(Mono *m, size_t k, Poly q[], size_t depth, size_t uses[]) {
+    Poly p = PolyComposeOwnHelperII(&m->p, k, q, depth + 1, uses);
+    Poly composed = ComposePowerOwn(k, q, depth, m->exp, uses);
+    return PolyMulOwn(&p, &composed);
+}
+
+/**
+ * Funkcja pomocnicza funkcji PolyComposeOwn, odpowiednik PolyComposeHelperII
+ * przejmujący na własność wielomian @p p.
+ * @param[in,out] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in,out] q : tablica wielomianów
+ * @param[in] depth : stopień zagnieżdzenia głównego wielomianu
+ * @param[in,out] uses : liczby pozostałych użyć podstawianych wielomianów
+ */
+static Poly PolyComposeOwnHelperII(Poly *p, size_t k, Poly q[], size_t depth, size_t uses[]) {
+    if (p->arr == NULL) {
+        return *p;
+    }
+    Mono *arr = malloc(k * sizeof *arr);
+    size_t length = k;
+    size_t i = 0;
+    for (size_t index_p = 0; index_p < p->size; ++index_p) {
+        Poly composed = PolyComposeOwnHelperI(&p->arr[index_p], k, q, depth, uses);
+        if (composed.arr == NULL) {
+            LengthenArrayIfNecessary(&arr, &length, i);
+            arr[i] = MonoFromPoly(&composed, 0);
+            ++i;
+        } else {
+            for (size_t j = 0; j < composed.size; ++j, ++i) {
+                LengthenArrayIfNecessary(&arr, &length, i);
+                arr[i] = composed.arr[j];
+            }
+            free(composed.arr);
+        }
+    }
+    free(p->arr);
+    if (i == 0) {
+        free(arr);
+        return PolyZero();
+    }
+    return PolyOwnMonos(i, arr);
+}
+
+/**
+ * Implementacja PolyComposeOwn, bez śledzenia. Współczynniki i tablice
+ * wielomianu @p p są zużywane w miejscu, a każdy podstawiany wielomian
+ * jest przy ostatnim użyciu w pierwszej potędze przenoszony do wyniku.
+ * @param[in,out] p : wielomian @f$p@f$
+ * @param[in] k : liczba podstawianych wielomianów
+ * @param[in,out] q : tablica podstawianych wielomianów
+ * @return @f$p(q_0, q_1, \ldots)@f$
+ */
+static Poly ComposeOwn(Poly *p, size_t k, Poly q[]) {
+    size_t *uses = calloc(k > 0 ? k : 1, sizeof *uses);
+    CountComposeUses(p, k, 0, uses);
+    Poly res = PolyComposeOwnHelperII(p, k, q, 0, uses);
+    free(uses);
+    for (size_t i = 0; i < k; ++i) {
+        PolyDestroy(&q[i]);
+    }
+    return res;
+}
+
+Poly PolyComposeOwn(Poly *p, size_t k, Poly q[]) {
+    if (PolyTraceTarget == NULL) {
+        return ComposeOwn(p, k, q);
+    }
+    size_t sizeP = PolyTraceSize(p);
+    double start = PolyTraceClock();
+    Poly res = ComposeOwn(p, k, q);
+    Trace("PolyComposeOwn", start, "p", sizeP, "k", k, &res);
+    return res;
+}
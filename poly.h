@@ -119,14 +119,10 @@ static inline bool MonoIsZero(const Mono *m) {
  * @return Czy wielomian jest równy zeru?
  */
 static inline bool PolyIsZero(const Poly *p) {
-    if (p->arr == NULL) {
-        return p->coeff == 0;
-    } else {
-        if ((p->size == 1) && (PolyIsZero(&p->arr[0].p))) {
-            return true;
-        }
-        return false;
+    while ((p->arr != NULL) && (p->size == 1)) {
+        p = &p->arr[0].p;
     }
+    return (p->arr == NULL) && (p->coeff == 0);
 }
 
 /**
@@ -135,6 +131,61 @@ static inline bool PolyIsZero(const Poly *p) {
  */
 void PolyDestroy(Poly *p);
 
+/**
+ * Robi kopię wielomianu, w której wszystkie tablice jednomianów leżą
+ * w jednym bloku pamięci, w kolejności przechodzenia w głąb. Przechodzenie
+ * po takiej kopii lepiej wykorzystuje pamięć podręczną procesora.
+ * Zwartą kopię można przekazywać tylko do funkcji przyjmujących wielomian
+ * przez stały wskaźnik i trzeba ją usunąć funkcją PolyCompactDestroy.
+ * @param[in] p : wielomian
+ * @return zwarta kopia wielomianu
+ */
+Poly PolyCompact(const Poly *p);
+
+/**
+ * Usuwa z pamięci wielomian utworzony przez PolyCompact,
+ * zwalniając jeden blok pamięci.
+ * @param[in] p : zwarty wielomian
+ */
+void PolyCompactDestroy(Poly *p);
+
+/**
+ * To jest struktura opisująca pamięć zajmowaną przez wielomian.
+ */
+typedef struct {
+    size_t bytes; ///< rozmiar używanych jednomianów w bajtach
+    size_t wasted; ///< pamięć przydzielona tablicom ponad potrzebę, w bajtach
+    size_t arrays; ///< liczba tablic jednomianów
+    size_t monos; ///< liczba jednomianów na wszystkich poziomach
+} PolyMemory;
+
+/**
+ * Liczy pamięć zajmowaną przez wielomian. Tablice jednomianów rosną
+ * z zapasem, więc zwykle mają więcej miejsca, niż potrzebują. Zapas jest
+ * mierzony funkcją @c malloc_usable_size i obejmuje też zaokrąglenie
+ * rozmiaru bloku przez alokator; bez biblioteki glibc nie da się go
+ * zmierzyć i jest równy zeru.
+ * @param[in] p : wielomian
+ * @return pamięć wielomianu
+ */
+PolyMemory PolyMemoryUsage(const Poly *p);
+
+/**
+ * Liczy pamięć zajmowaną przez wielomian utworzony przez PolyCompact.
+ * Zapasem jest tu tylko zaokrąglenie rozmiaru jedynego bloku.
+ * @param[in] p : zwarty wielomian
+ * @return pamięć wielomianu
+ */
+PolyMemory PolyCompactMemoryUsage(const Poly *p);
+
+/**
+ * Zmniejsza tablice jednomianów wielomianu do potrzebnego rozmiaru,
+ * zwalniając zapas pozostały po ich wzroście. Bez biblioteki glibc,
+ * gdy zapasu nie da się zmierzyć, zmniejszane są wszystkie tablice.
+ * @param[in,out] p : wielomian
+ */
+void PolyShrinkToFit(Poly *p);
+
 /**
  * Usuwa jednomian z pamięci.
  * @param[in] m : jednomian
@@ -143,26 +194,12 @@ static inline void MonoDestroy(Mono *m) {
     PolyDestroy(&m->p);
 }
 
-static inline Mono MonoClone(const Mono *m);
-
 /**
  * Robi pełną, głęboką kopię wielomianu.
  * @param[in] p : wielomian
  * @return skopiowany wielomian
  */
-static inline Poly PolyClone(const Poly *p) {
-    Poly new;
-    if (p->arr == NULL) {
-        return PolyFromCoeff(p->coeff);
-    }
-    new.size = p->size;
-    Mono *arr = malloc(new.size * sizeof *arr);
-    for (size_t i = 0; i < p->size; ++i) {
-        arr[i] = MonoClone(&p->arr[i]);
-    }
-    new.arr = arr;
-    return new;
-}
+Poly PolyClone(const Poly *p);
 
 /**
  * Robi pełną, głęboką kopię jednomianu.
@@ -181,6 +218,27 @@ static inline Mono MonoClone(const Mono *m) {
  */
 Poly PolyAdd(const Poly *p, const Poly *q);
 
+/**
+ * Dodaje dwa wielomiany. Przejmuje na własność zawartość wielomianów
+ * @p p i @p q, przenosząc ich jednomiany do wyniku zamiast je kopiować.
+ * Po wywołaniu nie wolno już korzystać z @p p ani z @p q.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p + q@f$
+ */
+Poly PolyAddOwn(Poly *p, Poly *q);
+
+/**
+ * Dodaje do wielomianu @p p wielomian @p q pomnożony przez stałą @p c.
+ * Mnożenie przez @p c nie wymaga osobnego przejścia po @p q, odbywa się
+ * w trakcie dodawania. Przejmuje na własność zawartość wielomianów @p p i @p q.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] c : mnożnik @f$c@f$
+ * @return @f$p + c * q@f$
+ */
+Poly PolyAddScaledOwn(Poly *p, Poly *q, poly_coeff_t c);
+
 /**
  * Sumuje listę jednomianów i tworzy z nich wielomian.
  * Przejmuje na własność zawartość tablicy @p monos.
@@ -221,6 +279,36 @@ Poly PolyCloneMonos(size_t count, const Mono monos[]);
  */
 Poly PolyMul(const Poly *p, const Poly *q);
 
+/**
+ * Mnoży dwa wielomiany. Przejmuje na własność zawartość wielomianów
+ * @p p i @p q. Mnożenie przez stałą odbywa się w miejscu.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p * q@f$
+ */
+Poly PolyMulOwn(Poly *p, Poly *q);
+
+/**
+ * Podnosi wielomian do kwadratu.
+ * Każdą nieuporządkowaną parę różnych jednomianów mnoży tylko raz
+ * i podwaja wynik, a współczynniki przy kwadratach jednomianów
+ * wylicza rekurencyjnie w ten sam sposób.
+ * @param[in] p : wielomian @f$p@f$
+ * @return @f$p^2@f$
+ */
+Poly PolySqr(const Poly *p);
+
+/**
+ * Mnoży dwa wielomiany, zachowując tylko jednomiany stopnia co najwyżej @p maxdeg.
+ * Pary jednomianów, których iloczyn miałby większy stopień, nie są mnożone,
+ * a pamięć na wynik rośnie z liczbą zachowanych par.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] maxdeg : największy zachowywany stopień
+ * @return @f$p * q@f$ obcięty do stopnia @p maxdeg
+ */
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t maxdeg);
+
 /**
  * Zwraca przeciwny wielomian.
  * @param[in] p : wielomian @f$p@f$
@@ -228,6 +316,24 @@ Poly PolyMul(const Poly *p, const Poly *q);
  */
 Poly PolyNeg(const Poly *p);
 
+/**
+ * Zwraca przeciwny wielomian, negując go w miejscu.
+ * Przejmuje na własność zawartość wielomianu @p p.
+ * @param[in] p : wielomian @f$p@f$
+ * @return @f$-p@f$
+ */
+Poly PolyNegOwn(Poly *p);
+
+/**
+ * Mnoży wielomian przez stałą, przejmując na własność jego zawartość.
+ * Mnożenie odbywa się w miejscu; dla @f$c = 1@f$ nie wymaga żadnego
+ * przejścia po wielomianie.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] c : stała @f$c@f$
+ * @return @f$c * p@f$
+ */
+Poly PolyScaleOwn(Poly *p, poly_coeff_t c);
+
 /**
  * Odejmuje wielomian od wielomianu.
  * @param[in] p : wielomian @f$p@f$
@@ -236,6 +342,15 @@ Poly PolyNeg(const Poly *p);
  */
 Poly PolySub(const Poly *p, const Poly *q);
 
+/**
+ * Odejmuje wielomian od wielomianu.
+ * Przejmuje na własność zawartość wielomianów @p p i @p q.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p - q@f$
+ */
+Poly PolySubOwn(Poly *p, Poly *q);
+
 /**
  * Zwraca stopień wielomianu ze względu na zadaną zmienną (-1 dla wielomianu
  * tożsamościowo równego zeru). Zmienne indeksowane są od 0.
@@ -255,6 +370,15 @@ poly_exp_t PolyDegBy(const Poly *p, size_t var_idx);
  */
 poly_exp_t PolyDeg(const Poly *p);
 
+/**
+ * Usuwa z wielomianu jednomiany stopnia większego niż @p maxdeg.
+ * Dla ujemnego @p maxdeg wynikiem jest wielomian zerowy.
+ * @param[in] p : wielomian
+ * @param[in] maxdeg : największy zachowywany stopień
+ * @return wielomian @p p obcięty do stopnia @p maxdeg
+ */
+Poly PolyTrunc(const Poly *p, poly_exp_t maxdeg);
+
 /**
  * Sprawdza równość dwóch wielomianów.
  * @param[in] p : wielomian @f$p@f$
@@ -276,6 +400,54 @@ bool PolyIsEq(const Poly *p, const Poly *q);
  */
 Poly PolyAt(const Poly *p, poly_coeff_t x);
 
+/**
+ * Wylicza wartość wielomianu w punkcie @p x, tak jak PolyAt.
+ * Przejmuje na własność zawartość wielomianu @p p i wykorzystuje
+ * jego współczynniki w wyniku zamiast je kopiować.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] x : wartość argumentu @f$x@f$
+ * @return @f$p(x, x_0, x_1, \ldots)@f$
+ */
+Poly PolyAtOwn(Poly *p, poly_coeff_t x);
+
+/**
+ * To jest typ wyliczeniowy opisujący algorytm potęgowania wielomianu.
+ */
+typedef enum PolyPowMethod {
+    POLY_POW_AUTO, ///< wybór algorytmu na podstawie liczby jednomianów i gęstości
+    POLY_POW_BINARY, ///< podnoszenie do kwadratu
+    POLY_POW_REPEATED, ///< wielokrotne mnożenie przez podstawę
+    POLY_POW_MULTINOMIAL, ///< rozwinięcie wielomianowe względem pierwszego jednomianu
+    POLY_POW_DENSE ///< podnoszenie do kwadratu na gęstych tablicach współczynników
+} PolyPowMethod;
+
+/**
+ * Podnosi wielomian do potęgi, samodzielnie dobierając algorytm.
+ * Wielomian o jednym jednomianie potęguje wprost, podnosząc do potęgi
+ * współczynnik i mnożąc wykładnik. Dla wielomianów o kilku jednomianach
+ * i niedużych wykładników korzysta z rozwinięcia wielomianowego,
+ * dla gęstych wielomianów jednej zmiennej o stałych współczynnikach
+ * z mnożenia gęstych tablic algorytmem Karatsuby, dla rzadkich
+ * z wielokrotnego mnożenia przez podstawę, a w pozostałych przypadkach
+ * z podnoszenia do kwadratu. Przyjmujemy, że @f$0^0 = 1@f$.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] exp : nieujemny wykładnik @f$exp@f$
+ * @return @f$p^{exp}@f$
+ */
+Poly PolyPow(const Poly *p, poly_exp_t exp);
+
+/**
+ * Podnosi wielomian do potęgi zadanym algorytmem.
+ * Jeśli algorytm POLY_POW_DENSE nie ma zastosowania do @p p,
+ * używa podnoszenia do kwadratu. Wielomian o jednym jednomianie jest
+ * potęgowany wprost niezależnie od wybranego algorytmu.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] exp : nieujemny wykładnik @f$exp@f$
+ * @param[in] method : algorytm potęgowania
+ * @return @f$p^{exp}@f$
+ */
+Poly PolyPowWith(const Poly *p, poly_exp_t exp, PolyPowMethod method);
+
 /**
  * Sprawdza czy wielomian ma wyraz wolny, czyli jednomian o wykładniku równym zeru.
  * @param[in] p : wielomian @f$p@f$
@@ -297,4 +469,29 @@ static inline bool PolyHasExpZero(const Poly *p) {
  */
 Poly PolyCompose(const Poly *p, size_t k, const Poly q[]);
 
+/**
+ * Składa wielomiany, tak jak PolyCompose.
+ * Przejmuje na własność zawartość wielomianu @p p oraz wielomianów
+ * z tablicy @p q (ale nie samą tablicę). Tablice jednomianów @p p są
+ * zużywane w miejscu, a wielomian z @p q podstawiany w pierwszej potędze
+ * jest przy ostatnim użyciu przenoszony do wyniku zamiast kopiowany.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @f$q@f$
+ * @param[in] q : tablica wielomianów
+ */
+Poly PolyComposeOwn(Poly *p, size_t k, Poly q[]);
+
+/**
+ * Składa wielomian @p p z wielomianami z tablicy @p q tak jak PolyCompose,
+ * zachowując tylko jednomiany wyniku stopnia co najwyżej @p maxdeg.
+ * Potęgi podstawianych wielomianów i iloczyny pośrednie są obcinane na bieżąco,
+ * a jednomiany, które nie mogą dać wyrazu stopnia co najwyżej @p maxdeg, są pomijane.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów
+ * @param[in] maxdeg : największy zachowywany stopień
+ * @return złożenie obcięte do stopnia @p maxdeg
+ */
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t maxdeg);
+
 #endif /* __POLY_H__ */
@@ -0,0 +1,263 @@
+/** @file
+  Implementacja binarnego zapisu wielomianów.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "poly_codec.h"
+#include "additional_functions.h"
+#include <limits.h>
+#include <stdlib.h>
+#include "poly_stats.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+size_t VarintEncode(uint64_t x, uint8_t *dst) {
+    size_t i = 0;
+    while (x >= 0x80) {
+        dst[i++] = (uint8_t) (x | 0x80);
+        x >>= 7;
+    }
+    dst[i++] = (uint8_t) x;
+    return i;
+}
+
+bool VarintDecode(const uint8_t **src, const uint8_t *end, uint64_t *x) {
+    const uint8_t *pos = *src;
+    uint64_t res = 0;
+    for (unsigned shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+        if (pos == end) {
+            return false;
+        }
+        uint8_t byte = *pos++;
+        if ((shift == 7 * (MAX_VARINT_BYTES - 1)) && (byte > 1)) {
+            return false;
+        }
+        res |= (uint64_t) (byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            *src = pos;
+            *x = res;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Zapisuje liczbę w postaci varint albo, jeśli bufor jest pusty,
+ * tylko liczy jej rozmiar.
+ * @param[in,out] dst : wskaźnik na bufor, przesuwany za liczbę, lub na NULL
+ * @param[in] x : liczba
+ * @return liczba bajtów zapisu
+ */
+static size_t PutVarint(uint8_t **dst, uint64_t x) {
+    if (*dst == NULL) {
+        size_t i = 1;
+        while (x >= 0x80) {
+            x >>= 7;
+            ++i;
+        }
+        return i;
+    }
+    size_t i = VarintEncode(x, *dst);
+    *dst += i;
+    return i;
+}
+
+/**
+ * To jest struktura reprezentująca wielomian, którego jednomiany są właśnie
+ * zapisywane, razem z numerem bieżącego jednomianu.
+ */
+typedef struct {
+    const Poly *poly; ///< wielomian
+    size_t index; ///< numer zapisywanego jednomianu
+} EncodeFrame;
+
+/**
+ * Zapisuje wielomian w postaci binarnej albo, jeśli bufor jest pusty,
+ * tylko liczy rozmiar zapisu. Przechodzi drzewo iteracyjnie,
+ * więc głęboko zagnieżdżone wielomiany nie przepełniają stosu wywołań.
+ * @param[in] p : wielomian
+ * @param[in,out] dst : wskaźnik na bufor, przesuwany za zapis, lub na NULL
+ * @return rozmiar zapisu w bajtach
+ */
+static size_t EncodeHelper(const Poly *p, uint8_t **dst) {
+    size_t length = INITIAL_LENGTH;
+    EncodeFrame *frames = malloc(length * sizeof *frames);
+    CheckReallocOutcome(frames);
+    size_t depth = 0;
+    size_t total = 0;
+    const Poly *current = p;
+    while (true) {
+        if (current->arr != NULL) {
+            if (depth == length) {
+                length = more(length);
+                frames = realloc(frames, length * sizeof *frames);
+                CheckReallocOutcome(frames);
+            }
+            frames[depth] = (EncodeFrame) {.poly = current, .index = 0};
+            ++depth;
+            total += PutVarint(dst, current->size);
+            total += PutVarint(dst, (uint64_t) current->arr[0].exp);
+            current = &current->arr[0].p;
+            continue;
+        }
+        total += PutVarint(dst, 0);
+        total += PutVarint(dst, ZigzagEncode(current->coeff));
+        while (depth > 0) {
+            EncodeFrame *frame = &frames[depth - 1];
+            ++frame->index;
+            if (frame->index < frame->poly->size) {
+                total += PutVarint(dst, (uint64_t) frame->poly->arr[frame->index].exp);
+                current = &frame->poly->arr[frame->index].p;
+                break;
+            }
+            --depth;
+        }
+        if (depth == 0) {
+            break;
+        }
+    }
+    free(frames);
+    return total;
+}
+
+size_t PolyEncodedSize(const Poly *p) {
+    uint8_t *none = NULL;
+    return EncodeHelper(p, &none);
+}
+
+uint8_t *PolyEncode(const Poly *p, uint8_t *dst) {
+    EncodeHelper(p, &dst);
+    return dst;
+}
+
+/**
+ * Odczytuje wykładnik zapisany w postaci varint.
+ * @param[in,out] src : wskaźnik na pierwszy bajt, przesuwany za wykładnik
+ * @param[in] end : koniec danych
+ * @param[out] exp : odczytany wykładnik
+ * @return Czy wykładnik był zapisany poprawnie i mieści się w typie poly_exp_t?
+ */
+static bool DecodeExp(const uint8_t **src, const uint8_t *end, poly_exp_t *exp) {
+    uint64_t x;
+    if (!VarintDecode(src, end, &x) || (x > INT_MAX)) {
+        return false;
+    }
+    *exp = (poly_exp_t) x;
+    return true;
+}
+
+/**
+ * To jest struktura reprezentująca wielomian, którego jednomiany są właśnie
+ * odczytywane.
+ */
+typedef struct {
+    Mono *arr; ///< odczytane jednomiany
+    size_t size; ///< liczba jednomianów wielomianu
+    size_t filled; ///< liczba odczytanych jednomianów
+    poly_exp_t exp; ///< wykładnik odczytywanego jednomianu
+    bool canonical; ///< czy odczytane jednomiany są w postaci zwracanej przez PolyOwnMonos
+} DecodeFrame;
+
+/**
+ * Buduje wielomian z odczytanych jednomianów. Jeśli są już w postaci
+ * kanonicznej, tablica staje się wielomianem bez żadnego przejścia po niej;
+ * w przeciwnym przypadku jednomiany są porządkowane funkcją PolyOwnMonos.
+ * Tylko wynik PolyOwnMonos trzeba potem sprawdzać funkcją PolyIsZero,
+ * bo wielomian zbudowany z kanonicznych jednomianów nie jest zerowy.
+ * @param[in] frame : wielomian ze wszystkimi odczytanymi jednomianami
+ * @return wielomian
+ */
+static Poly FinishFrame(const DecodeFrame *frame) {
+    if (!frame->canonical ||
+        ((frame->size == 1) && (frame->arr[0].exp == 0) && PolyIsCoeff(&frame->arr[0].p))) {
+        return PolyOwnMonos(frame->size, frame->arr);
+    }
+    return (Poly) {.size = frame->size, .arr = frame->arr};
+}
+
+bool PolyDecode(const uint8_t *src, size_t size, Poly *res, size_t *used) {
+    const uint8_t *pos = src;
+    const uint8_t *end = src + size;
+    size_t length = INITIAL_LENGTH;
+    DecodeFrame *frames = malloc(length * sizeof *frames);
+    CheckReallocOutcome(frames);
+    size_t depth = 0;
+    bool correct = true;
+    while (correct) {
+        uint64_t n;
+        if (!VarintDecode(&pos, end, &n)) {
+            correct = false;
+            break;
+        }
+        Poly value;
+        bool zero;
+        if (n == 0) {
+            uint64_t c;
+            if (!VarintDecode(&pos, end, &c)) {
+                correct = false;
+                break;
+            }
+            value = PolyFromCoeff((poly_coeff_t) ZigzagDecode(c));
+            zero = (c == 0);
+        } else {
+            if (n > (uint64_t) (end - pos) / 2) {
+                correct = false;
+                break;
+            }
+            if (depth == length) {
+                length = more(length);
+                frames = realloc(frames, length * sizeof *frames);
+                CheckReallocOutcome(frames);
+            }
+            DecodeFrame *frame = &frames[depth];
+            frame->arr = malloc((size_t) n * sizeof *frame->arr);
+            CheckReallocOutcome(frame->arr);
+            frame->size = (size_t) n;
+            frame->filled = 0;
+            frame->canonical = true;
+            ++depth;
+            correct = DecodeExp(&pos, end, &frame->exp);
+            continue;
+        }
+        bool finished = true;
+        while (depth > 0) {
+            DecodeFrame *frame = &frames[depth - 1];
+            if (zero ||
+                ((frame->filled > 0) && (frame->arr[frame->filled - 1].exp >= frame->exp))) {
+                frame->canonical = false;
+            }
+            frame->arr[frame->filled] = (Mono) {.p = value, .exp = frame->exp};
+            ++frame->filled;
+            if (frame->filled < frame->size) {
+                correct = DecodeExp(&pos, end, &frame->exp);
+                finished = false;
+                break;
+            }
+            value = FinishFrame(frame);
+            zero = !frame->canonical && PolyIsZero(&value);
+            --depth;
+        }
+        if (finished) {
+            free(frames);
+            *res = value;
+            *used = (size_t) (pos - src);
+            return true;
+        }
+    }
+    for (size_t i = 0; i < depth; ++i) {
+        for (size_t j = 0; j < frames[i].filled; ++j) {
+            MonoDestroy(&frames[i].arr[j]);
+        }
+        free(frames[i].arr);
+    }
+    free(frames);
+    *res = PolyZero();
+    *used = 0;
+    return false;
+}
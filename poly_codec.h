@@ -0,0 +1,95 @@
+/** @file
+  Interfejs binarnego zapisu wielomianów.
+
+  Wielomian zapisywany jest w porządku prefiksowym. Każdy węzeł zaczyna się
+  liczbą jednomianów @f$n@f$. Jeśli @f$n = 0@f$, węzeł jest współczynnikiem
+  i dalej następuje jego wartość, w przeciwnym przypadku następuje
+  @f$n@f$ par: wykładnik i węzeł współczynnika jednomianu.
+  Liczby nieujemne zapisywane są jako varint (po siedem bitów na bajt,
+  najstarszy bit oznacza kontynuację), a współczynniki dodatkowo
+  w kodowaniu zigzag, dzięki któremu małe liczby ujemne też zajmują mało bajtów.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_POLY_CODEC_H
+#define POLYNOMIALS_POLY_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "poly.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define MAX_VARINT_BYTES 10
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * Zapisuje liczbę w postaci varint.
+ * @param[in] x : liczba
+ * @param[out] dst : bufor na co najmniej MAX_VARINT_BYTES bajtów
+ * @return liczba zapisanych bajtów
+ */
+size_t VarintEncode(uint64_t x, uint8_t *dst);
+
+/**
+ * Odczytuje liczbę zapisaną w postaci varint.
+ * @param[in,out] src : wskaźnik na pierwszy bajt, przesuwany za liczbę
+ * @param[in] end : koniec danych
+ * @param[out] x : odczytana liczba
+ * @return Czy liczba była zapisana poprawnie i mieści się w danych?
+ */
+bool VarintDecode(const uint8_t **src, const uint8_t *end, uint64_t *x);
+
+/**
+ * Zamienia liczbę ze znakiem na liczbę bez znaku w kodowaniu zigzag:
+ * 0, -1, 1, -2, ... przechodzą na 0, 1, 2, 3, ...
+ * @param[in] x : liczba
+ * @return zakodowana liczba
+ */
+static inline uint64_t ZigzagEncode(int64_t x) {
+    return ((uint64_t) x << 1) ^ (uint64_t) (x >> 63);
+}
+
+/**
+ * Odwraca kodowanie zigzag.
+ * @param[in] x : zakodowana liczba
+ * @return liczba
+ */
+static inline int64_t ZigzagDecode(uint64_t x) {
+    return (int64_t) (x >> 1) ^ -(int64_t) (x & 1);
+}
+
+/**
+ * Oblicza rozmiar binarnego zapisu wielomianu.
+ * @param[in] p : wielomian
+ * @return rozmiar zapisu w bajtach
+ */
+size_t PolyEncodedSize(const Poly *p);
+
+/**
+ * Zapisuje wielomian w postaci binarnej.
+ * @param[in] p : wielomian
+ * @param[out] dst : bufor na co najmniej PolyEncodedSize(p) bajtów
+ * @return wskaźnik za ostatnim zapisanym bajtem
+ */
+uint8_t *PolyEncode(const Poly *p, uint8_t *dst);
+
+/**
+ * Odczytuje wielomian zapisany w postaci binarnej.
+ * Sprawdza poprawność danych, więc można jej używać dla danych
+ * z niezaufanych plików. Wynik jest w postaci kanonicznej. Zapis
+ * wielomianu, który był już kanoniczny, jest odczytywany w czasie
+ * liniowym także dla głęboko zagnieżdżonych wielomianów.
+ * @param[in] src : dane
+ * @param[in] size : rozmiar danych w bajtach
+ * @param[out] res : odczytany wielomian
+ * @param[out] used : liczba odczytanych bajtów
+ * @return Czy dane zawierały poprawny zapis wielomianu?
+ */
+bool PolyDecode(const uint8_t *src, size_t size, Poly *res, size_t *used);
+
+#endif //POLYNOMIALS_POLY_CODEC_H
@@ -0,0 +1,371 @@
+/** @file
+  Implementacja zamrażania wielomianów do zwartej postaci.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "poly_freeze.h"
+#include "additional_functions.h"
+#include <stdlib.h>
+#include <string.h>
+#include "poly_stats.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+#define TAG_INLINE 0x80
+#define TAG_ARRAY 0x10
+#define INLINE_MIN (-64)
+#define INLINE_MAX 63
+#define MAX_NODE_BYTES 9
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca powiększany bufor na zamrożony wielomian.
+ */
+typedef struct {
+    uint8_t *data; ///< zapisane bajty
+    size_t size; ///< liczba zapisanych bajtów
+    size_t capacity; ///< rozmiar bufora
+} FreezeBuffer;
+
+/**
+ * Zapewnia miejsce na co najmniej @f$count@f$ kolejnych bajtów.
+ * @param[in,out] buffer : bufor
+ * @param[in] count : liczba bajtów
+ * @return wskaźnik na pierwsze wolne miejsce
+ */
+static uint8_t *Reserve(FreezeBuffer *buffer, size_t count) {
+    if (buffer->size + count > buffer->capacity) {
+        while (buffer->size + count > buffer->capacity) {
+            buffer->capacity = more(buffer->capacity);
+        }
+        buffer->data = realloc(buffer->data, buffer->capacity);
+        CheckReallocOutcome(buffer->data);
+    }
+    return buffer->data + buffer->size;
+}
+
+/**
+ * Daje kod najmniejszej szerokości (1, 2, 4 lub 8 bajtów),
+ * w której mieści się liczba bez znaku.
+ * @param[in] x : liczba
+ * @return kod szerokości od 0 do 3
+ */
+static unsigned UnsignedCode(uint64_t x) {
+    if (x <= UINT8_MAX) {
+        return 0;
+    }
+    if (x <= UINT16_MAX) {
+        return 1;
+    }
+    return (x <= UINT32_MAX) ? 2 : 3;
+}
+
+/**
+ * Daje kod najmniejszej szerokości (1, 2, 4 lub 8 bajtów),
+ * w której mieści się liczba ze znakiem.
+ * @param[in] x : liczba
+ * @return kod szerokości od 0 do 3
+ */
+static unsigned SignedCode(int64_t x) {
+    if ((x >= INT8_MIN) && (x <= INT8_MAX)) {
+        return 0;
+    }
+    if ((x >= INT16_MIN) && (x <= INT16_MAX)) {
+        return 1;
+    }
+    return ((x >= INT32_MIN) && (x <= INT32_MAX)) ? 2 : 3;
+}
+
+/**
+ * Zapisuje liczbę bez znaku o podanej szerokości.
+ * @param[out] dst : miejsce zapisu
+ * @param[in] x : liczba
+ * @param[in] code : kod szerokości
+ * @return liczba zapisanych bajtów
+ */
+static size_t PutUnsigned(uint8_t *dst, uint64_t x, unsigned code) {
+    uint8_t x8 = (uint8_t) x;
+    uint16_t x16 = (uint16_t) x;
+    uint32_t x32 = (uint32_t) x;
+    switch (code) {
+        case 0:
+            memcpy(dst, &x8, sizeof x8);
+            return sizeof x8;
+        case 1:
+            memcpy(dst, &x16, sizeof x16);
+            return sizeof x16;
+        case 2:
+            memcpy(dst, &x32, sizeof x32);
+            return sizeof x32;
+        default:
+            memcpy(dst, &x, sizeof x);
+            return sizeof x;
+    }
+}
+
+/**
+ * Zapisuje liczbę ze znakiem o podanej szerokości.
+ * @param[out] dst : miejsce zapisu
+ * @param[in] x : liczba
+ * @param[in] code : kod szerokości
+ * @return liczba zapisanych bajtów
+ */
+static size_t PutSigned(uint8_t *dst, int64_t x, unsigned code) {
+    int8_t x8 = (int8_t) x;
+    int16_t x16 = (int16_t) x;
+    int32_t x32 = (int32_t) x;
+    switch (code) {
+        case 0:
+            memcpy(dst, &x8, sizeof x8);
+            return sizeof x8;
+        case 1:
+            memcpy(dst, &x16, sizeof x16);
+            return sizeof x16;
+        case 2:
+            memcpy(dst, &x32, sizeof x32);
+            return sizeof x32;
+        default:
+            memcpy(dst, &x, sizeof x);
+            return sizeof x;
+    }
+}
+
+/**
+ * Odczytuje liczbę bez znaku o podanej szerokości.
+ * @param[in,out] src : wskaźnik na miejsce odczytu, przesuwany za liczbę
+ * @param[in] code : kod szerokości
+ * @return liczba
+ */
+static uint64_t GetUnsigned(const uint8_t **src, unsigned code) {
+    uint8_t x8;
+    uint16_t x16;
+    uint32_t x32;
+    uint64_t x;
+    switch (code) {
+        case 0:
+            memcpy(&x8, *src, sizeof x8);
+            *src += sizeof x8;
+            return x8;
+        case 1:
+            memcpy(&x16, *src, sizeof x16);
+            *src += sizeof x16;
+            return x16;
+        case 2:
+            memcpy(&x32, *src, sizeof x32);
+            *src += sizeof x32;
+            return x32;
+        default:
+            memcpy(&x, *src, sizeof x);
+            *src += sizeof x;
+            return x;
+    }
+}
+
+/**
+ * Odczytuje liczbę ze znakiem o podanej szerokości.
+ * @param[in,out] src : wskaźnik na miejsce odczytu, przesuwany za liczbę
+ * @param[in] code : kod szerokości
+ * @return liczba
+ */
+static int64_t GetSigned(const uint8_t **src, unsigned code) {
+    int8_t x8;
+    int16_t x16;
+    int32_t x32;
+    int64_t x;
+    switch (code) {
+        case 0:
+            memcpy(&x8, *src, sizeof x8);
+            *src += sizeof x8;
+            return x8;
+        case 1:
+            memcpy(&x16, *src, sizeof x16);
+            *src += sizeof x16;
+            return x16;
+        case 2:
+            memcpy(&x32, *src, sizeof x32);
+            *src += sizeof x32;
+            return x32;
+        default:
+            memcpy(&x, *src, sizeof x);
+            *src += sizeof x;
+            return x;
+    }
+}
+
+/**
+ * Zapisuje węzeł współczynnika.
+ * @param[in,out] buffer : bufor
+ * @param[in] c : współczynnik
+ */
+static void PutCoeff(FreezeBuffer *buffer, poly_coeff_t c) {
+    uint8_t *dst = Reserve(buffer, MAX_NODE_BYTES);
+    if ((c >= INLINE_MIN) && (c <= INLINE_MAX)) {
+        *dst = (uint8_t) (TAG_INLINE | ((uint8_t) c & 0x7F));
+        ++buffer->size;
+        return;
+    }
+    unsigned code = SignedCode(c);
+    *dst = (uint8_t) code;
+    buffer->size += 1 + PutSigned(dst + 1, c, code);
+}
+
+/**
+ * Daje różnicę wykładników kolejnych jednomianów. Różnica jest liczona
+ * modulo @f$2^{32}@f$, więc działa też dla jednomianów nieposortowanych.
+ * @param[in] monos : jednomiany
+ * @param[in] i : numer jednomianu
+ * @return różnica wykładnika jednomianu i poprzedniego
+ */
+static uint32_t ExpDelta(const Mono *monos, size_t i) {
+    uint32_t prev = (i == 0) ? 0 : (uint32_t) monos[i - 1].exp;
+    return (uint32_t) monos[i].exp - prev;
+}
+
+/**
+ * Zapisuje nagłówek węzła z jednomianami.
+ * @param[in,out] buffer : bufor
+ * @param[in] p : wielomian
+ * @return kod szerokości różnic wykładników
+ */
+static unsigned PutArray(FreezeBuffer *buffer, const Poly *p) {
+    uint32_t maxDelta = 0;
+    for (size_t i = 0; i < p->size; ++i) {
+        uint32_t delta = ExpDelta(p->arr, i);
+        if (delta > maxDelta) {
+            maxDelta = delta;
+        }
+    }
+    unsigned expCode = UnsignedCode(maxDelta);
+    unsigned countCode = UnsignedCode(p->size);
+    uint8_t *dst = Reserve(buffer, MAX_NODE_BYTES);
+    *dst = (uint8_t) (TAG_ARRAY | (countCode << 2) | expCode);
+    buffer->size += 1 + PutUnsigned(dst + 1, p->size, countCode);
+    return expCode;
+}
+
+/**
+ * Zapisuje różnicę wykładników jednomianu.
+ * @param[in,out] buffer : bufor
+ * @param[in] monos : jednomiany
+ * @param[in] i : numer jednomianu
+ * @param[in] code : kod szerokości
+ */
+static void PutExp(FreezeBuffer *buffer, const Mono *monos, size_t i, unsigned code) {
+    uint8_t *dst = Reserve(buffer, MAX_NODE_BYTES);
+    buffer->size += PutUnsigned(dst, ExpDelta(monos, i), code);
+}
+
+/**
+ * To jest struktura reprezentująca wielomian, którego jednomiany są właśnie
+ * zamrażane.
+ */
+typedef struct {
+    const Poly *poly; ///< wielomian
+    size_t index; ///< numer zamrażanego jednomianu
+    unsigned expCode; ///< kod szerokości różnic wykładników
+} FreezeFrame;
+
+uint8_t *PolyFreeze(const Poly *p, size_t *size) {
+    FreezeBuffer buffer = {.data = NULL, .size = 0, .capacity = 0};
+    size_t length = INITIAL_LENGTH;
+    FreezeFrame *frames = malloc(length * sizeof *frames);
+    CheckReallocOutcome(frames);
+    size_t depth = 0;
+    const Poly *current = p;
+    while (true) {
+        if (current->arr != NULL) {
+            if (depth == length) {
+                length = more(length);
+                frames = realloc(frames, length * sizeof *frames);
+                CheckReallocOutcome(frames);
+            }
+            unsigned expCode = PutArray(&buffer, current);
+            frames[depth] = (FreezeFrame) {.poly = current, .index = 0, .expCode = expCode};
+            ++depth;
+            PutExp(&buffer, current->arr, 0, expCode);
+            current = &current->arr[0].p;
+            continue;
+        }
+        PutCoeff(&buffer, current->coeff);
+        while (depth > 0) {
+            FreezeFrame *frame = &frames[depth - 1];
+            ++frame->index;
+            if (frame->index < frame->poly->size) {
+                PutExp(&buffer, frame->poly->arr, frame->index, frame->expCode);
+                current = &frame->poly->arr[frame->index].p;
+                break;
+            }
+            --depth;
+        }
+        if (depth == 0) {
+            break;
+        }
+    }
+    free(frames);
+    buffer.data = realloc(buffer.data, buffer.size);
+    CheckReallocOutcome(buffer.data);
+    *size = buffer.size;
+    return buffer.data;
+}
+
+/**
+ * To jest struktura reprezentująca wielomian, którego jednomiany są właśnie
+ * odmrażane.
+ */
+typedef struct {
+    Mono *arr; ///< odmrożone jednomiany
+    size_t size; ///< liczba jednomianów wielomianu
+    size_t filled; ///< liczba odmrożonych jednomianów
+    uint32_t exp; ///< wykładnik odmrażanego jednomianu
+    unsigned expCode; ///< kod szerokości różnic wykładników
+} ThawFrame;
+
+Poly PolyThaw(const uint8_t *data) {
+    const uint8_t *pos = data;
+    size_t length = INITIAL_LENGTH;
+    ThawFrame *frames = malloc(length * sizeof *frames);
+    CheckReallocOutcome(frames);
+    size_t depth = 0;
+    while (true) {
+        uint8_t tag = *pos++;
+        Poly value;
+        if (tag & TAG_INLINE) {
+            value = PolyFromCoeff((poly_coeff_t) ((int8_t) (uint8_t) (tag << 1) >> 1));
+        } else if (tag < TAG_ARRAY) {
+            value = PolyFromCoeff((poly_coeff_t) GetSigned(&pos, tag));
+        } else {
+            if (depth == length) {
+                length = more(length);
+                frames = realloc(frames, length * sizeof *frames);
+                CheckReallocOutcome(frames);
+            }
+            ThawFrame *frame = &frames[depth];
+            frame->size = (size_t) GetUnsigned(&pos, (tag >> 2) & 3);
+            frame->arr = malloc(frame->size * sizeof *frame->arr);
+            CheckReallocOutcome(frame->arr);
+            frame->filled = 0;
+            frame->expCode = tag & 3;
+            frame->exp = (uint32_t) GetUnsigned(&pos, frame->expCode);
+            ++depth;
+            continue;
+        }
+        while (depth > 0) {
+            ThawFrame *frame = &frames[depth - 1];
+            frame->arr[frame->filled] = (Mono) {.p = value, .exp = (poly_exp_t) frame->exp};
+            ++frame->filled;
+            if (frame->filled < frame->size) {
+                frame->exp += (uint32_t) GetUnsigned(&pos, frame->expCode);
+                break;
+            }
+            value = (Poly) {.size = frame->size, .arr = frame->arr};
+            --depth;
+        }
+        if (depth == 0) {
+            free(frames);
+            return value;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+/** @file
+  Interfejs zamrażania wielomianów do zwartej postaci.
+
+  Zamrożony wielomian zajmuje jeden blok pamięci i jest zapisany
+  w porządku prefiksowym. Każdy węzeł zaczyna się bajtem znacznika.
+  Małe współczynniki mieszczą się w samym znaczniku, a większe zajmują
+  1, 2, 4 lub 8 bajtów. Węzeł z jednomianami zawiera ich liczbę,
+  a wykładniki jednomianu zapisane są jako różnice względem wykładnika
+  poprzedniego jednomianu, wszystkie tej samej, najmniejszej wystarczającej
+  szerokości. Liczby zapisane są w kolejności bajtów procesora,
+  więc zamrożonych danych nie można przenosić między maszynami.
+
+  Zamrożenie zachowuje dokładną strukturę wielomianu, także jednomiany,
+  których nie byłoby w postaci kanonicznej, więc po odmrożeniu wielomian
+  jest nieodróżnialny od oryginału.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_POLY_FREEZE_H
+#define POLYNOMIALS_POLY_FREEZE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "poly.h"
+
+/**
+ * Zamraża wielomian.
+ * @param[in] p : wielomian
+ * @param[out] size : rozmiar zamrożonego wielomianu w bajtach
+ * @return zamrożony wielomian, do zwolnienia funkcją free
+ */
+uint8_t *PolyFreeze(const Poly *p, size_t *size);
+
+/**
+ * Odmraża wielomian. Dane muszą pochodzić z funkcji PolyFreeze
+ * wywołanej w tym samym programie.
+ * @param[in] data : zamrożony wielomian
+ * @return wielomian
+ */
+Poly PolyThaw(const uint8_t *data);
+
+#endif //POLYNOMIALS_POLY_FREEZE_H
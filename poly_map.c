@@ -0,0 +1,326 @@
+/** @file
+  Implementacja wielomianów tylko do odczytu mapowanych z plików.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "poly_map.h"
+#include "additional_functions.h"
+#include "output.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define MAP_MAGIC "POLYMAP1"
+#define MAP_MAGIC_LENGTH 8
+#define BYTE_ORDER_MARK 0x0102030405060708ULL
+#define BASE_LOW 0x100000000000ULL
+#define BASE_SLOTS 4096
+#define BASE_SLOT (1ULL << 30)
+#define INITIAL_LENGTH 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca nagłówek pliku z wielomianem.
+ * Za nagłówkiem leżą rekordy typu Mono.
+ */
+typedef struct {
+    char magic[MAP_MAGIC_LENGTH]; ///< napis identyfikujący format
+    uint64_t byteOrder; ///< stała pozwalająca wykryć inną kolejność bajtów
+    uint64_t monoSize; ///< rozmiar rekordu jednomianu
+    uint64_t base; ///< preferowany adres mapowania
+    uint64_t size; ///< rozmiar pliku
+    Poly root; ///< korzeń wielomianu
+} MapHeader;
+
+/** Zmapowane pliki, żeby ten sam plik był mapowany tylko raz. */
+static PolyMap *registry = NULL;
+
+/**
+ * Wybiera preferowany adres mapowania nowego pliku. Adresy są rozrzucone
+ * po dużym obszarze, żeby różne pliki rzadko mapowały się w tym samym miejscu.
+ * @return adres bazowy
+ */
+static uint64_t ChooseBase(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t x = (uint64_t) ts.tv_nsec ^ ((uint64_t) ts.tv_sec << 20) ^ (uint64_t) getpid();
+    x ^= x >> 31;
+    x *= 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 29;
+    return BASE_LOW + (x % BASE_SLOTS) * BASE_SLOT;
+}
+
+/**
+ * Tworzy obraz wielomianu w pliku: współczynnik jest kopiowany,
+ * a tablicy jednomianów przydzielane jest miejsce na końcu pliku.
+ * @param[in] p : wielomian
+ * @param[in] base : adres bazowy pliku
+ * @param[in,out] next : pierwsze wolne miejsce w pliku
+ * @return obraz wielomianu
+ */
+static Poly MapRecord(const Poly *p, uint64_t base, uint64_t *next) {
+    if (p->arr == NULL) {
+        return *p;
+    }
+    Poly res = {.size = p->size, .arr = (Mono *) (uintptr_t) (base + *next)};
+    *next += p->size * sizeof(Mono);
+    return res;
+}
+
+/**
+ * Zapisuje obraz wielomianu do pustego pliku.
+ * @param[in] p : wielomian
+ * @param[in] fd : deskryptor pliku
+ * @return Czy udało się zapisać obraz?
+ */
+static bool WriteImage(const Poly *p, int fd) {
+    MapHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, MAP_MAGIC, MAP_MAGIC_LENGTH);
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.monoSize = sizeof(Mono);
+    header.base = ChooseBase();
+    uint64_t next = sizeof header;
+    header.root = MapRecord(p, header.base, &next);
+    Output out;
+    initOutput(&out, fd);
+    writeBytes(&out, (const char *) &header, sizeof header);
+    size_t length = INITIAL_LENGTH;
+    const Poly **queue = malloc(length * sizeof *queue);
+    CheckReallocOutcome(queue);
+    size_t count = 0;
+    if (p->arr != NULL) {
+        queue[count++] = p;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const Poly *q = queue[i];
+        for (size_t j = 0; j < q->size; ++j) {
+            const Mono *m = &q->arr[j];
+            Mono record;
+            memset(&record, 0, sizeof record);
+            record.p = MapRecord(&m->p, header.base, &next);
+            record.exp = m->exp;
+            if (m->p.arr != NULL) {
+                if (count == length) {
+                    length = more(length);
+                    queue = realloc(queue, length * sizeof *queue);
+                    CheckReallocOutcome(queue);
+                }
+                queue[count++] = &m->p;
+            }
+            writeBytes(&out, (const char *) &record, sizeof record);
+        }
+    }
+    free(queue);
+    flushOutput(&out);
+    bool correct = !out.failed;
+    closeOutput(&out);
+    header.size = next;
+    if (pwrite(fd, &header, sizeof header, 0) != (ssize_t) sizeof header) {
+        correct = false;
+    }
+    return correct;
+}
+
+bool PolyMapExport(const Poly *p, const char *path) {
+    char *temp;
+    int fd = openReplacement(path, &temp);
+    if (fd < 0) {
+        return false;
+    }
+    return replaceFile(fd, temp, path, WriteImage(p, fd));
+}
+
+/**
+ * Sprawdza wskaźnik z pliku i wylicza przesunięcie wskazywanej tablicy.
+ * Tablice leżą w pliku w kolejności wskaźników na nie, za wszystkimi
+ * wcześniejszymi tablicami, więc każda tablica musi zaczynać się dokładnie
+ * tam, gdzie kończy się poprzednia. Dzięki temu uszkodzony plik nie może
+ * wskazać poza mapowanie, utworzyć cyklu ani wskazać dwa razy tej samej
+ * tablicy.
+ * @param[in] p : obraz wielomianu, który nie jest współczynnikiem
+ * @param[in] header : nagłówek pliku
+ * @param[in,out] next : przesunięcie końca ostatniej wskazanej tablicy
+ * @param[out] offset : przesunięcie tablicy jednomianów w pliku
+ * @return Czy wskaźnik jest poprawny?
+ */
+static bool CheckPointer(const Poly *p, const MapHeader *header, uint64_t *next, uint64_t *offset) {
+    *offset = (uint64_t) (uintptr_t) p->arr - header->base;
+    if ((*offset != *next) || (p->size <= 0) ||
+        (p->size > (header->size - *offset) / sizeof(Mono))) {
+        return false;
+    }
+    *next += p->size * sizeof(Mono);
+    return true;
+}
+
+/**
+ * Sprawdza, czy rekord jest poprawnym jednomianem wielomianu w postaci
+ * kanonicznej: wykładniki w tablicy są nieujemne i rosną ściśle, żaden
+ * jednomian nie jest zerowy, a tablica nie składa się z samej stałej
+ * przy wykładniku 0. Wielomian wskazywany przez jednomian jest sprawdzany
+ * osobno, gdy przejście dojdzie do jego tablicy.
+ * @param[in] m : rekord
+ * @param[in] prev : poprzedni rekord tej samej tablicy lub NULL
+ * @param[in] size : liczba jednomianów tablicy
+ * @return Czy rekord jest poprawny?
+ */
+static bool CheckMono(const Mono *m, const Mono *prev, size_t size) {
+    if ((m->exp < 0) || ((prev != NULL) && (prev->exp >= m->exp))) {
+        return false;
+    }
+    return (m->p.arr != NULL) || ((m->p.coeff != 0) && ((size > 1) || (m->exp > 0)));
+}
+
+/**
+ * Sprawdza wszystkie rekordy w pliku, a jeśli @p relocate jest prawdą,
+ * przesuwa wskaźniki z preferowanego adresu bazowego na adres mapowania.
+ * Rekordy leżą w pliku jeden za drugim, więc wystarcza jedno liniowe
+ * przejście. Granice tablic wyznacza drugi kursor, który idzie za
+ * przejściem po kolejnych rekordach wskazujących na tablice.
+ * @param[in,out] addr : adres mapowania
+ * @param[in] relocate : czy plik jest zmapowany pod innym adresem niż preferowany
+ * @return Czy plik był poprawny?
+ */
+static bool CheckPointers(char *addr, bool relocate) {
+    MapHeader *header = (MapHeader *) addr;
+    uint64_t next = sizeof *header;
+    uint64_t offset;
+    if (header->root.arr != NULL) {
+        if (!CheckPointer(&header->root, header, &next, &offset)) {
+            return false;
+        }
+        if (relocate) {
+            header->root.arr = (Mono *) (addr + offset);
+        }
+    }
+    size_t size = (header->root.arr != NULL) ? header->root.size : 0;
+    uint64_t start = sizeof *header;
+    uint64_t owners = sizeof *header;
+    for (uint64_t owner = sizeof *header; owner < header->size; owner += sizeof(Mono)) {
+        if (owner == start + size * sizeof(Mono)) {
+            while ((owners < owner) && (((Mono *) (addr + owners))->p.arr == NULL)) {
+                owners += sizeof(Mono);
+            }
+            if (owners == owner) {
+                return false;
+            }
+            size = ((Mono *) (addr + owners))->p.size;
+            owners += sizeof(Mono);
+            start = owner;
+        }
+        Mono *m = (Mono *) (addr + owner);
+        if (!CheckMono(m, (owner > start) ? m - 1 : NULL, size)) {
+            return false;
+        }
+        if (m->p.arr == NULL) {
+            continue;
+        }
+        if (!CheckPointer(&m->p, header, &next, &offset)) {
+            return false;
+        }
+        if (relocate) {
+            m->p.arr = (Mono *) (addr + offset);
+        }
+    }
+    return next == header->size;
+}
+
+/**
+ * Sprawdza nagłówek pliku.
+ * @param[in] header : nagłówek
+ * @param[in] size : rozmiar pliku
+ * @return Czy nagłówek jest poprawny?
+ */
+static bool CheckHeader(const MapHeader *header, size_t size) {
+    return (memcmp(header->magic, MAP_MAGIC, MAP_MAGIC_LENGTH) == 0) &&
+           (header->byteOrder == BYTE_ORDER_MARK) && (header->monoSize == sizeof(Mono)) &&
+           (header->size == size) && ((size - sizeof *header) % sizeof(Mono) == 0) &&
+           (header->base % (uint64_t) sysconf(_SC_PAGESIZE) == 0);
+}
+
+PolyMap *PolyMapOpen(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) ||
+        (st.st_size < (off_t) sizeof(MapHeader))) {
+        close(fd);
+        return NULL;
+    }
+    for (PolyMap *map = registry; map != NULL; map = map->next) {
+        if ((map->device == st.st_dev) && (map->inode == st.st_ino)) {
+            close(fd);
+            PolyMapRetain(map);
+            return map;
+        }
+    }
+    size_t size = (size_t) st.st_size;
+    MapHeader header;
+    if ((pread(fd, &header, sizeof header, 0) != (ssize_t) sizeof header) ||
+        !CheckHeader(&header, size)) {
+        close(fd);
+        return NULL;
+    }
+    void *addr = mmap((void *) (uintptr_t) header.base, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ((addr != MAP_FAILED) && ((uintptr_t) addr == header.base) && !CheckPointers(addr, false)) {
+        munmap(addr, size);
+        addr = MAP_FAILED;
+    } else if ((addr != MAP_FAILED) && ((uintptr_t) addr != header.base)) {
+        munmap(addr, size);
+        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if ((addr != MAP_FAILED) && !CheckPointers(addr, true)) {
+            munmap(addr, size);
+            addr = MAP_FAILED;
+        }
+        if (addr != MAP_FAILED) {
+            mprotect(addr, size, PROT_READ);
+        }
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    PolyMap *map = malloc(sizeof *map);
+    CheckReallocOutcome(map);
+    map->root = ((const MapHeader *) addr)->root;
+    map->addr = addr;
+    map->size = size;
+    map->device = st.st_dev;
+    map->inode = st.st_ino;
+    map->refs = 1;
+    map->next = registry;
+    registry = map;
+    return map;
+}
+
+void PolyMapRetain(PolyMap *map) {
+    ++map->refs;
+}
+
+void PolyMapRelease(PolyMap *map) {
+    --map->refs;
+    if (map->refs > 0) {
+        return;
+    }
+    PolyMap **link = &registry;
+    while (*link != map) {
+        link = &(*link)->next;
+    }
+    *link = map->next;
+    munmap(map->addr, map->size);
+    free(map);
+}
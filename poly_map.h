@@ -0,0 +1,83 @@
+/** @file
+  Interfejs wielomianów tylko do odczytu mapowanych z plików.
+
+  Plik zawiera obraz pamięci wielomianu: nagłówek z korzeniem, a za nim
+  wszystkie tablice jednomianów, zapisane wszerz, jedna za drugą.
+  Wskaźniki na tablice są zapisane jako przesunięcia względem
+  preferowanego adresu bazowego zapisanego w nagłówku. Jeśli system
+  zmapuje plik pod tym adresem, wielomian jest gotowy do użycia bez
+  żadnego kopiowania, a strony pliku są współdzielone między procesami
+  przez pamięć podręczną systemu. W przeciwnym przypadku wskaźniki są
+  przesuwane. W obu przypadkach wszystkie rekordy są przy otwarciu
+  sprawdzane w jednym liniowym przejściu po pliku: wskaźniki nie mogą
+  wskazać poza mapowanie ani dwa razy na tę samą tablicę, a wielomian
+  musi być w postaci kanonicznej, której oczekują funkcje biblioteki.
+
+  Zmapowany wielomian można przekazywać do wszystkich funkcji biblioteki,
+  które przyjmują wielomian przez stały wskaźnik (np. PolyAt, PolyDeg,
+  PolyDegBy, PolyIsEq, PolyMul, PolyCompose). Nie wolno go modyfikować
+  ani usuwać funkcją PolyDestroy. Format zależy od architektury, więc plik
+  można mapować tylko na maszynie tego samego rodzaju.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_POLY_MAP_H
+#define POLYNOMIALS_POLY_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "poly.h"
+
+/**
+ * To jest struktura reprezentująca zmapowany plik z wielomianem.
+ * Ten sam plik mapowany wielokrotnie jest współdzielony; mapowanie
+ * jest usuwane, gdy zwolniona zostanie ostatnia referencja.
+ */
+typedef struct PolyMap {
+    Poly root; ///< zmapowany wielomian
+    void *addr; ///< początek mapowania
+    size_t size; ///< rozmiar mapowania
+    dev_t device; ///< urządzenie, na którym leży plik
+    ino_t inode; ///< numer i-węzła pliku
+    size_t refs; ///< liczba referencji
+    struct PolyMap *next; ///< następne mapowanie w rejestrze
+} PolyMap;
+
+/**
+ * Zapisuje wielomian do pliku w postaci, którą można zmapować
+ * funkcją PolyMapOpen. Obraz jest zapisywany do pliku tymczasowego
+ * w tym samym katalogu, który potem zastępuje plik docelowy, więc
+ * istniejące mapowania tego pliku nie są zmieniane.
+ * @param[in] p : wielomian
+ * @param[in] path : ścieżka pliku
+ * @return Czy udało się zapisać plik?
+ */
+bool PolyMapExport(const Poly *p, const char *path);
+
+/**
+ * Mapuje plik zapisany przez PolyMapExport. Jeśli plik jest już zmapowany,
+ * zwraca istniejące mapowanie ze zwiększoną liczbą referencji.
+ * Sprawdzane są nagłówek, wszystkie wskaźniki pliku i postać wielomianu,
+ * więc niepoprawny plik nie zostanie zmapowany.
+ * @param[in] path : ścieżka pliku
+ * @return mapowanie lub NULL, jeśli nie udało się zmapować pliku
+ */
+PolyMap *PolyMapOpen(const char *path);
+
+/**
+ * Zwiększa liczbę referencji mapowania.
+ * @param[in,out] map : mapowanie
+ */
+void PolyMapRetain(PolyMap *map);
+
+/**
+ * Zmniejsza liczbę referencji mapowania i usuwa je,
+ * gdy była to ostatnia referencja.
+ * @param[in,out] map : mapowanie
+ */
+void PolyMapRelease(PolyMap *map);
+
+#endif //POLYNOMIALS_POLY_MAP_H
@@ -0,0 +1,40 @@
+/** @file
+  Implementacja liczników alokacji pamięci biblioteki wielomianów.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define POLY_STATS_UNCOUNTED
+
+#include "poly_stats.h"
+
+#ifdef POLY_STATS
+
+#include <stdlib.h>
+
+/** Liczniki alokacji bieżącego wątku. */
+static _Thread_local PolyAllocStats counters;
+
+PolyAllocStats PolyAllocSnapshot(void) {
+    return counters;
+}
+
+void *PolyStatsMalloc(size_t size) {
+    ++counters.mallocs;
+    counters.bytes += size;
+    return malloc(size);
+}
+
+void *PolyStatsCalloc(size_t count, size_t size) {
+    ++counters.mallocs;
+    counters.bytes += count * size;
+    return calloc(count, size);
+}
+
+void *PolyStatsRealloc(void *ptr, size_t size) {
+    ++counters.reallocs;
+    counters.bytes += size;
+    return realloc(ptr, size);
+}
+
+#endif /* POLY_STATS */
@@ -0,0 +1,77 @@
+/** @file
+  Interfejs liczników alokacji pamięci biblioteki wielomianów.
+
+  Liczniki działają tylko w programie skompilowanym z flagą @c POLY_STATS
+  (np. <tt>gcc -DPOLY_STATS ...</tt>). Plik ten dołączany jest wtedy na końcu
+  listy nagłówków w plikach biblioteki i zastępuje w nich wywołania
+  @c malloc, @c calloc i @c realloc wersjami zliczającymi. Bez tej flagi
+  nagłówek nie definiuje niczego poza typem PolyAllocStats, więc biblioteka
+  nie ponosi żadnego kosztu. Plik, który definiuje przed dołączeniem
+  nagłówka makro @c POLY_STATS_UNCOUNTED, dostaje same deklaracje,
+  a jego alokacje nie są zliczane.
+
+  Liczniki są osobne dla każdego wątku, więc nie wymagają synchronizacji,
+  a różnica dwóch odczytów w jednym wątku opisuje alokacje wykonane przez
+  ten wątek pomiędzy nimi.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_POLY_STATS_H
+#define POLYNOMIALS_POLY_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * To jest struktura przechowująca liczniki alokacji pamięci.
+ */
+typedef struct {
+    uint64_t mallocs; ///< liczba wywołań malloc i calloc
+    uint64_t reallocs; ///< liczba wywołań realloc
+    uint64_t bytes; ///< suma rozmiarów przydzielonych bloków w bajtach
+} PolyAllocStats;
+
+#ifdef POLY_STATS
+
+/**
+ * Zwraca liczniki alokacji bieżącego wątku.
+ * @return liczniki alokacji
+ */
+PolyAllocStats PolyAllocSnapshot(void);
+
+/**
+ * Przydziela pamięć funkcją malloc i zlicza alokację.
+ * @param[in] size : rozmiar bloku
+ * @return wskaźnik na blok lub NULL
+ */
+void *PolyStatsMalloc(size_t size);
+
+/**
+ * Przydziela wyzerowaną pamięć funkcją calloc i zlicza alokację.
+ * @param[in] count : liczba elementów
+ * @param[in] size : rozmiar elementu
+ * @return wskaźnik na blok lub NULL
+ */
+void *PolyStatsCalloc(size_t count, size_t size);
+
+/**
+ * Zmienia rozmiar bloku funkcją realloc i zlicza realokację.
+ * @param[in] ptr : blok lub NULL
+ * @param[in] size : nowy rozmiar bloku
+ * @return wskaźnik na blok lub NULL
+ */
+void *PolyStatsRealloc(void *ptr, size_t size);
+
+#ifndef POLY_STATS_UNCOUNTED
+
+#define malloc(size) PolyStatsMalloc(size)
+#define calloc(count, size) PolyStatsCalloc(count, size)
+#define realloc(ptr, size) PolyStatsRealloc(ptr, size)
+
+#endif /* POLY_STATS_UNCOUNTED */
+
+#endif /* POLY_STATS */
+
+#endif //POLYNOMIALS_POLY_STATS_H
@@ -0,0 +1,22 @@
+/** @file
+  Implementacja śledzenia wywołań kosztownych funkcji biblioteki wielomianów.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "poly_trace.h"
+#include <time.h>
+
+PolyTraceSink PolyTraceTarget = NULL;
+
+void PolySetTraceSink(PolyTraceSink sink) {
+    PolyTraceTarget = sink;
+}
+
+double PolyTraceClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,69 @@
+/** @file
+  Interfejs śledzenia wywołań kosztownych funkcji biblioteki wielomianów.
+
+  Funkcje PolyMul, PolyMulOwn, PolyCompose (także w PolyComposeOwn) i PolyOwnMonos
+  zgłaszają odbiorcy ustawionemu funkcją PolySetTraceSink każde swoje
+  wywołanie, razem z czasem rozpoczęcia i zakończenia oraz rozmiarami
+  argumentów i wyniku. Rozmiarem wielomianu jest tu liczba jego jednomianów
+  najwyższego poziomu (zero dla współczynnika), którą można odczytać
+  bez przechodzenia wielomianu. Wywołania rekurencyjne zgłaszane są osobno,
+  przed wywołaniem, w którym są zagnieżdżone.
+
+  Bez odbiorcy śledzenie kosztuje jedno porównanie na wywołanie.
+  Odbiorca może być wywoływany jednocześnie z wielu wątków.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_POLY_TRACE_H
+#define POLYNOMIALS_POLY_TRACE_H
+
+#include <stddef.h>
+#include "poly.h"
+
+/**
+ * To jest struktura opisująca jedno zakończone wywołanie funkcji biblioteki.
+ */
+typedef struct {
+    const char *name; ///< nazwa funkcji
+    double start; ///< czas rozpoczęcia w sekundach (zob. PolyTraceClock)
+    double end; ///< czas zakończenia w sekundach
+    const char *firstName; ///< nazwa pierwszego rozmiaru
+    size_t first; ///< pierwszy rozmiar argumentu
+    const char *secondName; ///< nazwa drugiego rozmiaru
+    size_t second; ///< drugi rozmiar argumentu
+    size_t result; ///< rozmiar wyniku
+} PolyTraceSpan;
+
+/**
+ * To jest typ odbiorcy zgłoszeń o wywołaniach.
+ */
+typedef void (*PolyTraceSink)(const PolyTraceSpan *span);
+
+/** Bieżący odbiorca zgłoszeń lub NULL, jeśli śledzenie jest wyłączone. */
+extern PolyTraceSink PolyTraceTarget;
+
+/**
+ * Ustawia odbiorcę zgłoszeń. Powinna być wywołana, gdy żaden inny wątek
+ * nie korzysta z biblioteki.
+ * @param[in] sink : odbiorca lub NULL, aby wyłączyć śledzenie
+ */
+void PolySetTraceSink(PolyTraceSink sink);
+
+/**
+ * Zwraca czas monotoniczny, którym opisywane są wywołania.
+ * @return czas w sekundach
+ */
+double PolyTraceClock(void);
+
+/**
+ * Zwraca rozmiar wielomianu w rozumieniu śledzenia.
+ * @param[in] p : wielomian
+ * @return liczba jednomianów najwyższego poziomu
+ */
+static inline size_t PolyTraceSize(const Poly *p) {
+    return p->arr == NULL ? 0 : p->size;
+}
+
+#endif //POLYNOMIALS_POLY_TRACE_H
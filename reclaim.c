@@ -0,0 +1,65 @@
+/** @file
+  Implementacja odroczonego usuwania dużych wielomianów.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "reclaim.h"
+#include "ring.h"
+#include <pthread.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define BACKLOG_CAPACITY 64
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/** Wielomiany czekające na usunięcie. */
+static Ring backlog;
+/** Wątek sprzątający. */
+static pthread_t reclaimer;
+/** Czy wątek sprzątający działa. */
+static bool reclaiming = false;
+
+/**
+ * Główna funkcja wątku sprzątającego: usuwa wielomiany w kolejności
+ * przekazania, aż bufor zostanie zamknięty i opróżniony.
+ * @param[in] arg : nieużywany
+ * @return NULL
+ */
+static void *reclaimerThread(void *arg) {
+    (void) arg;
+    Poly p;
+    while (ringPop(&backlog, &p)) {
+        PolyDestroy(&p);
+    }
+    return NULL;
+}
+
+bool startReclaimer(void) {
+    initRing(&backlog, sizeof(Poly), BACKLOG_CAPACITY);
+    if (pthread_create(&reclaimer, NULL, reclaimerThread, NULL) != 0) {
+        freeRing(&backlog);
+        return false;
+    }
+    reclaiming = true;
+    return true;
+}
+
+void stopReclaimer(void) {
+    if (!reclaiming) {
+        return;
+    }
+    reclaiming = false;
+    ringClose(&backlog);
+    pthread_join(reclaimer, NULL);
+    freeRing(&backlog);
+}
+
+bool isReclaiming(void) {
+    return reclaiming;
+}
+
+bool reclaimPoly(const Poly *p) {
+    return reclaiming && ringTryPush(&backlog, p);
+}
@@ -0,0 +1,51 @@
+/** @file
+  Interfejs odroczonego usuwania dużych wielomianów.
+
+  Po włączeniu opcją @c -d kalkulator uruchamia wątek sprzątający.
+  Wątek wykonujący polecenia zamiast przechodzić całe drzewo dużego
+  wielomianu przekazuje mu przez bufor cykliczny samą strukturę
+  wielomianu, więc polecenia takie jak @c POP czy @c MUL nie czekają
+  na zwolnienie milionów tablic jednomianów. Bufor ma stałą pojemność:
+  gdy wątek sprzątający nie nadąża, wielomian jest usuwany od razu,
+  więc nieusunięta pamięć nie rośnie bez ograniczeń.
+  Zysk jest tylko na maszynie z więcej niż jednym procesorem; na jednym
+  wątek sprzątający zabiera czas wątkowi wykonującemu polecenia.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_RECLAIM_H
+#define POLYNOMIALS_RECLAIM_H
+
+#include <stdbool.h>
+#include "poly.h"
+
+/**
+ * Uruchamia wątek sprzątający.
+ * @return Czy udało się uruchomić wątek?
+ */
+bool startReclaimer(void);
+
+/**
+ * Czeka, aż wątek sprzątający usunie wszystkie przekazane mu wielomiany,
+ * i kończy go. Nic nie robi, jeśli wątek nie działa.
+ */
+void stopReclaimer(void);
+
+/**
+ * Sprawdza, czy wątek sprzątający działa.
+ * @return Czy wątek sprzątający działa?
+ */
+bool isReclaiming(void);
+
+/**
+ * Przekazuje wielomian do usunięcia wątkowi sprzątającemu.
+ * Wielomian przechodzi na własność wątku sprzątającego tylko wtedy,
+ * gdy funkcja zwróci true.
+ * @param[in] p : wielomian
+ * @return Czy wątek sprzątający przyjął wielomian?
+ */
+bool reclaimPoly(const Poly *p);
+
+#endif //POLYNOMIALS_RECLAIM_H
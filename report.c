@@ -0,0 +1,132 @@
+/** @file
+  Implementacja przekazywania wyników i komunikatów o błędach kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "report.h"
+#include "additional_functions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca wielomian, którego jednomiany są właśnie
+ * wypisywane, razem z numerem bieżącego jednomianu.
+ */
+typedef struct {
+    const Poly *poly; ///< wielomian
+    size_t index; ///< numer wypisywanego jednomianu
+} PrintFrame;
+
+/**
+ * Wypisuje wielomian @f$p@f$ pomnożony przez @f$mult@f$.
+ * Przechodzi drzewo wielomianu iteracyjnie, z jawnym stosem wielomianów,
+ * których jednomiany nie zostały jeszcze wypisane do końca.
+ * @param[in,out] out : bufor wyjścia
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] mult : mnożnik współczynników
+ */
+static void writePoly(Output *out, const Poly *p, poly_coeff_t mult) {
+    size_t length = INITIAL_LENGTH;
+    PrintFrame *frames = malloc(length * sizeof *frames);
+    size_t depth = 0;
+    const Poly *current = p;
+    while (true) {
+        while (current->arr != NULL) {
+            if (depth == length) {
+                length = more(length);
+                frames = realloc(frames, length * sizeof *frames);
+                CheckReallocOutcome(frames);
+            }
+            frames[depth] = (PrintFrame) {.poly = current, .index = 0};
+            ++depth;
+            writeChar(out, '(');
+            current = &current->arr[0].p;
+        }
+        writeLong(out, current->coeff * mult);
+        while (depth > 0) {
+            PrintFrame *frame = &frames[depth - 1];
+            writeChar(out, ',');
+            writeLong(out, frame->poly->arr[frame->index].exp);
+            writeChar(out, ')');
+            ++frame->index;
+            if (frame->index < frame->poly->size) {
+                writeChar(out, '+');
+                writeChar(out, '(');
+                current = &frame->poly->arr[frame->index].p;
+                break;
+            }
+            --depth;
+        }
+        if (depth == 0) {
+            break;
+        }
+    }
+    free(frames);
+}
+
+void writeReport(Output *out, Report *r) {
+    switch (r->kind) {
+        case REPORT_NUMBER:
+            writeLong(out, r->value);
+            endLine(out);
+            break;
+        case REPORT_POLY:
+            writePoly(out, &r->poly, r->mult);
+            endLine(out);
+            PolyDestroy(&r->poly);
+            break;
+        case REPORT_ERROR:
+            fprintf(stderr, "ERROR %d %s\n", r->line, r->message);
+            break;
+        case REPORT_TEXT:
+            writeBytes(out, r->text, strlen(r->text));
+            free(r->text);
+            break;
+    }
+}
+
+void reportNumber(Reporter *rep, long x) {
+    if (rep->ring == NULL) {
+        writeLong(rep->out, x);
+        endLine(rep->out);
+        return;
+    }
+    Report r = {.kind = REPORT_NUMBER, .value = x};
+    ringPush(rep->ring, &r);
+}
+
+void reportPoly(Reporter *rep, const Poly *p, poly_coeff_t mult) {
+    if (rep->ring == NULL) {
+        writePoly(rep->out, p, mult);
+        endLine(rep->out);
+        return;
+    }
+    Report r = {.kind = REPORT_POLY, .poly = PolyClone(p), .mult = mult};
+    ringPush(rep->ring, &r);
+}
+
+void reportError(Reporter *rep, int line, const char *message) {
+    Report r = {.kind = REPORT_ERROR, .line = line, .message = message};
+    if (rep->ring == NULL) {
+        writeReport(rep->out, &r);
+        return;
+    }
+    ringPush(rep->ring, &r);
+}
+
+void reportText(Reporter *rep, char *text) {
+    Report r = {.kind = REPORT_TEXT, .text = text};
+    if (rep->ring == NULL) {
+        writeReport(rep->out, &r);
+        return;
+    }
+    ringPush(rep->ring, &r);
+}
@@ -0,0 +1,88 @@
+/** @file
+  Interfejs przekazywania wyników i komunikatów o błędach kalkulatora.
+  Wyniki są wypisywane od razu albo, w trybie potokowym, przekazywane
+  przez bufor cykliczny do osobnego wątku, który je formatuje.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_REPORT_H
+#define POLYNOMIALS_REPORT_H
+
+#include "output.h"
+#include "poly.h"
+#include "ring.h"
+
+/**
+ * To jest typ wyliczeniowy opisujący rodzaj wyniku.
+ */
+typedef enum {
+    REPORT_NUMBER, ///< liczba wypisywana na standardowe wyjście
+    REPORT_POLY, ///< wielomian wypisywany na standardowe wyjście
+    REPORT_ERROR, ///< komunikat o błędzie wypisywany na standardowe wyjście błędów
+    REPORT_TEXT ///< gotowy tekst wypisywany na standardowe wyjście
+} ReportKind;
+
+/**
+ * To jest struktura reprezentująca jeden wynik przekazywany do wypisania.
+ */
+typedef struct {
+    ReportKind kind; ///< rodzaj wyniku
+    int line; ///< numer linii, której dotyczy komunikat o błędzie
+    long value; ///< wypisywana liczba
+    Poly poly; ///< wypisywany wielomian, własność wyniku
+    poly_coeff_t mult; ///< mnożnik współczynników wypisywanego wielomianu
+    const char *message; ///< treść komunikatu o błędzie
+    char *text; ///< wypisywany tekst, własność wyniku
+} Report;
+
+/**
+ * To jest struktura reprezentująca odbiorcę wyników.
+ * Jeśli @p ring jest równe NULL, wyniki trafiają od razu do @p out,
+ * w przeciwnym przypadku są wstawiane do bufora cyklicznego.
+ */
+typedef struct {
+    Output *out; ///< bufor wyjścia
+    Ring *ring; ///< bufor cykliczny wyników lub NULL
+} Reporter;
+
+/**
+ * Przekazuje liczbę, która ma zostać wypisana w osobnej linii.
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] x : liczba
+ */
+void reportNumber(Reporter *rep, long x);
+
+/**
+ * Przekazuje wielomian @f$p \cdot mult@f$, który ma zostać wypisany
+ * w osobnej linii. W trybie potokowym wysyłana jest kopia wielomianu.
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] p : wielomian
+ * @param[in] mult : mnożnik współczynników
+ */
+void reportPoly(Reporter *rep, const Poly *p, poly_coeff_t mult);
+
+/**
+ * Przekazuje komunikat o błędzie postaci <tt>ERROR w message</tt>.
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] line : numer linii @c w
+ * @param[in] message : treść komunikatu, napis o statycznym czasie życia
+ */
+void reportError(Reporter *rep, int line, const char *message);
+
+/**
+ * Przekazuje tekst, który ma zostać wypisany bez zmian.
+ * @param[in,out] rep : odbiorca wyników
+ * @param[in] text : tekst zaalokowany na stercie, przechodzi na własność
+ * odbiorcy wyników
+ */
+void reportText(Reporter *rep, char *text);
+
+/**
+ * Wypisuje wynik i zwalnia należący do niego wielomian lub tekst.
+ * @param[in,out] out : bufor wyjścia
+ * @param[in,out] r : wynik
+ */
+void writeReport(Output *out, Report *r);
+
+#endif //POLYNOMIALS_REPORT_H
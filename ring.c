@@ -0,0 +1,152 @@
+/** @file
+  Implementacja ograniczonego bufora cyklicznego dla jednego producenta
+  i jednego konsumenta.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ring.h"
+#include "additional_functions.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define SPIN_ROUNDS 16
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+void initRing(Ring *ring, size_t itemSize, size_t capacity) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->closed, false);
+    atomic_init(&ring->sleepers, 0);
+    ring->itemSize = itemSize;
+    ring->capacity = capacity;
+    ring->items = malloc(itemSize * capacity);
+    CheckReallocOutcome(ring->items);
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->changed, NULL);
+}
+
+void freeRing(Ring *ring) {
+    pthread_cond_destroy(&ring->changed);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->items);
+    ring->items = NULL;
+}
+
+/**
+ * Sprawdza, czy w buforze jest miejsce na kolejny element.
+ * @param[in] ring : bufor
+ * @return Czy można wstawić element?
+ */
+static bool canPush(Ring *ring) {
+    return atomic_load(&ring->tail) - atomic_load(&ring->head) < ring->capacity;
+}
+
+/**
+ * Sprawdza, czy konsument może pobrać element lub dowiedzieć się
+ * o końcu danych.
+ * @param[in] ring : bufor
+ * @return Czy konsument nie musi czekać?
+ */
+static bool canPop(Ring *ring) {
+    return (atomic_load(&ring->tail) != atomic_load(&ring->head)) ||
+           atomic_load(&ring->closed);
+}
+
+/**
+ * Usypia wątek, dopóki warunek @p ready nie będzie spełniony.
+ * Najpierw kilka razy oddaje procesor drugiej stronie, bo zwykle
+ * wystarcza to, żeby warunek się spełnił, bez kosztu zasypiania i budzenia.
+ * Wątek zgłasza się jako śpiący przed ponownym sprawdzeniem warunku,
+ * a druga strona po zmianie liczników sprawdza liczbę śpiących,
+ * więc żadne obudzenie nie ginie.
+ * @param[in,out] ring : bufor
+ * @param[in] ready : warunek, na który czeka wątek
+ */
+static void waitRing(Ring *ring, bool (*ready)(Ring *)) {
+    for (int i = 0; i < SPIN_ROUNDS; ++i) {
+        sched_yield();
+        if (ready(ring)) {
+            return;
+        }
+    }
+    pthread_mutex_lock(&ring->lock);
+    atomic_fetch_add(&ring->sleepers, 1);
+    while (!ready(ring)) {
+        pthread_cond_wait(&ring->changed, &ring->lock);
+    }
+    atomic_fetch_sub(&ring->sleepers, 1);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/**
+ * Budzi wątki śpiące na buforze, jeśli jakieś są.
+ * @param[in,out] ring : bufor
+ */
+static void wakeRing(Ring *ring) {
+    if (atomic_load(&ring->sleepers) > 0) {
+        pthread_mutex_lock(&ring->lock);
+        pthread_cond_broadcast(&ring->changed);
+        pthread_mutex_unlock(&ring->lock);
+    }
+}
+
+/**
+ * Wstawia element na koniec bufora, w którym jest na niego miejsce.
+ * @param[in,out] ring : bufor
+ * @param[in] item : element
+ */
+static void pushItem(Ring *ring, const void *item) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    memcpy(ring->items + (tail & (ring->capacity - 1)) * ring->itemSize, item, ring->itemSize);
+    atomic_store(&ring->tail, tail + 1);
+    wakeRing(ring);
+}
+
+void ringPush(Ring *ring, const void *item) {
+    if (!canPush(ring)) {
+        waitRing(ring, canPush);
+    }
+    pushItem(ring, item);
+}
+
+bool ringTryPush(Ring *ring, const void *item) {
+    if (!canPush(ring)) {
+        return false;
+    }
+    pushItem(ring, item);
+    return true;
+}
+
+bool ringTryPop(Ring *ring, void *item) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (atomic_load(&ring->tail) == head) {
+        return false;
+    }
+    memcpy(item, ring->items + (head & (ring->capacity - 1)) * ring->itemSize, ring->itemSize);
+    atomic_store(&ring->head, head + 1);
+    wakeRing(ring);
+    return true;
+}
+
+bool ringPop(Ring *ring, void *item) {
+    while (!ringTryPop(ring, item)) {
+        if (atomic_load(&ring->closed) &&
+            (atomic_load(&ring->tail) == atomic_load(&ring->head))) {
+            return false;
+        }
+        waitRing(ring, canPop);
+    }
+    return true;
+}
+
+void ringClose(Ring *ring) {
+    atomic_store(&ring->closed, true);
+    wakeRing(ring);
+}
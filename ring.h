@@ -0,0 +1,97 @@
+/** @file
+  Interfejs ograniczonego bufora cyklicznego dla jednego producenta
+  i jednego konsumenta.
+  W typowym przypadku wstawienie i pobranie elementu to jedno kopiowanie
+  i jeden zapis atomowy; zamek jest potrzebny tylko wtedy,
+  gdy któraś ze stron musi zasnąć na pełnym lub pustym buforze.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_RING_H
+#define POLYNOMIALS_RING_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define CACHE_LINE 64
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura reprezentująca bufor cykliczny elementów stałego rozmiaru.
+ * Liczniki @p head i @p tail tylko rosną; pozycją w tablicy jest ich reszta
+ * z dzielenia przez pojemność, która jest potęgą dwójki. Liczniki leżą
+ * w osobnych liniach pamięci podręcznej, żeby producent i konsument
+ * nie unieważniali sobie nawzajem pamięci.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_size_t head; ///< liczba pobranych elementów
+    _Alignas(CACHE_LINE) atomic_size_t tail; ///< liczba wstawionych elementów
+    _Alignas(CACHE_LINE) char *items; ///< tablica elementów
+    size_t itemSize; ///< rozmiar elementu w bajtach
+    size_t capacity; ///< pojemność bufora
+    atomic_bool closed; ///< czy producent zakończył wstawianie
+    atomic_int sleepers; ///< liczba wątków śpiących na buforze
+    pthread_mutex_t lock; ///< zamek używany tylko do usypiania wątków
+    pthread_cond_t changed; ///< sygnalizuje zmianę stanu bufora
+} Ring;
+
+/**
+ * Tworzy pusty bufor cykliczny.
+ * @param[out] ring : bufor
+ * @param[in] itemSize : rozmiar elementu w bajtach
+ * @param[in] capacity : pojemność, potęga dwójki
+ */
+void initRing(Ring *ring, size_t itemSize, size_t capacity);
+
+/**
+ * Usuwa z pamięci bufor cykliczny.
+ * @param[in,out] ring : bufor
+ */
+void freeRing(Ring *ring);
+
+/**
+ * Wstawia element na koniec bufora. Jeśli bufor jest pełny, czeka,
+ * aż konsument pobierze element.
+ * @param[in,out] ring : bufor
+ * @param[in] item : element
+ */
+void ringPush(Ring *ring, const void *item);
+
+/**
+ * Wstawia element na koniec bufora, jeśli bufor nie jest pełny.
+ * @param[in,out] ring : bufor
+ * @param[in] item : element
+ * @return Czy wstawiono element?
+ */
+bool ringTryPush(Ring *ring, const void *item);
+
+/**
+ * Pobiera element z początku bufora, jeśli bufor nie jest pusty.
+ * @param[in,out] ring : bufor
+ * @param[out] item : element
+ * @return Czy pobrano element?
+ */
+bool ringTryPop(Ring *ring, void *item);
+
+/**
+ * Pobiera element z początku bufora. Jeśli bufor jest pusty, czeka na
+ * element albo na zamknięcie bufora przez producenta.
+ * @param[in,out] ring : bufor
+ * @param[out] item : element
+ * @return Czy pobrano element? Wartość false oznacza koniec danych.
+ */
+bool ringPop(Ring *ring, void *item);
+
+/**
+ * Oznacza, że producent nie wstawi już żadnego elementu.
+ * @param[in,out] ring : bufor
+ */
+void ringClose(Ring *ring);
+
+#endif //POLYNOMIALS_RING_H
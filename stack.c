@@ -0,0 +1,729 @@
+/** @file
+  Implementacja stosu wielomianów kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stack.h"
+#include "additional_functions.h"
+#include "dataflow.h"
+#include "output.h"
+#include "poly_codec.h"
+#include "poly_freeze.h"
+#include "reclaim.h"
+#include "stats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define INITIAL_LENGTH 8
+#define SNAPSHOT_MAGIC "POLYSTK1"
+#define SNAPSHOT_MAGIC_LENGTH 8
+#define HOT_ENTRIES 2
+#define COMPACT_MIN_ARRAYS 256
+#define COMPACT_PROBE_MONOS 1024
+#define RECLAIM_MIN_MONOS 4096
+#define SPILL_NAME "/poly_spill_XXXXXX"
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+Stack newPolyStack(void) {
+    Stack stack;
+    stack.top = 0;
+    stack.length = INITIAL_LENGTH;
+    stack.array = malloc(stack.length * sizeof *stack.array);
+    stack.budget = 0;
+    stack.resident = 0;
+    stack.firstCold = 0;
+    stack.firstFrozen = 0;
+    stack.spilled = 0;
+    stack.spillFd = -1;
+    stack.spillEnd = 0;
+    stack.buffer = NULL;
+    stack.capacity = 0;
+#ifdef POLY_STATS
+    stack.touched = false;
+#endif
+    return stack;
+}
+
+void limitStackMemory(Stack *stack, size_t bytes) {
+    stack->budget = bytes;
+}
+
+/**
+ * Liczy tablice jednomianów wielomianu i zajmowaną przez nie pamięć.
+ * Przerywa liczenie po obejrzeniu podanej liczby jednomianów,
+ * więc dla dużych wielomianów daje tylko dolne ograniczenie.
+ * @param[in] p : wielomian
+ * @param[in] maxMonos : granica liczby oglądanych jednomianów
+ * @param[out] bytes : rozmiar naliczonych tablic w bajtach
+ * @return liczba naliczonych tablic
+ */
+static size_t measurePoly(const Poly *p, size_t maxMonos, size_t *bytes) {
+    *bytes = 0;
+    if (p->arr == NULL) {
+        return 0;
+    }
+    size_t length = INITIAL_LENGTH;
+    const Poly **pending = malloc(length * sizeof *pending);
+    CheckReallocOutcome(pending);
+    size_t count = 0;
+    size_t arrays = 1;
+    size_t monos = 0;
+    pending[count++] = p;
+    while ((count > 0) && (monos < maxMonos)) {
+        const Poly *q = pending[--count];
+        *bytes += q->size * sizeof(Mono);
+        for (size_t i = 0; (i < q->size) && (monos < maxMonos); ++i, ++monos) {
+            if (q->arr[i].p.arr == NULL) {
+                continue;
+            }
+            if (count == length) {
+                length = more(length);
+                pending = realloc(pending, length * sizeof *pending);
+                CheckReallocOutcome(pending);
+            }
+            pending[count++] = &q->arr[i].p;
+            ++arrays;
+        }
+    }
+    free(pending);
+    return arrays;
+}
+
+/**
+ * Liczy pamięć zajmowaną przez tablice jednomianów wielomianu.
+ * @param[in] p : wielomian
+ * @return rozmiar wielomianu w bajtach
+ */
+static size_t residentBytes(const Poly *p) {
+    size_t bytes;
+    measurePoly(p, SIZE_MAX, &bytes);
+    return bytes;
+}
+
+/**
+ * Usuwa wielomian z pamięci. Jeśli działa wątek sprzątający (zob. reclaim.h),
+ * a wielomian ma co najmniej RECLAIM_MIN_MONOS jednomianów, przekazuje go
+ * do usunięcia w tle; małe wielomiany taniej usunąć od razu.
+ * @param[in] p : wielomian
+ */
+static void destroyPoly(Poly *p) {
+    size_t bytes;
+    if (isReclaiming() && (p->arr != NULL)) {
+        measurePoly(p, RECLAIM_MIN_MONOS, &bytes);
+        if ((bytes / sizeof(Mono) >= RECLAIM_MIN_MONOS) && reclaimPoly(p)) {
+            p->arr = NULL;
+            return;
+        }
+    }
+    PolyDestroy(p);
+}
+
+/**
+ * Daje bufor stosu o rozmiarze co najmniej @f$size@f$ bajtów.
+ * @param[in,out] stack : stos
+ * @param[in] size : rozmiar
+ * @return bufor
+ */
+static uint8_t *reserveBuffer(Stack *stack, size_t size) {
+    if (size > stack->capacity) {
+        free(stack->buffer);
+        stack->capacity = size;
+        stack->buffer = malloc(size);
+        CheckReallocOutcome(stack->buffer);
+    }
+    return stack->buffer;
+}
+
+/**
+ * Tworzy plik tymczasowy na zapisane elementy stosu. Plik jest od razu
+ * usuwany z katalogu, więc znika razem z zamknięciem deskryptora.
+ * @param[in,out] stack : stos
+ * @return Czy udało się utworzyć plik?
+ */
+static bool openSpillFile(Stack *stack) {
+    const char *dir = getenv("TMPDIR");
+    if ((dir == NULL) || (*dir == '\0')) {
+        dir = "/tmp";
+    }
+    size_t length = strlen(dir) + sizeof SPILL_NAME;
+    char *path = malloc(length);
+    CheckReallocOutcome(path);
+    snprintf(path, length, "%s%s", dir, SPILL_NAME);
+    stack->spillFd = mkstemp(path);
+    if (stack->spillFd >= 0) {
+        unlink(path);
+    }
+    free(path);
+    stack->spillEnd = 0;
+    return stack->spillFd >= 0;
+}
+
+/**
+ * Zapisuje do pliku wszystkie podane bajty od podanego miejsca.
+ * @param[in] fd : deskryptor pliku
+ * @param[in] data : bajty
+ * @param[in] size : liczba bajtów
+ * @param[in] offset : miejsce w pliku
+ * @return Czy udało się zapisać wszystkie bajty?
+ */
+static bool writeAt(int fd, const uint8_t *data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= (size_t) n;
+        offset += n;
+    }
+    return true;
+}
+
+/**
+ * Odczytuje z pliku podaną liczbę bajtów od podanego miejsca.
+ * @param[in] fd : deskryptor pliku
+ * @param[out] data : bufor
+ * @param[in] size : liczba bajtów
+ * @param[in] offset : miejsce w pliku
+ * @return Czy udało się odczytać wszystkie bajty?
+ */
+static bool readAt(int fd, uint8_t *data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, data, size, offset);
+        if (n <= 0) {
+            if ((n < 0) && (errno == EINTR)) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= (size_t) n;
+        offset += n;
+    }
+    return true;
+}
+
+/**
+ * Zamraża zimny element (zob. poly_freeze.h) i usuwa z pamięci
+ * jego drzewo jednomianów.
+ * @param[in,out] stack : stos
+ * @param[in,out] e : element stosu
+ */
+static void freezeEntry(Stack *stack, StackEntry *e) {
+    size_t size;
+    e->frozen = PolyFreeze(&e->poly, &size);
+    dropEntry(e);
+    e->poly = PolyZero();
+    stack->resident -= e->bytes;
+    stack->resident += size;
+    e->state = ENTRY_FROZEN;
+    e->bytes = size;
+    size_t index = (size_t) (e - stack->array);
+    if (index < stack->firstFrozen) {
+        stack->firstFrozen = index;
+    }
+}
+
+/**
+ * Zapisuje zamrożony element do pliku tymczasowego i usuwa go z pamięci.
+ * @param[in,out] stack : stos
+ * @param[in,out] e : element stosu
+ * @return Czy udało się zapisać element?
+ */
+static bool spillEntry(Stack *stack, StackEntry *e) {
+    if ((stack->spillFd < 0) && !openSpillFile(stack)) {
+        return false;
+    }
+    if (!writeAt(stack->spillFd, e->frozen, e->bytes, stack->spillEnd)) {
+        return false;
+    }
+    stack->resident -= e->bytes;
+    free(e->frozen);
+    e->frozen = NULL;
+    e->state = ENTRY_SPILLED;
+    e->offset = stack->spillEnd;
+    stack->spillEnd += (off_t) e->bytes;
+    ++stack->spilled;
+    return true;
+}
+
+/**
+ * Zwalnia miejsce zajmowane w pliku tymczasowym przez zapisany element.
+ * Elementy są zapisywane od dna stosu, więc zwykle zwalniany jest
+ * ostatni zapis i plik działa jak stos. Gdy plik staje się pusty,
+ * jest zamykany.
+ * @param[in,out] stack : stos
+ * @param[in] e : zapisany element stosu
+ */
+static void releaseSpill(Stack *stack, const StackEntry *e) {
+    if (e->offset + (off_t) e->bytes == stack->spillEnd) {
+        stack->spillEnd = e->offset;
+    }
+    --stack->spilled;
+    if (stack->spilled == 0) {
+        close(stack->spillFd);
+        stack->spillFd = -1;
+        stack->spillEnd = 0;
+    }
+}
+
+/**
+ * Wczytuje do bufora stosu zamrożony wielomian zapisanego elementu.
+ * Kończy program, jeśli odczyt się nie uda, bo elementu nie da się
+ * wtedy odtworzyć.
+ * @param[in] stack : stos
+ * @param[in] e : zapisany element stosu
+ * @param[out] buffer : bufor na co najmniej @p e->bytes bajtów
+ */
+static void readSpill(const Stack *stack, const StackEntry *e, uint8_t *buffer) {
+    if (!readAt(stack->spillFd, buffer, e->bytes, e->offset)) {
+        exit(1);
+    }
+}
+
+/**
+ * Czeka na wielomian elementu liczony w tle.
+ * @param[in,out] stack : stos
+ * @param[in,out] e : element stosu oczekujący na zadanie
+ */
+static void resolveEntry(Stack *stack, StackEntry *e) {
+    *e = awaitTask(e->task);
+    e->state = ENTRY_HOT;
+    e->bytes = 0;
+    e->frozen = NULL;
+    e->task = NULL;
+#ifdef POLY_STATS
+    e->monos = countMonos(&e->poly);
+    statsStack(stack->top, (long) e->monos);
+#else
+    (void) stack;
+#endif
+}
+
+/**
+ * Przywraca element do pamięci i wyłącza go z limitu, bo funkcja,
+ * która po niego sięga, może go zmienić.
+ * @param[in,out] stack : stos
+ * @param[in,out] e : element stosu
+ */
+static void warmEntry(Stack *stack, StackEntry *e) {
+    if (e->state == ENTRY_PENDING) {
+        resolveEntry(stack, e);
+    } else if (e->state == ENTRY_COLD) {
+        stack->resident -= e->bytes;
+    } else if (e->state == ENTRY_FROZEN) {
+        stack->resident -= e->bytes;
+        e->poly = PolyThaw(e->frozen);
+        free(e->frozen);
+        e->frozen = NULL;
+    } else if (e->state == ENTRY_SPILLED) {
+        uint8_t *buffer = reserveBuffer(stack, e->bytes);
+        readSpill(stack, e, buffer);
+        e->poly = PolyThaw(buffer);
+        releaseSpill(stack, e);
+    }
+    e->state = ENTRY_HOT;
+    e->bytes = 0;
+}
+
+/**
+ * Wlicza do limitu element, który właśnie stał się zimny. Dopóki limit
+ * jest przekroczony, zamraża najgłębsze zimne elementy, a gdy to nie
+ * wystarcza, zapisuje najgłębsze zamrożone elementy do pliku.
+ * Jeśli zapis się nie uda, wyłącza limit i dalej trzyma wszystko w pamięci.
+ * @param[in,out] stack : stos
+ */
+static void coolStack(Stack *stack) {
+    if ((stack->budget == 0) || (stack->top <= HOT_ENTRIES)) {
+        return;
+    }
+    size_t cold = stack->top - HOT_ENTRIES;
+    StackEntry *e = &stack->array[cold - 1];
+    if ((e->state == ENTRY_HOT) && (e->map == NULL)) {
+        e->bytes = residentBytes(&e->poly);
+        e->state = ENTRY_COLD;
+        stack->resident += e->bytes;
+        if (cold - 1 < stack->firstCold) {
+            stack->firstCold = cold - 1;
+        }
+    }
+    while (stack->resident > stack->budget) {
+        if (stack->firstCold < cold) {
+            StackEntry *f = &stack->array[stack->firstCold];
+            if ((f->state == ENTRY_COLD) && (f->bytes > 0)) {
+                freezeEntry(stack, f);
+            }
+            ++stack->firstCold;
+        } else if (stack->firstFrozen < cold) {
+            StackEntry *f = &stack->array[stack->firstFrozen];
+            if ((f->state == ENTRY_FROZEN) && !spillEntry(stack, f)) {
+                stack->budget = 0;
+                return;
+            }
+            ++stack->firstFrozen;
+        } else {
+            return;
+        }
+    }
+}
+
+bool emptyPoly(Stack *stack) {
+    return stack->top == 0;
+}
+
+Poly topPoly(Stack *stack) {
+    return peekEntry(stack, 0)->poly;
+}
+
+StackEntry *topEntry(Stack *stack) {
+#ifdef POLY_STATS
+    stack->touched = true;
+#endif
+    return peekEntry(stack, 0);
+}
+
+StackEntry *peekEntry(Stack *stack, size_t depth) {
+    StackEntry *e = &stack->array[stack->top - 1 - depth];
+    warmEntry(stack, e);
+    return e;
+}
+
+StackEntry popEntry(Stack *stack) {
+    warmEntry(stack, &stack->array[stack->top - 1]);
+    --stack->top;
+#ifdef POLY_STATS
+    statsStack(stack->top, -(long) stack->array[stack->top].monos);
+#endif
+    return stack->array[stack->top];
+}
+
+StackEntry popDeferred(Stack *stack) {
+    if (stack->array[stack->top - 1].state != ENTRY_PENDING) {
+        return popEntry(stack);
+    }
+    --stack->top;
+    return stack->array[stack->top];
+}
+
+void discardTop(Stack *stack) {
+    if (stack->array[stack->top - 1].state == ENTRY_PENDING) {
+        resolveEntry(stack, &stack->array[stack->top - 1]);
+    }
+    --stack->top;
+    StackEntry *e = &stack->array[stack->top];
+#ifdef POLY_STATS
+    statsStack(stack->top, -(long) e->monos);
+#endif
+    if (e->state == ENTRY_COLD) {
+        stack->resident -= e->bytes;
+    } else if (e->state == ENTRY_FROZEN) {
+        stack->resident -= e->bytes;
+        free(e->frozen);
+    } else if (e->state == ENTRY_SPILLED) {
+        releaseSpill(stack, e);
+    }
+    dropEntry(e);
+}
+
+bool isReadOnly(const StackEntry *e) {
+    return (e->map != NULL) || e->compact;
+}
+
+void ownEntry(StackEntry *e) {
+    if (isReadOnly(e)) {
+        Poly p = PolyClone(&e->poly);
+        dropEntry(e);
+        e->poly = p;
+    }
+}
+
+void dropEntry(StackEntry *e) {
+    if (e->map != NULL) {
+        PolyMapRelease(e->map);
+        e->map = NULL;
+    } else if (e->compact) {
+        PolyCompactDestroy(&e->poly);
+        e->compact = false;
+    } else {
+        destroyPoly(&e->poly);
+    }
+}
+
+PolyMemory entryMemoryUsage(const StackEntry *e) {
+    PolyMemory memory = {.bytes = 0, .wasted = 0, .arrays = 0, .monos = 0};
+    if (e->state == ENTRY_FROZEN) {
+        memory.bytes = e->bytes;
+    } else if ((e->state == ENTRY_SPILLED) || (e->state == ENTRY_PENDING)) {
+        return memory;
+    } else if (e->map != NULL) {
+        memory.arrays = measurePoly(&e->poly, SIZE_MAX, &memory.bytes);
+        memory.monos = memory.bytes / sizeof(Mono);
+    } else if (e->compact) {
+        memory = PolyCompactMemoryUsage(&e->poly);
+    } else {
+        memory = PolyMemoryUsage(&e->poly);
+    }
+    return memory;
+}
+
+Poly materialize(StackEntry *e) {
+    ownEntry(e);
+    e->poly = PolyScaleOwn(&e->poly, e->mult);
+    e->mult = 1;
+    return e->poly;
+}
+
+Poly popPoly(Stack *stack) {
+    StackEntry e = popEntry(stack);
+    return materialize(&e);
+}
+
+void freeStack(Stack *stack) {
+    while (!emptyPoly(stack)) {
+        discardTop(stack);
+    }
+    stack->length = 0;
+    free(stack->array);
+    free(stack->buffer);
+}
+
+/**
+ * Zastępuje wielomian elementu zwartą kopią (zob. PolyCompact), jeśli
+ * jest on rozrzucony po wielu tablicach jednomianów. Wywoływana dla
+ * elementu, który właśnie zszedł pod wierzchołek stosu, bo taki element
+ * zwykle leży dłużej, a wyniki zaraz zdejmowane przez następne polecenie
+ * nie opłaca się przenosić. Jeśli element nie jest zwierany, a stos ma
+ * limit pamięci, zmniejsza jego tablice do potrzebnego rozmiaru
+ * (zob. PolyShrinkToFit).
+ * @param[in,out] e : element stosu
+ * @param[in] shrink : czy zmniejszać tablice niezwieranego elementu
+ */
+static void compactEntry(StackEntry *e, bool shrink) {
+    size_t bytes;
+    if ((e->state == ENTRY_FROZEN) || (e->state == ENTRY_SPILLED)
+        || (e->state == ENTRY_PENDING) || isReadOnly(e)) {
+        return;
+    }
+    if (measurePoly(&e->poly, COMPACT_PROBE_MONOS, &bytes) >= COMPACT_MIN_ARRAYS) {
+        Poly p = PolyCompact(&e->poly);
+        destroyPoly(&e->poly);
+        e->poly = p;
+        e->compact = true;
+    } else if (shrink) {
+        PolyShrinkToFit(&e->poly);
+    }
+}
+
+void pushEntry(Stack *stack, StackEntry e) {
+    if (stack->top == stack->length) {
+        stack->length = more(stack->length);
+        stack->array = realloc(stack->array, stack->length * sizeof *stack->array);
+        CheckReallocOutcome(stack->array);
+    }
+    e.state = ENTRY_HOT;
+    e.bytes = 0;
+    e.frozen = NULL;
+#ifdef POLY_STATS
+    e.monos = countMonos(&e.poly);
+    statsStack(stack->top + 1, (long) e.monos);
+#endif
+    stack->array[stack->top] = e;
+    ++stack->top;
+    if (stack->top > HOT_ENTRIES) {
+        compactEntry(&stack->array[stack->top - 1 - HOT_ENTRIES], stack->budget > 0);
+    }
+    coolStack(stack);
+}
+
+void pushPending(Stack *stack, struct Task *task) {
+    if (stack->top == stack->length) {
+        stack->length = more(stack->length);
+        stack->array = realloc(stack->array, stack->length * sizeof *stack->array);
+        CheckReallocOutcome(stack->array);
+    }
+    stack->array[stack->top] = (StackEntry) {.mult = 1, .state = ENTRY_PENDING, .task = task};
+#ifdef POLY_STATS
+    statsStack(stack->top + 1, 0);
+#endif
+    ++stack->top;
+    if (stack->top > HOT_ENTRIES) {
+        compactEntry(&stack->array[stack->top - 1 - HOT_ENTRIES], stack->budget > 0);
+    }
+    coolStack(stack);
+}
+
+void awaitStack(Stack *stack) {
+    for (size_t i = 0; i < stack->top; ++i) {
+        if (stack->array[i].state == ENTRY_PENDING) {
+            resolveEntry(stack, &stack->array[i]);
+        }
+    }
+}
+
+void pushPoly(Stack *stack, Poly poly) {
+    pushEntry(stack, (StackEntry) {.poly = poly, .mult = 1, .map = NULL, .compact = false});
+}
+
+bool saveStack(const Stack *stack, const char *path) {
+    char *temp;
+    int fd = openReplacement(path, &temp);
+    if (fd < 0) {
+        return false;
+    }
+    Output out;
+    initOutput(&out, fd);
+    uint8_t header[MAX_VARINT_BYTES * 2];
+    writeBytes(&out, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH);
+    writeBytes(&out, (const char *) header, VarintEncode(stack->top, header));
+    size_t capacity = 0;
+    uint8_t *buffer = NULL;
+    for (size_t i = 0; i < stack->top; ++i) {
+        const StackEntry *e = &stack->array[i];
+        Poly p = e->poly;
+        if (e->state == ENTRY_FROZEN) {
+            p = PolyThaw(e->frozen);
+        } else if (e->state == ENTRY_SPILLED) {
+            uint8_t *frozen = malloc(e->bytes);
+            CheckReallocOutcome(frozen);
+            readSpill(stack, e, frozen);
+            p = PolyThaw(frozen);
+            free(frozen);
+        }
+        size_t size = PolyEncodedSize(&p);
+        if (size > capacity) {
+            capacity = size;
+            free(buffer);
+            buffer = malloc(capacity);
+            CheckReallocOutcome(buffer);
+        }
+        PolyEncode(&p, buffer);
+        if ((e->state == ENTRY_FROZEN) || (e->state == ENTRY_SPILLED)) {
+            PolyDestroy(&p);
+        }
+        size_t headerSize = VarintEncode(ZigzagEncode(e->mult), header);
+        headerSize += VarintEncode(size, header + headerSize);
+        writeBytes(&out, (const char *) header, headerSize);
+        writeBytes(&out, (const char *) buffer, size);
+    }
+    free(buffer);
+    flushOutput(&out);
+    bool correct = !out.failed;
+    closeOutput(&out);
+    return replaceFile(fd, temp, path, correct);
+}
+
+/**
+ * Odczytuje elementy stosu zapisane w pamięci przez saveStack.
+ * Mnożnik elementu musi być równy 1 albo -1, bo tylko takie zapisuje
+ * saveStack, a inny mógłby wyzerować wielomian.
+ * @param[in] data : zawartość pliku
+ * @param[in] size : rozmiar pliku
+ * @param[out] count : liczba odczytanych elementów
+ * @return tablica odczytanych elementów lub NULL, jeśli dane są niepoprawne
+ */
+static StackEntry *decodeSnapshot(const uint8_t *data, size_t size, size_t *count) {
+    const uint8_t *pos = data;
+    const uint8_t *end = data + size;
+    uint64_t n;
+    if ((size < SNAPSHOT_MAGIC_LENGTH) ||
+        (memcmp(data, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH) != 0)) {
+        return NULL;
+    }
+    pos += SNAPSHOT_MAGIC_LENGTH;
+    if (!VarintDecode(&pos, end, &n) || (n > (uint64_t) (end - pos) / 3)) {
+        return NULL;
+    }
+    StackEntry *entries = malloc(((size_t) n > 0 ? (size_t) n : 1) * sizeof *entries);
+    CheckReallocOutcome(entries);
+    size_t i = 0;
+    bool correct = true;
+    while (correct && (i < n)) {
+        uint64_t mult, length;
+        size_t used = 0;
+        entries[i].poly = PolyZero();
+        correct = VarintDecode(&pos, end, &mult) && VarintDecode(&pos, end, &length) &&
+                  (length <= (uint64_t) (end - pos)) &&
+                  ((mult == ZigzagEncode(1)) || (mult == ZigzagEncode(-1))) &&
+                  PolyDecode(pos, (size_t) length, &entries[i].poly, &used) &&
+                  (used == length);
+        if (correct) {
+            entries[i].mult = (poly_coeff_t) ZigzagDecode(mult);
+            entries[i].map = NULL;
+            entries[i].compact = false;
+            pos += length;
+            ++i;
+        } else {
+            PolyDestroy(&entries[i].poly);
+        }
+    }
+    if (!correct || (pos != end)) {
+        for (size_t j = 0; j < i; ++j) {
+            PolyDestroy(&entries[j].poly);
+        }
+        free(entries);
+        return NULL;
+    }
+    *count = (size_t) n;
+    return entries;
+}
+
+bool loadStack(Stack *stack, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) || (st.st_size <= 0)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t) st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+    size_t count;
+    StackEntry *entries = decodeSnapshot(data, size, &count);
+    munmap(data, size);
+    if (entries == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        pushEntry(stack, entries[i]);
+    }
+    free(entries);
+    return true;
+}
+
+#ifdef POLY_STATS
+
+void settleStackStats(Stack *stack) {
+    if (!stack->touched || (stack->top == 0)
+        || (stack->array[stack->top - 1].state == ENTRY_PENDING)) {
+        return;
+    }
+    stack->touched = false;
+    StackEntry *e = &stack->array[stack->top - 1];
+    size_t monos = countMonos(&e->poly);
+    statsStack(stack->top, (long) monos - (long) e->monos);
+    e->monos = monos;
+}
+
+#endif /* POLY_STATS */
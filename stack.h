@@ -0,0 +1,273 @@
+/** @file
+  Interfejs stosu wielomianów kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_STACK_H
+#define POLYNOMIALS_STACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "poly.h"
+#include "poly_map.h"
+
+/**
+ * To jest typ wyliczeniowy opisujący, gdzie przechowywany jest wielomian
+ * elementu stosu, gdy stos ma ograniczoną pamięć.
+ */
+typedef enum {
+    ENTRY_HOT, ///< wielomian w pamięci, nie jest liczony do limitu
+    ENTRY_COLD, ///< wielomian w pamięci, liczony do limitu
+    ENTRY_FROZEN, ///< wielomian zamrożony w pamięci (zob. poly_freeze.h)
+    ENTRY_SPILLED, ///< zamrożony wielomian zapisany w pliku tymczasowym
+    ENTRY_PENDING ///< wielomian liczony w tle (zob. dataflow.h)
+} EntryState;
+
+struct Task;
+
+/**
+ * To jest struktura reprezentująca element stosu.
+ * Wartością elementu jest wielomian @f$poly@f$ pomnożony przez @f$mult@f$.
+ * Dzięki odroczonemu mnożnikowi negacja wielomianu nie wymaga przejścia po nim,
+ * a mnożnik jest uwzględniany dopiero przy kolejnej operacji na wielomianie.
+ * Mnożnik jest równy 1 albo -1, więc nigdy nie zeruje wielomianu.
+ * Wielomian może należeć do zmapowanego pliku (zob. poly_map.h); wtedy
+ * element trzyma referencję mapowania i wielomianu nie wolno modyfikować.
+ * Duże wielomiany wkładane na stos są zwarte (zob. PolyCompact);
+ * takich też nie wolno przekazywać funkcjom przejmującym wielomian.
+ */
+typedef struct {
+    Poly poly; ///< wielomian
+    poly_coeff_t mult; ///< odroczony mnożnik wielomianu
+    PolyMap *map; ///< mapowanie, do którego należy wielomian, lub NULL
+    bool compact; ///< czy wielomian zajmuje jeden blok pamięci
+    EntryState state; ///< miejsce przechowywania wielomianu
+    size_t bytes; ///< rozmiar wielomianu w pamięci albo rozmiar zamrożonego wielomianu
+    uint8_t *frozen; ///< zamrożony wielomian lub NULL
+    off_t offset; ///< położenie zamrożonego wielomianu w pliku tymczasowym
+    struct Task *task; ///< zadanie liczące wielomian oczekującego elementu
+#ifdef POLY_STATS
+    size_t monos; ///< liczba jednomianów wielomianu, do statystyk (zob. stats.h)
+#endif
+} StackEntry;
+
+/**
+ * To jest struktura reprezentująca stos tablicowy.
+ * Stos może mieć limit pamięci. Elementy leżące głębiej niż kilka
+ * od wierzchołka są wtedy zimne: liczy się ich rozmiar, a gdy suma
+ * przekroczy limit, najgłębsze z nich są zamrażane do zwartej postaci
+ * (zob. poly_freeze.h). Jeśli to nie wystarcza, najgłębsze zamrożone
+ * elementy są zapisywane do pliku tymczasowego i usuwane z pamięci.
+ * Tablice jednomianów elementów, które schodzą pod wierzchołek, są wtedy
+ * też zmniejszane do potrzebnego rozmiaru (zob. PolyShrinkToFit).
+ * Element jest odmrażany, gdy któraś z funkcji stosu po niego sięga.
+ * Tak samo funkcje stosu czekają na wielomian elementu liczonego w tle.
+ */
+typedef struct {
+    StackEntry *array; ///< tablica przechowywująca wartości ze stosu
+    size_t top; ///< indeks pierwszego wolnego miejsca na stosie
+    size_t length; ///< rozmiar stosu
+    size_t budget; ///< limit pamięci zimnych elementów lub 0, jeśli go nie ma
+    size_t resident; ///< rozmiar zimnych elementów w pamięci
+    size_t firstCold; ///< poniżej tego indeksu nie ma niezamrożonych zimnych elementów
+    size_t firstFrozen; ///< poniżej tego indeksu nie ma zamrożonych elementów w pamięci
+    size_t spilled; ///< liczba elementów zapisanych w pliku
+    int spillFd; ///< deskryptor pliku tymczasowego lub -1
+    off_t spillEnd; ///< koniec zapisów w pliku tymczasowym
+    uint8_t *buffer; ///< bufor na zapisy wielomianów
+    size_t capacity; ///< rozmiar bufora
+#ifdef POLY_STATS
+    bool touched; ///< czy wierzchołek mógł się zmienić od ostatniego liczenia jednomianów
+#endif
+} Stack;
+
+/**
+ * Tworzy nowy, pusty stos.
+ * @return pusty stos
+ */
+Stack newPolyStack(void);
+
+/**
+ * Ustawia limit pamięci zajmowanej przez wielomiany leżące głęboko
+ * na stosie @f$stack@f$. Wielomiany przekraczające limit są zamrażane,
+ * a w ostateczności przenoszone do pliku tymczasowego.
+ * @param[in,out] stack : stos
+ * @param[in] bytes : limit w bajtach lub 0, jeśli pamięć ma być nieograniczona
+ */
+void limitStackMemory(Stack *stack, size_t bytes);
+
+/**
+ * Sprawdza, czy stos @f$stack@f$ jest pusty.
+ * @param[in] stack : stos
+ * @return Czy stos jest pusty?
+ */
+bool emptyPoly(Stack *stack);
+
+/**
+ * Daje wielomian z wierzchu stosu @f$stack@f$, nie zdejumując go.
+ * Nie uwzględnia odroczonego mnożnika, więc nadaje się tylko do zapytań,
+ * na które mnożnik nie ma wpływu (np. stopień).
+ * @param[in] stack: stos
+ * @return wielomian z góry stosu
+ */
+Poly topPoly(Stack *stack);
+
+/**
+ * Daje wskaźnik na element z wierzchu stosu @f$stack@f$, nie zdejmując go.
+ * @param[in] stack: stos
+ * @return element z góry stosu
+ */
+StackEntry *topEntry(Stack *stack);
+
+/**
+ * Daje wskaźnik na element leżący @f$depth@f$ miejsc pod wierzchołkiem
+ * stosu @f$stack@f$, nie zdejmując go. Wskaźnik jest ważny do następnego
+ * włożenia elementu na stos.
+ * @param[in] stack: stos
+ * @param[in] depth: głębokość elementu, 0 oznacza wierzchołek
+ * @return element stosu
+ */
+StackEntry *peekEntry(Stack *stack, size_t depth);
+
+/**
+ * Zdejmuje element z wierzchu stosu @f$stack@f$ i zwraca go.
+ * @param[in] stack: stos
+ * @return element z góry stosu
+ */
+StackEntry popEntry(Stack *stack);
+
+/**
+ * Zdejmuje element z wierzchu stosu @f$stack@f$ i zwraca go. W odróżnieniu
+ * od popEntry nie czeka na wielomian elementu liczonego w tle.
+ * @param[in] stack: stos
+ * @return element z góry stosu
+ */
+StackEntry popDeferred(Stack *stack);
+
+/**
+ * Sprawdza, czy wielomian elementu @f$e@f$ jest tylko do odczytu,
+ * czyli zmapowany lub zwarty. Takiego wielomianu nie wolno przekazywać
+ * funkcjom przejmującym wielomian na własność.
+ * @param[in] e : element stosu
+ * @return Czy wielomian jest tylko do odczytu?
+ */
+bool isReadOnly(const StackEntry *e);
+
+/**
+ * Zastępuje zmapowany lub zwarty wielomian elementu @f$e@f$ jego kopią,
+ * którą element posiada na własność.
+ * @param[in,out] e : element stosu
+ */
+void ownEntry(StackEntry *e);
+
+/**
+ * Usuwa wielomian elementu @f$e@f$ albo zwalnia jego mapowanie.
+ * @param[in,out] e : element stosu
+ */
+void dropEntry(StackEntry *e);
+
+/**
+ * Liczy pamięć zajmowaną przez wielomian elementu @f$e@f$ (zob. PolyMemoryUsage).
+ * Zamrożony element zajmuje jeden blok bez tablic jednomianów, zapisany
+ * w pliku tymczasowym nie zajmuje pamięci, a pamięć zmapowanego należy
+ * do mapowania i nie ma zapasu.
+ * @param[in] e : element stosu
+ * @return pamięć elementu
+ */
+PolyMemory entryMemoryUsage(const StackEntry *e);
+
+/**
+ * Usuwa element z wierzchu stosu @f$stack@f$. Element zapisany w pliku
+ * tymczasowym nie jest przed usunięciem wczytywany.
+ * @param[in,out] stack: stos
+ */
+void discardTop(Stack *stack);
+
+/**
+ * Uwzględnia w wielomianie odroczony mnożnik elementu @f$e@f$.
+ * Wynikowy wielomian należy do elementu, nawet jeśli wcześniej był zmapowany.
+ * @param[in,out] e : element stosu
+ * @return wielomian elementu, już bez odroczonego mnożnika
+ */
+Poly materialize(StackEntry *e);
+
+/**
+ * Zdejmuje wielomian z wierzchu stosu @f$stack@f$ i zwraca go.
+ * @param[in] stack: stos
+ * @return wielomian z góry stosu
+ */
+Poly popPoly(Stack *stack);
+
+/**
+ * Usuwa stos @f$stack@f$ z pamięci.
+ * @param[in] stack : stos
+ */
+void freeStack(Stack *stack);
+
+/**
+ * Wkłada element @f$e@f$ na stos @f$stack@f$.
+ * @param[in,out] stack : stos
+ * @param[in] e : element stosu
+ */
+void pushEntry(Stack *stack, StackEntry e);
+
+/**
+ * Wkłada na stos @f$stack@f$ element oczekujący na wynik zadania
+ * @f$task@f$ (zob. dataflow.h).
+ * @param[in,out] stack : stos
+ * @param[in] task : zadanie
+ */
+void pushPending(Stack *stack, struct Task *task);
+
+/**
+ * Czeka na wielomiany wszystkich elementów stosu @f$stack@f$
+ * liczonych w tle.
+ * @param[in,out] stack : stos
+ */
+void awaitStack(Stack *stack);
+
+/**
+ * Wkłada wielomain @f$poly@f$ na stos @f$stack@f$.
+ * @param[in,out] stack : stos
+ * @param[in] poly : wielomian @f$q@f$
+ */
+void pushPoly(Stack *stack, Poly poly);
+
+/**
+ * Zapisuje wszystkie elementy stosu, od dna do wierzchołka, do pliku
+ * w postaci binarnej (zob. poly_codec.h). Plik zaczyna się napisem
+ * @c POLYSTK1 i liczbą elementów, a każdy element to mnożnik, rozmiar
+ * zapisu wielomianu i sam zapis. Stos nie może mieć elementów liczonych
+ * w tle (zob. awaitStack). Plik jest zastępowany w całości, jak
+ * w PolyMapExport, więc zmapowany plik docelowy pozostaje nietknięty.
+ * @param[in] stack : stos
+ * @param[in] path : ścieżka pliku
+ * @return Czy udało się zapisać plik?
+ */
+bool saveStack(const Stack *stack, const char *path);
+
+/**
+ * Wkłada na stos elementy zapisane w pliku przez saveStack,
+ * w kolejności, w jakiej zostały zapisane. Jeśli plik jest niepoprawny,
+ * nie zmienia stosu.
+ * @param[in,out] stack : stos
+ * @param[in] path : ścieżka pliku
+ * @return Czy udało się wczytać plik?
+ */
+bool loadStack(Stack *stack, const char *path);
+
+#ifdef POLY_STATS
+
+/**
+ * Liczy na nowo jednomiany wielomianu na wierzchołku stosu, jeśli od
+ * ostatniego liczenia mógł on zostać zmieniony przez wskaźnik z topEntry.
+ * @param[in,out] stack : stos
+ */
+void settleStackStats(Stack *stack);
+
+#endif /* POLY_STATS */
+
+#endif //POLYNOMIALS_STACK_H
@@ -0,0 +1,181 @@
+/** @file
+  Implementacja statystyk działania kalkulatora.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define POLY_STATS_UNCOUNTED
+
+#include "stats.h"
+#include "additional_functions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "poly_stats.h"
+
+#ifdef POLY_STATS
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define MAX_NAME 16
+#define MAX_KINDS 64
+#define INITIAL_LENGTH 8
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * To jest struktura przechowująca statystyki jednego rodzaju linii.
+ */
+typedef struct {
+    char name[MAX_NAME]; ///< nazwa polecenia lub rodzaju linii
+    unsigned long calls; ///< liczba wykonań
+    double seconds; ///< łączny czas wykonania
+    double maxSeconds; ///< najdłuższy czas wykonania
+    PolyAllocStats alloc; ///< alokacje wykonane przez bibliotekę
+} LineStats;
+
+/** Statystyki rodzajów linii w kolejności pierwszego wystąpienia. */
+static LineStats kinds[MAX_KINDS];
+/** Liczba rodzajów linii. */
+static size_t kindsCount;
+/** Rodzaj bieżącej linii. */
+static LineKind currentKind;
+/** Kursor na początku bieżącej linii. */
+static Cursor currentLine;
+/** Czas rozpoczęcia bieżącej linii. */
+static double currentStart;
+/** Liczniki alokacji na początku bieżącej linii. */
+static PolyAllocStats currentAlloc;
+/** Największa liczba wielomianów na stosie. */
+static size_t maxDepth;
+/** Łączna liczba jednomianów wielomianów na stosie. */
+static size_t stackMonos;
+/** Największa łączna liczba jednomianów wielomianów na stosie. */
+static size_t maxStackMonos;
+
+/**
+ * Zwraca bieżący czas monotoniczny w sekundach.
+ * @return czas w sekundach
+ */
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Znajduje statystyki rodzaju linii o podanej nazwie, w razie potrzeby
+ * je tworząc. Nazwa dłuższa niż MAX_NAME - 1 znaków jest obcinana.
+ * @param[in] name : nazwa
+ * @param[in] length : długość nazwy
+ * @return statystyki lub NULL, jeśli zabrakło miejsca na nowy rodzaj
+ */
+static LineStats *findKind(const char *name, size_t length) {
+    if (length >= MAX_NAME) {
+        length = MAX_NAME - 1;
+    }
+    for (size_t i = 0; i < kindsCount; ++i) {
+        if ((strncmp(kinds[i].name, name, length) == 0) && (kinds[i].name[length] == '\0')) {
+            return &kinds[i];
+        }
+    }
+    if (kindsCount == MAX_KINDS) {
+        return NULL;
+    }
+    LineStats *k = &kinds[kindsCount++];
+    memcpy(k->name, name, length);
+    k->name[length] = '\0';
+    return k;
+}
+
+void statsBeginLine(LineKind kind, const Cursor *line) {
+    currentKind = kind;
+    currentLine = *line;
+    currentAlloc = PolyAllocSnapshot();
+    currentStart = now();
+}
+
+void statsEndLine(Stack *stack, bool correct) {
+    double elapsed = now() - currentStart;
+    PolyAllocStats alloc = PolyAllocSnapshot();
+    settleStackStats(stack);
+
+    if (currentKind == LINE_EMPTY) {
+        return;
+    }
+    char name[MAX_NAME];
+    lineName(currentKind, &currentLine, correct, name, sizeof name);
+    LineStats *k = findKind(name, strlen(name));
+    if (k == NULL) {
+        return;
+    }
+    ++k->calls;
+    k->seconds += elapsed;
+    if (elapsed > k->maxSeconds) {
+        k->maxSeconds = elapsed;
+    }
+    k->alloc.mallocs += alloc.mallocs - currentAlloc.mallocs;
+    k->alloc.reallocs += alloc.reallocs - currentAlloc.reallocs;
+    k->alloc.bytes += alloc.bytes - currentAlloc.bytes;
+}
+
+void statsStack(size_t depth, long monos) {
+    if (depth > maxDepth) {
+        maxDepth = depth;
+    }
+    stackMonos += (size_t) monos;
+    if (stackMonos > maxStackMonos) {
+        maxStackMonos = stackMonos;
+    }
+}
+
+size_t countMonos(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return 0;
+    }
+    size_t length = INITIAL_LENGTH;
+    const Poly **pending = malloc(length * sizeof *pending);
+    CheckReallocOutcome(pending);
+    size_t count = 0;
+    size_t top = 0;
+    pending[top++] = p;
+    while (top > 0) {
+        const Poly *q = pending[--top];
+        count += q->size;
+        for (size_t i = 0; i < q->size; ++i) {
+            if (!PolyIsCoeff(&q->arr[i].p)) {
+                if (top == length) {
+                    length = more(length);
+                    pending = realloc(pending, length * sizeof *pending);
+                    CheckReallocOutcome(pending);
+                }
+                pending[top++] = &q->arr[i].p;
+            }
+        }
+    }
+    free(pending);
+    return count;
+}
+
+char *formatStats(void) {
+    char *text;
+    size_t size;
+    FILE *out = open_memstream(&text, &size);
+    CheckReallocOutcome(out);
+    fprintf(out, "%-15s %10s %12s %12s %10s %10s %14s\n", "LINE", "CALLS", "TOTAL_MS",
+            "MAX_US", "MALLOCS", "REALLOCS", "BYTES");
+    for (size_t i = 0; i < kindsCount; ++i) {
+        const LineStats *k = &kinds[i];
+        fprintf(out, "%-15s %10lu %12.3f %12.3f %10llu %10llu %14llu\n", k->name, k->calls,
+                k->seconds * 1e3, k->maxSeconds * 1e6, (unsigned long long) k->alloc.mallocs,
+                (unsigned long long) k->alloc.reallocs, (unsigned long long) k->alloc.bytes);
+    }
+    fprintf(out, "MAX STACK DEPTH %zu\n", maxDepth);
+    fprintf(out, "MAX STACK MONOS %zu\n", maxStackMonos);
+    fclose(out);
+    return text;
+}
+
+#endif /* POLY_STATS */
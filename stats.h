@@ -0,0 +1,81 @@
+/** @file
+  Interfejs statystyk działania kalkulatora.
+
+  Statystyki zbierane są tylko w programie skompilowanym z flagą
+  @c POLY_STATS, razem z plikami stats.c i poly_stats.c. Dla każdego
+  rodzaju linii (polecenia, wstawienia wielomianu lub błędnej linii)
+  zliczane są wykonania, łączny i najdłuższy czas wykonania oraz alokacje
+  pamięci wykonane przez bibliotekę (zob. poly_stats.h). Zapamiętywana jest
+  też największa głębokość stosu i największa łączna liczba jednomianów
+  wielomianów leżących na stosie. Mierzone jest samo wykonanie linii:
+  wczytanie wielomianu, które w trybach @c -j i @c -p odbywa się w innych
+  wątkach, nie jest wliczane.
+
+  Statystyki wypisuje polecenie STATS, a opcja @c -s wypisuje je
+  na standardowe wyjście błędów po zakończeniu programu. Bez flagi
+  @c POLY_STATS makra z tego pliku rozwijają się do niczego, a polecenie
+  STATS i opcja @c -s nie istnieją.
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_STATS_H
+#define POLYNOMIALS_STATS_H
+
+#ifdef POLY_STATS
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "input.h"
+#include "parser.h"
+#include "stack.h"
+
+/**
+ * Rozpoczyna pomiar wykonania linii.
+ * @param[in] kind : rodzaj linii
+ * @param[in] line : kursor na początku linii
+ */
+void statsBeginLine(LineKind kind, const Cursor *line);
+
+/**
+ * Kończy pomiar wykonania linii rozpoczęty funkcją statsBeginLine
+ * i uaktualnia liczbę jednomianów wielomianu na wierzchołku stosu,
+ * jeśli polecenie mogło go zmienić.
+ * @param[in,out] stack : stos
+ * @param[in] correct : czy linia była poprawna
+ */
+void statsEndLine(Stack *stack, bool correct);
+
+/**
+ * Odnotowuje zmianę zawartości stosu.
+ * @param[in] depth : liczba wielomianów na stosie po zmianie
+ * @param[in] monos : zmiana łącznej liczby jednomianów wielomianów na stosie
+ */
+void statsStack(size_t depth, long monos);
+
+/**
+ * Liczy jednomiany wielomianu na wszystkich poziomach zagnieżdżenia.
+ * @param[in] p : wielomian
+ * @return liczba jednomianów
+ */
+size_t countMonos(const Poly *p);
+
+/**
+ * Tworzy tekstowe zestawienie statystyk, po jednej linii na rodzaj linii
+ * wejścia, zakończone podsumowaniem stosu.
+ * @return zestawienie, do zwolnienia funkcją free
+ */
+char *formatStats(void);
+
+#define STATS_BEGIN_LINE(kind, line) statsBeginLine(kind, line)
+#define STATS_END_LINE(stack, correct) statsEndLine(stack, correct)
+
+#else
+
+#define STATS_BEGIN_LINE(kind, line) ((void) 0)
+#define STATS_END_LINE(stack, correct) ((void) 0)
+
+#endif /* POLY_STATS */
+
+#endif //POLYNOMIALS_STATS_H
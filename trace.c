@@ -0,0 +1,108 @@
+/** @file
+  Implementacja śledzenia wykonania kalkulatora w formacie Chrome trace.
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#include "trace.h"
+#include "poly_trace.h"
+#include <stdatomic.h>
+#include <stdio.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define TRACE_MIN_SPAN_US 2.0
+#define MAX_NAME 16
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/** Plik śladu lub NULL, jeśli śledzenie jest wyłączone. */
+static FILE *traceFile = NULL;
+/** Czas rozpoczęcia śledzenia. */
+static double traceOrigin;
+/** Numer, który dostanie następny wątek zapisujący zdarzenie. */
+static atomic_uint nextThreadId = 1;
+/** Numer bieżącego wątku w śladzie lub zero, jeśli jeszcze go nie ma. */
+static _Thread_local unsigned threadId = 0;
+
+/**
+ * Zwraca numer bieżącego wątku w śladzie, nadając go przy pierwszym użyciu.
+ * @return numer wątku
+ */
+static unsigned currentThread(void) {
+    if (threadId == 0) {
+        threadId = atomic_fetch_add(&nextThreadId, 1);
+    }
+    return threadId;
+}
+
+/**
+ * Zapisuje zgłoszone przez bibliotekę wywołanie, jeśli trwało
+ * co najmniej TRACE_MIN_SPAN_US mikrosekund.
+ * @param[in] span : wywołanie
+ */
+static void traceSpan(const PolyTraceSpan *span) {
+    double duration = (span->end - span->start) * 1e6;
+    if (duration < TRACE_MIN_SPAN_US) {
+        return;
+    }
+    if (span->secondName == NULL) {
+        fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"poly\",\"ph\":\"X\",\"ts\":%.3f,"
+                           "\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"%s\":%zu,\"result\":%zu}},\n",
+                span->name, (span->start - traceOrigin) * 1e6, duration, currentThread(),
+                span->firstName, span->first, span->result);
+    } else {
+        fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"poly\",\"ph\":\"X\",\"ts\":%.3f,"
+                           "\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"%s\":%zu,\"%s\":%zu,\"result\":%zu}},\n",
+                span->name, (span->start - traceOrigin) * 1e6, duration, currentThread(),
+                span->firstName, span->first, span->secondName, span->second, span->result);
+    }
+}
+
+bool openTrace(const char *path) {
+    traceFile = fopen(path, "w");
+    if (traceFile == NULL) {
+        return false;
+    }
+    traceOrigin = PolyTraceClock();
+    fputs("[\n", traceFile);
+    currentThread();
+    PolySetTraceSink(traceSpan);
+    return true;
+}
+
+void closeTrace(void) {
+    if (traceFile == NULL) {
+        return;
+    }
+    PolySetTraceSink(NULL);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"calc\"}}\n]\n",
+          traceFile);
+    fclose(traceFile);
+    traceFile = NULL;
+}
+
+bool isTracing(void) {
+    return traceFile != NULL;
+}
+
+void traceLine(int line, LineKind kind, const Cursor *text, bool correct, double start,
+               const Stack *stack) {
+    double end = PolyTraceClock();
+    char name[MAX_NAME];
+    lineName(kind, text, correct, name, sizeof name);
+    char top[MAX_NAME + 16] = "";
+    if (stack->top > 0) {
+        const StackEntry *e = &stack->array[stack->top - 1];
+        if ((e->state == ENTRY_HOT) || (e->state == ENTRY_COLD)) {
+            snprintf(top, sizeof top, ",\"top\":%zu", PolyTraceSize(&e->poly));
+        }
+    }
+    fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"line\",\"ph\":\"X\",\"ts\":%.3f,"
+                       "\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                       "\"args\":{\"line\":%d,\"depth\":%zu%s}},\n",
+            name, (start - traceOrigin) * 1e6, (end - start) * 1e6, currentThread(), line,
+            stack->top, top);
+}
@@ -0,0 +1,58 @@
+/** @file
+  Interfejs śledzenia wykonania kalkulatora w formacie Chrome trace.
+
+  Po włączeniu śledzenia opcją @c -t każda wykonana linia wejścia zapisywana
+  jest jako zdarzenie z czasem rozpoczęcia i trwania, nazwą polecenia
+  (POLY dla wielomianu), numerem linii, głębokością stosu po wykonaniu
+  i rozmiarem wielomianu na wierzchołku. Wewnątrz linii zapisywane są
+  wywołania kosztownych funkcji biblioteki (zob. poly_trace.h) trwające
+  co najmniej TRACE_MIN_SPAN_US mikrosekund, z rozmiarami argumentów
+  i wyniku. Wywołania z wątków wczytujących wielomiany trafiają na osobne
+  ścieżki.
+
+  Plik jest tablicą zdarzeń JSON, którą można otworzyć w przeglądarce
+  śladów (chrome://tracing, Perfetto).
+
+  @author Wiktoria Walczak
+  @date 2021
+*/
+
+#ifndef POLYNOMIALS_TRACE_H
+#define POLYNOMIALS_TRACE_H
+
+#include <stdbool.h>
+#include "input.h"
+#include "parser.h"
+#include "stack.h"
+
+/**
+ * Rozpoczyna śledzenie do pliku.
+ * @param[in] path : ścieżka do pliku
+ * @return Czy udało się utworzyć plik?
+ */
+bool openTrace(const char *path);
+
+/**
+ * Kończy śledzenie i zamyka plik. Nic nie robi, jeśli śledzenie jest wyłączone.
+ */
+void closeTrace(void);
+
+/**
+ * Sprawdza, czy śledzenie jest włączone.
+ * @return Czy śledzenie jest włączone?
+ */
+bool isTracing(void);
+
+/**
+ * Zapisuje zdarzenie wykonania linii wejścia.
+ * @param[in] line : numer linii
+ * @param[in] kind : rodzaj linii
+ * @param[in] text : kursor na początku linii
+ * @param[in] correct : czy linia była poprawna
+ * @param[in] start : czas rozpoczęcia wykonania (zob. PolyTraceClock)
+ * @param[in] stack : stos po wykonaniu linii
+ */
+void traceLine(int line, LineKind kind, const Cursor *text, bool correct, double start,
+               const Stack *stack);
+
+#endif //POLYNOMIALS_TRACE_H